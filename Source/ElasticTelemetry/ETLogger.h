@@ -5,6 +5,8 @@
 
 #include "CoreMinimal.h"
 #include "ElasticTelemetry.h"
+#include "ElasticTelemetryLogEntry.h"
+#include "ElasticTelemetryLogLevelScope.h"
 #include "Herald/LogLevels.hpp"
 #include "Herald/Logger.hpp"
 #include "StringConversions.h"
@@ -79,37 +81,26 @@ namespace Herald
 	/// log messages that need to be transformed into JSON, this function can be used.
 	/// The variadic arguments are passed to the JsonTransformer to be included in the
 	/// transformed message and must be in Key, Value pairs for everything after the message.
+	/// Numbers and bools are sent as JSON numbers and booleans, see FElasticTelemetryLogEntry.
 	/// </summary>
 	/// <typeparam name="...Args">Key, Value types</typeparam>
 	/// <param name="LogLevel"></param>
 	/// <param name="Message"></param>
 	/// <param name="...args">Key, Value pairs</param>
 	template <typename... Args>
-	void log(const LogLevels LogLevel, const FString & Message, Args... args)
+	void log(const LogLevels LogLevel, const FString & Message, const Args &... args)
 	{
 		if (!isLogLevelEnabled(LogLevel))
 			return;
 
-		auto JsonTransformer = GetJsonTransformer();
-
-		if (!JsonTransformer)
-			return;
+		FElasticTelemetryModule & ElasticTelemetryModule =
+		    FModuleManager::GetModuleChecked<FElasticTelemetryModule>("ElasticTelemetry");
 
-		Herald::log(*JsonTransformer, LogLevel, std::string(TCHAR_TO_UTF8(*Message)), args...);
+		const FElasticTelemetryLogLevelScope LevelScope(LogLevel);
+		ElasticTelemetryModule.Log(FElasticTelemetryLogEntry(LogLevel, Message, args...));
 	}
 
-	inline void log(LogLevels Level, const FString & Message)
-	{
-		if (!isLogLevelEnabled(Level))
-			return;
-
-		auto JsonTransformer = GetJsonTransformer();
-
-		if (!JsonTransformer)
-			return;
-
-		Herald::log(*JsonTransformer, Level, std::string(TCHAR_TO_UTF8(*Message)));
-	}
+	inline void log(LogLevels Level, const FString & Message) { log<>(Level, Message); }
 
 	/// <summary>
 	/// Primarily an internal function to facilitate helper functions, though it can be used directly to configure the
@@ -125,23 +116,17 @@ namespace Herald
 	}
 
 	template <typename... Args>
-	void event(const FString & EventName, Args... args)
+	void event(const FString & EventName, const Args &... args)
 	{
-		auto EventTransformer = GetEventTransformer();
-		if (!EventTransformer)
-			return;
+		FElasticTelemetryModule & ElasticTelemetryModule =
+		    FModuleManager::GetModuleChecked<FElasticTelemetryModule>("ElasticTelemetry");
 
-		Herald::event(*EventTransformer, std::string(TCHAR_TO_UTF8(*EventName)), args...);
+		const FElasticTelemetryLogLevelScope LevelScope(LogLevels::Event);
+		ElasticTelemetryModule.Log(FElasticTelemetryLogEntry(LogLevels::Event, EventName, args...));
 	}
 
-	inline void event(const FString & EventName)
-	{
-		auto EventTransformer = GetEventTransformer();
-		if (!EventTransformer)
-			return;
+	inline void event(const FString & EventName) { event<>(EventName); }
 
-		Herald::event(*EventTransformer, std::string(TCHAR_TO_UTF8(*EventName)));
-	}
 	// TODO: move this to another header
 	// template <typename... Args>
 	// void event(const FString & Type, Args... args)
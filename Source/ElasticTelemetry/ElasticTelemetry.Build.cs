@@ -56,6 +56,9 @@ public class ElasticTelemetry : ModuleRules
 			);
 
 
+		// gzip request bodies, see ElasticTelemetryCompression.cpp
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
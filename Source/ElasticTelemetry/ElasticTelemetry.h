@@ -7,12 +7,16 @@
 #include "Modules/ModuleManager.h"
 #include "ElasticTelemetryEnvironmentSettings.h"
 #include "ElasticTelemetryQuerySettings.h"
+#include "ElasticTelemetryWriterStats.h"
 #include "Herald/LogLevels.hpp"
 #include "Herald/ILogTransformer.hpp"
 
 DECLARE_LOG_CATEGORY_EXTERN(TelemetryLog, Log, All);
 
+class FElasticTelemetryCrashHandler;
+class FElasticTelemetryLogEntry;
 class FElasticTelemetryOutputDevice;
+class FElasticTelemetryStatCounters;
 
 /// <summary>
 /// The ElasticTelemetry module is responsible for sending logs to an ElasticSearch server.
@@ -47,8 +51,24 @@ class ELASTICTELEMETRY_API FElasticTelemetryModule : public IModuleInterface
 
 	Herald::ILogTransformerPtr GetEventTransformer() const { return EventTransformer; }
 
+	/// <summary>
+	/// Sends a typed entry through the JSON transformer, or the event transformer for LogLevels::Event, without
+	/// building a Herald::LogEntry. The Herald::log() and Herald::event() helpers in ETLogger.h come through here.
+	/// </summary>
+	void Log(const FElasticTelemetryLogEntry & Entry) const;
+
 	void UpdateConfig();
 
+	/// <summary>
+	/// Queue depth and drop counters for the writer shipping UE_LOG output. Safe to call from any thread.
+	/// </summary>
+	FElasticTelemetryWriterStats GetLogWriterStats() const;
+
+	/// <summary>
+	/// Queue depth and drop counters for the writer shipping Herald::event() output. Safe to call from any thread.
+	/// </summary>
+	FElasticTelemetryWriterStats GetEventWriterStats() const;
+
   protected:
 	// Since settings may be used by different threads, and because
 	// in the editor, it would be nice to have them updated in real-time,
@@ -67,4 +87,11 @@ class ELASTICTELEMETRY_API FElasticTelemetryModule : public IModuleInterface
 	// Writer and transformer for events
 	Herald::ILogWriterPtr      EventWriter;
 	Herald::ILogTransformerPtr EventTransformer;
+
+	// Spools what both writers hold when the engine reports a crash. Created in StartupModule once the headers are
+	// known, released first in ShutdownModule.
+	TUniquePtr<FElasticTelemetryCrashHandler> CrashHandler;
+
+	// "stat ElasticTelemetry", while PublishStatCounters is set
+	TUniquePtr<FElasticTelemetryStatCounters> StatCounters;
 };
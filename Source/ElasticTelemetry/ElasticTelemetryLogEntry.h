@@ -0,0 +1,210 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Herald/LogLevels.hpp"
+#include "StringConversions.h"
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// <summary>
+/// A log line with typed metadata, what the Herald::log() and Herald::event() helpers in ETLogger.h and the output
+/// device hand the JSON transformer instead of a Herald::LogEntry. Integers, floating point numbers and bools are kept
+/// as they are and written as JSON numbers and booleans. Narrow strings (literals, std::string, std::string_view) are
+/// borrowed, wide ones (FString, TCHAR*, FName) are converted into the entry's own buffer. Anything else goes through
+/// std::to_string(), like Herald does.
+///
+/// Up to InlineFields fields and InlineText bytes of converted text live inside the entry, only more than that
+/// allocates. Borrowed strings must outlive the entry, which is meant to live on the stack for one log call.
+/// </summary>
+class FElasticTelemetryLogEntry
+{
+  public:
+	static constexpr int32 InlineFields = 8;
+	static constexpr int32 InlineText   = 512;
+
+	enum class EType : uint8
+	{
+		Int64,
+		Double,
+		Bool,
+		String
+	};
+
+	/// <summary>
+	/// Borrowed text when Data is set, otherwise Length bytes at Offset in the entry's buffer.
+	/// </summary>
+	struct FTextSpan
+	{
+		const ANSICHAR * Data;
+		int32            Offset;
+		int32            Length;
+	};
+
+	struct FField
+	{
+		FTextSpan Key;
+		EType     Type;
+		union
+		{
+			int64     Int;
+			double    Real;
+			bool      Bool;
+			FTextSpan String;
+		};
+	};
+
+	using FFieldArray = TArray<FField, TInlineAllocator<InlineFields>>;
+
+	/// <summary>
+	/// Message, then Key, Value pairs, the same arguments Herald::LogEntry takes.
+	/// </summary>
+	template <typename MessageType, typename... Args>
+	FElasticTelemetryLogEntry(const Herald::LogLevels InLevel, const MessageType & InMessage, const Args &... args)
+	    : Level(InLevel)
+	    , Fields()
+	    , Text()
+	    , Message(MakeText(InMessage))
+	{
+		Add(args...);
+	}
+
+	FElasticTelemetryLogEntry(const FElasticTelemetryLogEntry &)             = delete;
+	FElasticTelemetryLogEntry & operator=(const FElasticTelemetryLogEntry &) = delete;
+
+	/// <summary>
+	/// Adds Key, Value pairs. A key that is already there takes the new value, as in Herald's map.
+	/// </summary>
+	template <typename KeyType, typename ValueType, typename... Args>
+	void Add(const KeyType & Key, const ValueType & Value, const Args &... args)
+	{
+		static_assert(sizeof...(Args) % 2 == 0, "Metadata must be Key, Value pairs");
+		AddField(MakeText(Key), Value);
+		Add(args...);
+	}
+
+	void Add() {}
+
+	Herald::LogLevels   GetLevel() const { return Level; }
+	std::string_view    GetMessage() const { return GetText(Message); }
+	const FFieldArray & GetFields() const { return Fields; }
+	std::string_view    GetText(const FTextSpan & Span) const
+	{
+		return std::string_view(Span.Data ? Span.Data : Text.GetData() + Span.Offset, Span.Length);
+	}
+
+	/// <summary>
+	/// Bytes allocated outside the entry, 0 while fields and converted text fit inline.
+	/// </summary>
+	SIZE_T GetAllocatedSize() const
+	{
+		return (Fields.Max() > InlineFields ? Fields.GetAllocatedSize() : 0) +
+		       (Text.Max() > InlineText ? Text.GetAllocatedSize() : 0);
+	}
+
+  private:
+	template <typename T> FTextSpan MakeText(const T & Value)
+	{
+		if constexpr (std::is_convertible_v<const T &, std::string_view>)
+		{
+			const std::string_view View(Value);
+			return FTextSpan{View.data(), 0, static_cast<int32>(View.size())};
+		}
+		else if constexpr (std::is_convertible_v<const T &, const TCHAR *>)
+		{
+			const TCHAR * String = Value;
+			return AppendText(String, FCString::Strlen(String));
+		}
+		else if constexpr (std::is_same_v<T, FString>)
+		{
+			return AppendText(*Value, Value.Len());
+		}
+		else if constexpr (std::is_same_v<T, FName>)
+		{
+			TStringBuilder<FName::StringBufferSize> Name;
+			Value.AppendString(Name);
+			return AppendText(Name.GetData(), Name.Len());
+		}
+		else
+		{
+			return AppendText(std::to_string(Value));
+		}
+	}
+
+	FTextSpan AppendText(const TCHAR * Value, const int32 Length)
+	{
+		const int32 Offset    = Text.Num();
+		const int32 Converted = FPlatformString::ConvertedLength<UTF8CHAR>(Value, Length);
+		Text.AddUninitialized(Converted);
+		FPlatformString::Convert(reinterpret_cast<UTF8CHAR *>(Text.GetData() + Offset), Converted, Value, Length);
+		return FTextSpan{nullptr, Offset, Converted};
+	}
+
+	FTextSpan AppendText(const std::string_view & Value)
+	{
+		const int32 Offset = Text.Num();
+		Text.Append(Value.data(), static_cast<int32>(Value.size()));
+		return FTextSpan{nullptr, Offset, static_cast<int32>(Value.size())};
+	}
+
+	template <typename ValueType> void AddField(const FTextSpan & Key, const ValueType & Value)
+	{
+		FField Field;
+		Field.Key = Key;
+		if constexpr (std::is_same_v<ValueType, bool>)
+		{
+			Field.Type = EType::Bool;
+			Field.Bool = Value;
+		}
+		else if constexpr (std::is_integral_v<ValueType>)
+		{
+			// uint64 values past the int64 range stay numbers, slightly rounded
+			if constexpr (std::is_unsigned_v<ValueType> && sizeof(ValueType) >= sizeof(int64))
+			{
+				if (Value > static_cast<ValueType>(std::numeric_limits<int64>::max()))
+				{
+					Field.Type = EType::Double;
+					Field.Real = static_cast<double>(Value);
+					SetField(Field);
+					return;
+				}
+			}
+			Field.Type = EType::Int64;
+			Field.Int  = static_cast<int64>(Value);
+		}
+		else if constexpr (std::is_floating_point_v<ValueType>)
+		{
+			Field.Type = EType::Double;
+			Field.Real = static_cast<double>(Value);
+		}
+		else
+		{
+			Field.Type   = EType::String;
+			Field.String = MakeText(Value);
+		}
+		SetField(Field);
+	}
+
+	void SetField(const FField & Field)
+	{
+		const std::string_view Key = GetText(Field.Key);
+		for (FField & Existing : Fields)
+		{
+			if (GetText(Existing.Key) == Key)
+			{
+				Existing = Field;
+				return;
+			}
+		}
+		Fields.Add(Field);
+	}
+
+	Herald::LogLevels                              Level;
+	FFieldArray                                    Fields;
+	TArray<ANSICHAR, TInlineAllocator<InlineText>> Text;
+	FTextSpan                                      Message; // after Text, a wide message is converted into it
+};
@@ -0,0 +1,29 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Herald/LogLevels.hpp"
+
+/// <summary>
+/// Herald hands writers nothing but the transformed JSON string, so the severity of the line being written travels
+/// alongside it in a thread local. The output device, and the Herald::log()/event() helpers in ETLogger.h, open a
+/// scope around each transform so ElasticTelemetryWriter::write() (called synchronously on the same thread) can make
+/// severity-aware queueing decisions. Lines written outside of any scope are treated as Info.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryLogLevelScope
+{
+  public:
+	explicit FElasticTelemetryLogLevelScope(Herald::LogLevels Level);
+	~FElasticTelemetryLogLevelScope();
+
+	FElasticTelemetryLogLevelScope(const FElasticTelemetryLogLevelScope &)             = delete;
+	FElasticTelemetryLogLevelScope & operator=(const FElasticTelemetryLogLevelScope &) = delete;
+
+	/// <returns>The level of the innermost scope open on the calling thread.</returns>
+	static Herald::LogLevels GetCurrent();
+
+  private:
+	Herald::LogLevels Previous;
+};
@@ -8,6 +8,21 @@
 #include "Logging/LogVerbosity.h"
 #include "ElasticTelemetrySettings.generated.h"
 
+/// <summary>
+/// What the writer does with new log lines once its outbound queue reaches OutboundQueueMaxBytes.
+/// </summary>
+UENUM(BlueprintType)
+enum class EElasticTelemetryOverflowPolicy : uint8
+{
+	// Refuse new log lines until the queue drains
+	DropNewest,
+	// Discard the oldest queued log lines to make room for new ones
+	DropOldest,
+	// Refuse VeryVerbose/Verbose lines first, then Log, Display and Warning as the queue fills. Errors, Fatals and
+	// events are never refused and push out the oldest lines instead.
+	DropLowestSeverity
+};
+
 USTRUCT(BlueprintType)
 struct ELASTICTELEMETRY_API FElasticTelemetrySettings
 {
@@ -18,6 +33,9 @@ struct ELASTICTELEMETRY_API FElasticTelemetrySettings
 	// Conversion helper
 	bool IsLogLevelEnabled(ELogVerbosity::Type LogLevel) const;
 
+	// EndpointURL and AdditionalEndpointURLs as the comma separated list the writer takes
+	FString GetEndpointList() const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Enable/Disable Elastic Telemetry Globally")
 	bool Enabled;
 
@@ -26,13 +44,30 @@ struct ELASTICTELEMETRY_API FElasticTelemetrySettings
 	    DisplayName = "ElasticSearch API endpoint. Usually https://someserver.com:9200/")
 	FString EndpointURL;
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Index prefix for all log messages, defaults to UELog")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "More ElasticSearch nodes to spread requests over, and fail over to")
+	TArray<FString> AdditionalEndpointURLs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Replace the endpoints with the HTTP nodes the cluster reports through _nodes/http")
+	bool DiscoverEndpoints;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Seconds between node discovery requests",
+	    meta = (ClampMin = "10", EditCondition = "DiscoverEndpoints"))
+	int32 EndpointDiscoveryIntervalSeconds;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Index for all log messages, defaults to UELog. A date in braces rolls daily: uelog-{yyyy.MM.dd}")
 	FString IndexName;
 
 	UPROPERTY(
 	    EditAnywhere, BlueprintReadOnly, DisplayName = "Index prefix for all events, defaults to testing_game_events")
 	FString EventIndexName;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "The indices are data streams, documents are sent with op_type create")
+	bool UseDataStream;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "ElasticSearch user. Ask server administrator.")
 	FString Username;
 
@@ -81,6 +116,103 @@ struct ELASTICTELEMETRY_API FElasticTelemetrySettings
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	bool IncludeCallstacksOnVeryVerbose;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Use the ElasticSearch _bulk API to send many log lines per request")
+	bool UseBulkAPI;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Maximum documents per _bulk request",
+	    meta = (ClampMin = "1", EditCondition = "UseBulkAPI"))
+	int32 BulkMaxDocuments;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Maximum bytes per _bulk request",
+	    meta = (ClampMin = "1024", EditCondition = "UseBulkAPI"))
+	int32 BulkMaxBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Wake the writer once this many log lines are queued",
+	    meta = (ClampMin = "1"))
+	int32 FlushMaxDocuments;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Wake the writer once this many bytes are queued",
+	    meta = (ClampMin = "1"))
+	int32 FlushMaxBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Longest time in milliseconds a log line may wait in the queue before it is sent",
+	    meta = (ClampMin = "0"))
+	int32 FlushLingerMilliseconds;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Gzip level for request bodies, 0 disables compression, 1 is fastest, 9 is smallest",
+	    meta = (ClampMin = "0", ClampMax = "9"))
+	int32 CompressionLevel;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Writer threads, each with its own queue and batches. Lines from one thread stay in order",
+	    meta = (ClampMin = "1", ClampMax = "16"))
+	int32 WriterShards;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Send Error and Fatal lines at once on their own thread, ahead of batched lines")
+	bool PriorityLane;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Maximum bytes of log lines waiting to be sent before the overflow policy applies",
+	    meta = (ClampMin = "65536"))
+	int32 OutboundQueueMaxBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "What to drop when the outbound queue is full")
+	EElasticTelemetryOverflowPolicy OverflowPolicy;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Spool undelivered telemetry to disk and send it once the endpoint is back")
+	bool EnableSpool;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Maximum bytes of spooled telemetry kept on disk",
+	    meta = (ClampMin = "1048576", EditCondition = "EnableSpool"))
+	int32 SpoolMaxBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Longest shutdown waits for queued telemetry to be sent, in milliseconds",
+	    meta = (ClampMin = "0"))
+	int32 ShutdownDrainMilliseconds;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Queued lines written to the spool when the process crashes, 0 disables it",
+	    meta = (ClampMin = "0", EditCondition = "EnableSpool"))
+	int32 CrashFlushLines;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Publish writer queue, throughput and latency counters to \"stat ElasticTelemetry\"")
+	bool PublishStatCounters;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Timestamp log lines from a monotonic clock, so bursts stay in order when the system clock steps")
+	bool MonotonicTimeStamps;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Maximum HTTP requests in flight at once",
+	    meta = (ClampMin = "1"))
+	int32 MaximumPendingRequests;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Adapt the number of requests in flight to observed latency and throttling")
+	bool AdaptiveConcurrency;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Fewest requests in flight adaptive concurrency may go to",
+	    meta = (ClampMin = "1", EditCondition = "AdaptiveConcurrency"))
+	int32 AdaptiveConcurrencyFloor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Most requests in flight adaptive concurrency may go to",
+	    meta = (ClampMin = "1", EditCondition = "AdaptiveConcurrency"))
+	int32 AdaptiveConcurrencyCeiling;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly,
+	    DisplayName = "Delay before retrying after the endpoint fails, doubled on every consecutive failure",
+	    meta = (ClampMin = "1"))
+	int32 RetryInitialBackoffMilliseconds;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, DisplayName = "Longest delay between retries", meta = (ClampMin = "1"))
+	int32 RetryMaxBackoffMilliseconds;
+
 	UPROPERTY(EditAnywhere, BluePrintReadOnly,
 	    DisplayName = "List of categories to exclude. Ignored if IncludedCategories is not empty.")
 	TArray<FName> ExcludedLogCategories;
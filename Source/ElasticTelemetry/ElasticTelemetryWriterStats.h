@@ -0,0 +1,158 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// <summary>
+/// A snapshot of a log-linear histogram, HDR style: every power of two is split into SubBuckets equal buckets, so
+/// any value is known to within 1/SubBuckets (12.5%) over the whole uint64 range, in a fixed 4KB.
+/// </summary>
+struct FElasticTelemetryHistogram
+{
+	static constexpr int32 SubBucketBits = 3;
+	static constexpr int32 SubBuckets    = 1 << SubBucketBits;
+	static constexpr int32 BucketCount   = (64 - SubBucketBits + 1) * SubBuckets;
+
+	uint64 Count               = 0;
+	uint64 Sum                 = 0;
+	uint64 Max                 = 0;
+	uint64 Buckets[BucketCount] = {};
+
+	static inline int32 GetBucketIndex(const uint64 Value)
+	{
+		if (Value < SubBuckets)
+			return static_cast<int32>(Value);
+		const int32 Shift = static_cast<int32>(FMath::FloorLog2_64(Value)) - SubBucketBits;
+		return (Shift + 1) * SubBuckets + static_cast<int32>((Value >> Shift) & (SubBuckets - 1));
+	}
+
+	/// <returns>The largest value that falls in bucket Index.</returns>
+	static inline uint64 GetBucketUpperBound(const int32 Index)
+	{
+		if (Index < SubBuckets)
+			return static_cast<uint64>(Index);
+		const int32 Shift = Index / SubBuckets - 1;
+		return ((static_cast<uint64>(SubBuckets + Index % SubBuckets) + 1) << Shift) - 1;
+	}
+
+	/// <summary>
+	/// The value below which Percentile (0 to 1) of the samples fall, rounded up to the end of its bucket.
+	/// </summary>
+	inline uint64 GetPercentile(const double Percentile) const
+	{
+		const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(Percentile * Count)));
+		uint64       Seen = 0;
+		for (int32 i = 0; i < BucketCount && Count > 0; ++i)
+		{
+			Seen += Buckets[i];
+			if (Seen >= Rank)
+				return FMath::Min(GetBucketUpperBound(i), Max);
+		}
+		return Max;
+	}
+
+	inline double GetMean() const { return Count > 0 ? static_cast<double>(Sum) / Count : 0.0; }
+
+	void Merge(const FElasticTelemetryHistogram & Other)
+	{
+		Count += Other.Count;
+		Sum += Other.Sum;
+		Max = FMath::Max(Max, Other.Max);
+		for (int32 i = 0; i < BucketCount; ++i)
+		{
+			Buckets[i] += Other.Buckets[i];
+		}
+	}
+};
+
+/// <summary>
+/// A snapshot of an ElasticTelemetry writer's counters. Counters are cumulative for the life of the writer.
+/// </summary>
+struct FElasticTelemetryWriterStats
+{
+	// Throughput since the writer was created, divide by UptimeSeconds for a rate
+	double UptimeSeconds     = 0.0;
+	uint64 EnqueuedDocuments = 0;
+	uint64 EnqueuedBytes     = 0;
+
+	// Each enqueued line is copied into a message block, recycled once the line has been sent. Allocated counts
+	// the blocks that came from the heap because none was free or large enough, see FElasticTelemetryMessagePool.
+	uint64 MessageBlocksAllocated = 0;
+	uint64 MessageBlocksReused    = 0;
+
+	// Each batch the worker threads pack into a request, before retries. Bytes are the body before compression,
+	// CompressedBytes what went on the wire, the same when CompressionLevel is 0.
+	FElasticTelemetryHistogram BatchDocuments;
+	FElasticTelemetryHistogram BatchBytes;
+	uint64                     UncompressedBytes = 0;
+	uint64                     CompressedBytes   = 0;
+
+	// Every request sent, resends included, from Send() to its completion
+	uint64                     Requests = 0;
+	FElasticTelemetryHistogram RequestLatencyMicroseconds;
+
+	// log lines currently waiting in the outbound queues, over all WriterShards
+	uint32 WriterShards   = 0;
+	uint32 QueuedMessages = 0;
+	uint64 QueuedBytes    = 0;
+
+	// Dropped under memory pressure, by overflow policy. See EElasticTelemetryOverflowPolicy.
+	uint64 DroppedNewest      = 0;
+	uint64 DroppedOldest      = 0;
+	uint64 DroppedLowSeverity = 0;
+
+	// HTTP requests outstanding, and how often and how long the writer had to wait for the window to open up
+	int32  InFlightRequests       = 0;
+	int32  MaximumPendingRequests = 0; // current limit, moves between the floor and ceiling with AdaptiveConcurrency
+	int32  PeakInFlightRequests   = 0;
+	uint64 InFlightWaits          = 0;
+	double InFlightWaitSeconds    = 0.0;
+	double MaxInFlightWaitSeconds = 0.0;
+
+	// Adaptive concurrency, see FElasticTelemetryConcurrencyController
+	uint64 ConcurrencyDecreases   = 0;
+	double SmoothedLatencySeconds = 0.0;
+	double BaselineLatencySeconds = 0.0;
+
+	// ElasticSearch nodes requests are spread over, see FElasticTelemetryEndpointPool
+	int32  Endpoints          = 0;
+	int32  AvailableEndpoints = 0; // healthy, or due a probe
+	uint64 FailedOverRequests = 0; // failed on one node and resent to another without pausing
+
+	// Requests that failed with a retryable error, or were made while the circuit was open, are held and resent
+	// once the endpoint is back. See FElasticTelemetryCircuitBreaker.
+	bool   bCircuitOpen      = false;
+	uint64 RetryableFailures = 0;
+	uint64 ResentRequests    = 0;
+	uint64 RejectedRequests  = 0; // refused with a non-retryable 4xx, not retried
+	uint64 DroppedRetries    = 0; // held in memory (no spool) and pushed out by newer ones
+
+	// Documents refused individually inside an otherwise successful _bulk response
+	uint64 RequeuedDocuments       = 0; // transient failure, sent again with a later batch
+	uint64 DroppedPoisonDocuments  = 0; // mapping or parsing errors, would fail the same way every time
+	uint64 UnreadableBulkResponses = 0; // could not be parsed, assumed indexed
+
+	// Disk spool for held requests, see FElasticTelemetrySpool
+	uint64 SpoolBytes          = 0;
+	uint64 SpooledRequests     = 0;
+	uint64 SpoolEvictedBytes   = 0; // oldest segments deleted to stay under SpoolMaxBytes
+	uint64 SpoolDiscardedBytes = 0; // torn or corrupt records found during replay
+
+	inline uint64 GetTotalDropped() const { return DroppedNewest + DroppedOldest + DroppedLowSeverity; }
+};
+
+/// <summary>
+/// What a writer's shutdown drain did with the log lines it still had, see IElasticTelemetryWriter::Drain().
+/// </summary>
+struct FElasticTelemetryDrainReport
+{
+	uint64 FlushedDocuments = 0; // delivered before the deadline
+	uint64 SpilledDocuments = 0; // written to the spool, sent on the next launch
+	uint64 LostDocuments    = 0; // dropped, refused, or still in flight at the deadline
+	double Seconds          = 0.0;
+	bool   bTimedOut        = false; // the deadline passed with lines still to send
+
+	inline uint64 GetTotal() const { return FlushedDocuments + SpilledDocuments + LostDocuments; }
+};
@@ -12,6 +12,8 @@
 /// in ElasticSearch. Internally, these names are used as filenames,
 /// so only characters that are valid for filenames should be used.
 ///
+/// Date fields in braces, as in uelog-{yyyy.MM.dd}, are kept with their
+/// case so the writer can resolve them, see FElasticTelemetryIndexName.
 /// </summary>
 /// <param name="IndexName"></param>
 /// <returns>
@@ -20,11 +22,21 @@
 /// </returns>
 inline FString FileNameFriendly(const FString& IndexName)
 {
-	FString Result = IndexName.ToLower();
+	FString Result = IndexName;
+	bool    bInField = false;
 	for (TCHAR& i : Result)
 	{
+		if (i == '{' || i == '}')
+		{
+			bInField = i == '{';
+			continue;
+		}
+		if (!bInField)
+			i = FChar::ToLower(i);
 		if ((i >= 'a' && i <= 'z') || (i >= '0' && i <= '9') || (i == '-') || (i == '_') || (i == '.'))
 			continue;
+		if (bInField && i >= 'A' && i <= 'Z')
+			continue;
 		i = '_';
 	}
 	return Result;
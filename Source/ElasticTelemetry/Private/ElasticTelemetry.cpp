@@ -3,22 +3,69 @@
 
 #include "ElasticTelemetry.h"
 #include "ETLogger.h"
+#include "ElasticTelemetryCrashHandler.h"
 #include "ElasticTelemetryEnvironmentSettings.h"
+#include "ElasticTelemetryJsonTransformer.h"
 #include "ElasticTelemetryOutputDevice.h"
+#include "ElasticTelemetryStatCounters.h"
 #include "ElasticTelemetryWriter.h"
 #include "FileNameFriendly.h"
-#include "Herald/JsonLogTransformerFactory.hpp"
 #include "Herald/LogLevels.hpp"
 #include "HttpModule.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FElasticTelemetryModule"
 
 DEFINE_LOG_CATEGORY(TelemetryLog);
 
+namespace
+{
+	// Delivery tuning shared by the log and event writers
+	void ApplyWriterTuning(
+	    Herald::ILogWriter & Writer, const FElasticTelemetrySettings & Settings, const std::string & IndexName)
+	{
+		Writer.addConfigPair("UseBulkAPI", Settings.UseBulkAPI ? "true" : "false");
+		Writer.addConfigPair("BulkMaxDocuments", std::to_string(Settings.BulkMaxDocuments));
+		Writer.addConfigPair("BulkMaxBytes", std::to_string(Settings.BulkMaxBytes));
+		Writer.addConfigPair("FlushMaxDocuments", std::to_string(Settings.FlushMaxDocuments));
+		Writer.addConfigPair("FlushMaxBytes", std::to_string(Settings.FlushMaxBytes));
+		Writer.addConfigPair("FlushLingerMilliseconds", std::to_string(Settings.FlushLingerMilliseconds));
+		Writer.addConfigPair("CompressionLevel", std::to_string(Settings.CompressionLevel));
+		Writer.addConfigPair("WriterShards", std::to_string(Settings.WriterShards));
+		Writer.addConfigPair("PriorityLane", Settings.PriorityLane ? "true" : "false");
+		Writer.addConfigPair("UseDataStream", Settings.UseDataStream ? "true" : "false");
+		Writer.addConfigPair("OutboundQueueMaxBytes", std::to_string(Settings.OutboundQueueMaxBytes));
+		Writer.addConfigPair("OverflowPolicy",
+		    TCHAR_TO_UTF8(*StaticEnum<EElasticTelemetryOverflowPolicy>()->GetNameStringByValue(
+		        static_cast<int64>(Settings.OverflowPolicy))));
+
+		// one spool per index, so replay goes back to the index it was meant for
+		const FString SpoolDirectory = Settings.EnableSpool
+		                                   ? FPaths::ProjectSavedDir() / TEXT("ElasticTelemetry") / TEXT("Spool") /
+		                                         UTF8_TO_TCHAR(IndexName.c_str())
+		                                   : FString();
+		Writer.addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*SpoolDirectory));
+		Writer.addConfigPair("SpoolMaxBytes", std::to_string(Settings.SpoolMaxBytes));
+		Writer.addConfigPair("CrashFlushLines", std::to_string(Settings.CrashFlushLines));
+		Writer.addConfigPair("MaximumPendingRequests", std::to_string(Settings.MaximumPendingRequests));
+		Writer.addConfigPair("AdaptiveConcurrency", Settings.AdaptiveConcurrency ? "true" : "false");
+		Writer.addConfigPair("AdaptiveConcurrencyFloor", std::to_string(Settings.AdaptiveConcurrencyFloor));
+		Writer.addConfigPair("AdaptiveConcurrencyCeiling", std::to_string(Settings.AdaptiveConcurrencyCeiling));
+		Writer.addConfigPair(
+		    "RetryInitialBackoffMilliseconds", std::to_string(Settings.RetryInitialBackoffMilliseconds));
+		Writer.addConfigPair("RetryMaxBackoffMilliseconds", std::to_string(Settings.RetryMaxBackoffMilliseconds));
+		Writer.addConfigPair("DiscoverEndpoints", Settings.DiscoverEndpoints ? "true" : "false");
+		Writer.addConfigPair(
+		    "EndpointDiscoveryIntervalSeconds", std::to_string(Settings.EndpointDiscoveryIntervalSeconds));
+	}
+} // namespace
+
 FElasticTelemetryModule::FElasticTelemetryModule()
     : Settings()
     , EventSettings()
     , OutputDevice(nullptr)
+    , CrashHandler()
+    , StatCounters()
 {
 }
 
@@ -42,13 +89,14 @@ void FElasticTelemetryModule::StartupModule()
 	}
 	EventWriter = EventWriterBuilder->build();
 
-	auto LogFactory = Herald::createJsonLogTransformerBuilder();
+	auto LogFactory = createElasticTelemetryJsonTransformerBuilder();
 	if (nullptr == LogFactory)
 	{
 		UE_LOG(TelemetryLog, Error, TEXT("Failed to create log transformer factory."));
 		return;
 	}
 	EventTransformer = LogFactory->attachLogWriter(EventWriter).build();
+	AsElasticTelemetryWriter(EventWriter)->SetJsonTransformer(EventTransformer);
 
 	// Already spawned from the editor most likely, which is
 	// re-logging output.
@@ -71,6 +119,9 @@ void FElasticTelemetryModule::StartupModule()
 	// otherwise, the http module may not be ready when the http logger tries to use it
 	FHttpModule::Get();
 
+	CrashHandler = MakeUnique<FElasticTelemetryCrashHandler>(
+	    OutputDevice->GetJsonTransformer(), OutputDevice->GetElasticWriter(), EventWriter);
+
 	// Create a unique session ID guid for this session
 	// This is used to group logs together in ElasticSearch
 	// and can be used to filter logs by session
@@ -163,9 +214,24 @@ void FElasticTelemetryModule::UpdateConfig()
 		UE_LOG(TelemetryLog, Log, TEXT("Telemetry is enabled."));
 	}
 
+	if (Settings.PublishStatCounters && !StatCounters)
+	{
+		StatCounters = MakeUnique<FElasticTelemetryStatCounters>(*this);
+	}
+	else if (!Settings.PublishStatCounters)
+	{
+		StatCounters.Reset();
+	}
+
+	for (const Herald::ILogTransformerPtr & Transformer : {GetJsonTransformer(), EventTransformer})
+	{
+		if (Transformer)
+			AsElasticTelemetryJsonTransformer(Transformer)->SetMonotonicTimeStamps(Settings.MonotonicTimeStamps);
+	}
+
 	const std::string IndexName      = TCHAR_TO_UTF8(*FileNameFriendly(Settings.IndexName));
 	std::string       EventIndexName = TCHAR_TO_UTF8(*FileNameFriendly(Settings.EventIndexName));
-	const std::string EndpointURL    = TCHAR_TO_UTF8(*Settings.EndpointURL);
+	const std::string EndpointURL    = TCHAR_TO_UTF8(*Settings.GetEndpointList());
 	const std::string Username       = TCHAR_TO_UTF8(*Settings.Username);
 	const std::string Password       = TCHAR_TO_UTF8(*Settings.Password);
 
@@ -181,6 +247,7 @@ void FElasticTelemetryModule::UpdateConfig()
 		ElasticWriter->addConfigPair("Username", Username);
 		ElasticWriter->addConfigPair("Password", Password);
 		ElasticWriter->addConfigPair("IndexName", IndexName);
+		ApplyWriterTuning(*ElasticWriter, Settings, IndexName);
 	}
 
 	// Apply settings to the event writer
@@ -195,6 +262,7 @@ void FElasticTelemetryModule::UpdateConfig()
 	EventWriter->addConfigPair("Username", Username);
 	EventWriter->addConfigPair("Password", Password);
 	EventWriter->addConfigPair("IndexName", EventIndexName);
+	ApplyWriterTuning(*EventWriter, Settings, EventIndexName);
 }
 
 FElasticTelemetrySettings FElasticTelemetryModule::GetSettings() const
@@ -203,6 +271,26 @@ FElasticTelemetrySettings FElasticTelemetryModule::GetSettings() const
 	return Settings;
 }
 
+FElasticTelemetryWriterStats FElasticTelemetryModule::GetLogWriterStats() const
+{
+	if (!OutputDevice || !OutputDevice->GetElasticWriter())
+	{
+		return FElasticTelemetryWriterStats();
+	}
+
+	return AsElasticTelemetryWriter(OutputDevice->GetElasticWriter())->GetStats();
+}
+
+FElasticTelemetryWriterStats FElasticTelemetryModule::GetEventWriterStats() const
+{
+	if (!EventWriter)
+	{
+		return FElasticTelemetryWriterStats();
+	}
+
+	return AsElasticTelemetryWriter(EventWriter)->GetStats();
+}
+
 Herald::ILogTransformerPtr FElasticTelemetryModule::GetJsonTransformer() const
 {
 	// Get the Transformer from the OutputDevice
@@ -214,6 +302,14 @@ Herald::ILogTransformerPtr FElasticTelemetryModule::GetJsonTransformer() const
 	return OutputDevice->GetJsonTransformer();
 }
 
+void FElasticTelemetryModule::Log(const FElasticTelemetryLogEntry & Entry) const
+{
+	const Herald::ILogTransformerPtr Transformer =
+	    Entry.GetLevel() == Herald::LogLevels::Event ? EventTransformer : GetJsonTransformer();
+	if (Transformer)
+		AsElasticTelemetryJsonTransformer(Transformer)->Log(Entry);
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(FElasticTelemetryModule, ElasticTelemetry)
\ No newline at end of file
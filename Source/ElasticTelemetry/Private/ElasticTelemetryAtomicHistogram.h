@@ -0,0 +1,57 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryWriterStats.h"
+#include <atomic>
+
+/// <summary>
+/// The recording side of FElasticTelemetryHistogram, for samples taken on any thread. Every update is a relaxed
+/// atomic add, so a snapshot taken meanwhile may be a sample or two out between Count, Sum and the buckets, which
+/// is fine for monitoring.
+/// </summary>
+class FElasticTelemetryAtomicHistogram
+{
+  public:
+	FElasticTelemetryAtomicHistogram()
+	    : Count(0)
+	    , Sum(0)
+	    , Max(0)
+	{
+		for (std::atomic<uint64> & Bucket : Buckets)
+		{
+			Bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void Record(const uint64 Value)
+	{
+		Buckets[FElasticTelemetryHistogram::GetBucketIndex(Value)].fetch_add(1, std::memory_order_relaxed);
+		Count.fetch_add(1, std::memory_order_relaxed);
+		Sum.fetch_add(Value, std::memory_order_relaxed);
+
+		uint64 Previous = Max.load(std::memory_order_relaxed);
+		while (Previous < Value && !Max.compare_exchange_weak(Previous, Value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void Snapshot(FElasticTelemetryHistogram & Out) const
+	{
+		Out.Count = Count.load(std::memory_order_relaxed);
+		Out.Sum   = Sum.load(std::memory_order_relaxed);
+		Out.Max   = Max.load(std::memory_order_relaxed);
+		for (int32 i = 0; i < FElasticTelemetryHistogram::BucketCount; ++i)
+		{
+			Out.Buckets[i] = Buckets[i].load(std::memory_order_relaxed);
+		}
+	}
+
+  private:
+	std::atomic<uint64> Count;
+	std::atomic<uint64> Sum;
+	std::atomic<uint64> Max;
+	std::atomic<uint64> Buckets[FElasticTelemetryHistogram::BucketCount];
+};
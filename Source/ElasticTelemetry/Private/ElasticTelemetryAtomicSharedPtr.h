@@ -0,0 +1,52 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include <memory>
+
+/// <summary>
+/// A shared_ptr to an immutable value that one thread can replace while others read it. Readers take the current
+/// value with one acquire load and keep it alive for as long as they hold it, however many times it is replaced
+/// meanwhile. std::atomic&lt;std::shared_ptr&gt; where the standard library has it, the C++11 atomic free functions
+/// (deprecated, but still everywhere) where it does not, libc++ among them.
+/// </summary>
+template <typename T> class TElasticTelemetryAtomicSharedPtr
+{
+  public:
+	explicit TElasticTelemetryAtomicSharedPtr(std::shared_ptr<const T> Initial)
+	    : Value(MoveTemp(Initial))
+	{
+	}
+
+	std::shared_ptr<const T> Load() const
+	{
+#if defined(__cpp_lib_atomic_shared_ptr)
+		return Value.load(std::memory_order_acquire);
+#else
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		return std::atomic_load_explicit(&Value, std::memory_order_acquire);
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+#endif
+	}
+
+	void Store(std::shared_ptr<const T> NewValue)
+	{
+#if defined(__cpp_lib_atomic_shared_ptr)
+		Value.store(MoveTemp(NewValue), std::memory_order_release);
+#else
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		std::atomic_store_explicit(&Value, MoveTemp(NewValue), std::memory_order_release);
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+#endif
+	}
+
+  private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+	std::atomic<std::shared_ptr<const T>> Value;
+#else
+	std::shared_ptr<const T> Value;
+#endif
+};
@@ -0,0 +1,171 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Calls Emit with every byte of Json that is not whitespace outside of a string literal.
+///
+/// Herald's JsonLogTransformer uses a rapidjson PrettyWriter, so every transformed log line arrives spread over
+/// several lines. The ElasticSearch _bulk API is newline delimited (NDJSON) and requires each document on exactly
+/// one line. Newlines inside JSON strings are always escaped, so any raw whitespace byte outside of a string is
+/// formatting and safe to drop.
+/// </summary>
+template <typename EmitType>
+inline void ForEachCompactJsonByte(const std::string_view & Json, EmitType && Emit)
+{
+	bool bInString = false;
+	bool bEscaped  = false;
+	for (const char c : Json)
+	{
+		if (bInString)
+		{
+			if (bEscaped)
+				bEscaped = false;
+			else if (c == '\\')
+				bEscaped = true;
+			else if (c == '"')
+				bInString = false;
+		}
+		else if (c == '"')
+		{
+			bInString = true;
+		}
+		else if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+		{
+			continue;
+		}
+		Emit(c);
+	}
+}
+
+/// <summary>
+/// Whether Json already fits on one NDJSON line and can be taken as it is. The ElasticTelemetry transformer writes
+/// compact documents, only pretty printed ones such as Herald's JsonLogTransformer output contain a raw newline.
+/// </summary>
+inline bool IsSingleLineJson(const std::string_view & Json)
+{
+	return Json.find('\n') == std::string_view::npos;
+}
+
+/// <summary>
+/// Appends Json to Out with all whitespace outside of string literals removed, see ForEachCompactJsonByte(). A
+/// document that is already on one line is appended as it is, without the byte by byte scan.
+/// </summary>
+/// <param name="Out">Destination buffer, appended to.</param>
+/// <param name="Json">A well-formed JSON document.</param>
+inline void AppendCompactJson(TArray<uint8> & Out, const std::string & Json)
+{
+	if (IsSingleLineJson(Json))
+	{
+		Out.Append(reinterpret_cast<const uint8 *>(Json.data()), static_cast<int32>(Json.size()));
+		return;
+	}
+
+	// grow once for the worst case and write through a raw pointer, rather than a bounds checked Add() per byte
+	const int32 Start = Out.Num();
+	Out.AddUninitialized(static_cast<int32>(Json.size()));
+	uint8 * Write = Out.GetData() + Start;
+	ForEachCompactJsonByte(Json, [&Write](const char c) { *Write++ = static_cast<uint8>(c); });
+	Out.SetNum(static_cast<int32>(Write - Out.GetData()), EAllowShrinking::No);
+}
+
+/// <summary>
+/// Packs transformed JSON documents into an NDJSON body for the ElasticSearch _bulk API, respecting a maximum number
+/// of documents and bytes per request. The worker thread keeps one builder around and reuses its buffer between
+/// requests.
+///
+/// The body is UTF-8 from end to end: documents arrive as UTF-8 from Herald and are compacted straight into the
+/// TArray that the HTTP request takes ownership of, see DetachBody().
+/// </summary>
+class FElasticTelemetryBulkBuilder
+{
+  public:
+	FElasticTelemetryBulkBuilder(const uint32 InMaxDocuments, const uint32 InMaxBytes)
+	    : Body()
+	    , DocumentCount(0)
+	    , MaxDocuments(InMaxDocuments)
+	    , MaxBytes(InMaxBytes)
+	    , bCreate(false)
+	{
+	}
+
+	/// <summary>
+	/// Use create rather than index action lines, which data streams require. Only change it between bodies.
+	/// </summary>
+	inline void SetCreate(const bool bInCreate) { bCreate = bInCreate; }
+
+	/// <summary>
+	/// Adjust the limits. Takes effect for the next append, an in-progress body is not split.
+	/// </summary>
+	void SetLimits(const uint32 InMaxDocuments, const uint32 InMaxBytes)
+	{
+		MaxDocuments = InMaxDocuments;
+		MaxBytes     = InMaxBytes;
+	}
+
+	/// <summary>
+	/// Whether Document fits in the current body. An empty body always accepts a document, even when it is larger
+	/// than MaxBytes on its own, otherwise an oversized log line would never be sent.
+	/// </summary>
+	bool CanAppend(const std::string & Document) const
+	{
+		if (DocumentCount == 0)
+			return true;
+
+		if (MaxDocuments > 0 && DocumentCount >= MaxDocuments)
+			return false;
+
+		// action line + document + newline, the document may shrink when compacted so this is conservative
+		const size_t Required = Body.Num() + ActionLine(bCreate).size() + Document.size() + 1;
+		return MaxBytes == 0 || Required <= MaxBytes;
+	}
+
+	void Append(const std::string & Document)
+	{
+		const std::string_view Action = ActionLine(bCreate);
+		Body.Append(reinterpret_cast<const uint8 *>(Action.data()), static_cast<int32>(Action.size()));
+		AppendCompactJson(Body, Document);
+		Body.Add('\n');
+		++DocumentCount;
+	}
+
+	void Reset()
+	{
+		// Reset() keeps the capacity, so steady state batching does not reallocate
+		Body.Reset();
+		DocumentCount = 0;
+	}
+
+	/// <summary>
+	/// Moves the body out, for IHttpRequest::SetContent(TArray&&) to take without a copy, and leaves the builder
+	/// empty. The next body is allocated once at the size of this one, rather than grown line by line.
+	/// </summary>
+	TArray<uint8> DetachBody()
+	{
+		TArray<uint8> Detached = MoveTemp(Body);
+		Body.Reserve(Detached.Num());
+		DocumentCount = 0;
+		return Detached;
+	}
+
+	inline bool                  IsEmpty() const { return DocumentCount == 0; }
+	inline uint32                GetDocumentCount() const { return DocumentCount; }
+	inline const TArray<uint8> & GetBody() const { return Body; }
+
+	static constexpr std::string_view ActionLine(const bool bCreate = false)
+	{
+		return bCreate ? "{\"create\":{}}\n" : "{\"index\":{}}\n";
+	}
+
+  private:
+	TArray<uint8> Body;
+	uint32        DocumentCount;
+	uint32        MaxDocuments;
+	uint32        MaxBytes;
+	bool          bCreate;
+};
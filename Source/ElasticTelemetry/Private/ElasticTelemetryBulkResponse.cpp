@@ -0,0 +1,114 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryBulkResponse.h"
+#include "Serialization/JsonReader.h"
+#include <string_view>
+
+namespace
+{
+	// "took" is a small integer, so "errors" is always within the first few bytes of the response
+	constexpr int64 ErrorsFlagSearchBytes = 128;
+} // namespace
+
+bool FElasticTelemetryBulkResponse::FItemFailure::IsRetryable() const
+{
+	return Status == 429 || Status >= 500 || ErrorType == TEXT("es_rejected_execution_exception");
+}
+
+bool FElasticTelemetryBulkResponse::HasNoErrors(const uint8 * Data, const int64 Size)
+{
+	const std::string_view Head(reinterpret_cast<const char *>(Data),
+	    static_cast<size_t>(FMath::Min(Size, ErrorsFlagSearchBytes)));
+	return Head.find("\"errors\":false") != std::string_view::npos;
+}
+
+bool FElasticTelemetryBulkResponse::Parse(const FString & Json, TArray<FItemFailure> & OutFailures)
+{
+	return ParseItems(TJsonReaderFactory<>::Create(Json), OutFailures);
+}
+
+bool FElasticTelemetryBulkResponse::Parse(const uint8 * Data, const int64 Size, TArray<FItemFailure> & OutFailures)
+{
+	const FUtf8StringView Json(reinterpret_cast<const UTF8CHAR *>(Data), static_cast<int32>(Size));
+	return ParseItems(TJsonReaderFactory<UTF8CHAR>::CreateFromView(Json), OutFailures);
+}
+
+template <typename CharType>
+bool FElasticTelemetryBulkResponse::ParseItems(
+    const TSharedRef<TJsonReader<CharType>> & Reader, TArray<FItemFailure> & OutFailures)
+{
+	// {"took":3,"errors":true,"items":[{"index":{"status":400,"error":{"type":"mapper_parsing_exception",...}}},...]}
+	//  depth 1                          2 3        4                       5
+	int32        Depth      = 0;
+	int32        ItemsDepth = INDEX_NONE;
+	int32        ItemIndex  = INDEX_NONE;
+	bool         bInError   = false;
+	FItemFailure Item;
+
+	EJsonNotation Notation;
+	while (Reader->ReadNext(Notation))
+	{
+		const bool bInItems = ItemsDepth != INDEX_NONE;
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectStart:
+			if (bInItems && Depth == ItemsDepth + 1)
+			{
+				Item       = FItemFailure();
+				Item.Index = ++ItemIndex;
+				bInError   = false;
+			}
+			else if (bInItems && Depth == ItemsDepth + 3 && Reader->GetIdentifier() == TEXT("error"))
+			{
+				bInError = true;
+			}
+			++Depth;
+			break;
+
+		case EJsonNotation::ObjectEnd:
+			--Depth;
+			if (bInItems && Depth == ItemsDepth + 3)
+			{
+				bInError = false;
+			}
+			else if (bInItems && Depth == ItemsDepth + 1 && (Item.Status < 200 || Item.Status > 299))
+			{
+				OutFailures.Add(MoveTemp(Item));
+			}
+			break;
+
+		case EJsonNotation::ArrayStart:
+			if (Depth == 1 && Reader->GetIdentifier() == TEXT("items"))
+				ItemsDepth = Depth;
+			++Depth;
+			break;
+
+		case EJsonNotation::ArrayEnd:
+			--Depth;
+			if (Depth == ItemsDepth)
+				ItemsDepth = INDEX_NONE;
+			break;
+
+		case EJsonNotation::Number:
+			if (bInItems && Depth == ItemsDepth + 3 && Reader->GetIdentifier() == TEXT("status"))
+				Item.Status = static_cast<int32>(Reader->GetValueAsNumber());
+			break;
+
+		case EJsonNotation::String:
+			if (bInItems && bInError && Depth == ItemsDepth + 4 && Reader->GetIdentifier() == TEXT("type"))
+				Item.ErrorType = Reader->GetValueAsString();
+			else if (bInItems && Depth == ItemsDepth + 3 && Reader->GetIdentifier() == TEXT("error"))
+				Item.ErrorType = Reader->GetValueAsString(); // older servers report the error as a plain string
+			break;
+
+		case EJsonNotation::Error:
+			return false;
+
+		default:
+			break;
+		}
+	}
+
+	return Reader->GetErrorMessage().IsEmpty() && Depth == 0;
+}
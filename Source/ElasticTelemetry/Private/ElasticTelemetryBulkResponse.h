@@ -0,0 +1,56 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/JsonReader.h"
+
+/// <summary>
+/// Reads the per-item results out of an ElasticSearch _bulk response.
+///
+/// A _bulk request answered with HTTP 200 can still have failed for some of its documents: mapping conflicts are
+/// permanent, es_rejected_execution_exception (a full write queue on the node) is not. The response lists one result
+/// per document, in request order, so item N is the document on line 2N+1 of the NDJSON body.
+///
+/// Responses are streamed through a TJsonReader rather than deserialized into a DOM, only the status and error type
+/// of each failed item are kept. Read straight from the UTF-8 bytes that arrived, a response for thousands of
+/// successful documents allocates nothing beyond the reader itself.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryBulkResponse
+{
+  public:
+	struct FItemFailure
+	{
+		int32   Index  = INDEX_NONE;
+		int32   Status = 0;
+		FString ErrorType;
+
+		/// <summary>
+		/// Whether sending the same document again could succeed. Throttling and node failures are transient, mapping
+		/// and parsing errors will fail the same way every time.
+		/// </summary>
+		bool IsRetryable() const;
+	};
+
+	/// <summary>
+	/// Cheap check on the raw response bytes. ElasticSearch writes "errors" right after "took", so a response with
+	/// no failed items can be recognised without parsing it.
+	/// </summary>
+	static bool HasNoErrors(const uint8 * Data, int64 Size);
+
+	/// <summary>
+	/// Collect every item whose status is not 2xx.
+	/// </summary>
+	/// <returns>false if Json is not a well-formed _bulk response.</returns>
+	static bool Parse(const FString & Json, TArray<FItemFailure> & OutFailures);
+
+	/// <summary>
+	/// Same as above, from the response body as it arrived, without converting it to TCHAR first.
+	/// </summary>
+	static bool Parse(const uint8 * Data, int64 Size, TArray<FItemFailure> & OutFailures);
+
+  private:
+	template <typename CharType>
+	static bool ParseItems(const TSharedRef<TJsonReader<CharType>> & Reader, TArray<FItemFailure> & OutFailures);
+};
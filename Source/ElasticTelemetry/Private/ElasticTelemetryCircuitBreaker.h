@@ -0,0 +1,115 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/// <summary>
+/// Circuit breaker with exponential backoff and jitter, guarding an ElasticSearch endpoint.
+///
+/// Closed: requests flow normally. The first retryable failure (connection error, 408, 429 or 5xx) opens the circuit
+/// and schedules a probe after a backoff of InitialBackoff * 2^(failures - 1), capped at MaxBackoff and never
+/// shorter than a server supplied Retry-After. The delay is jittered into [delay/2, delay] so a fleet of clients
+/// that lost the same server do not all come back at the same instant.
+///
+/// Open: nothing is sent. Once the probe time passes the worker moves the circuit to HalfOpen and sends exactly one
+/// request. Its success closes the circuit, its failure reopens it with twice the backoff.
+///
+/// Failures and successes are recorded from HTTP completion callbacks, probes are started by the writer's worker
+/// thread, so all state is atomic.
+/// </summary>
+class FElasticTelemetryCircuitBreaker
+{
+  public:
+	enum class EState : uint8
+	{
+		Closed,
+		Open,
+		HalfOpen
+	};
+
+	FElasticTelemetryCircuitBreaker()
+	    : State(EState::Closed)
+	    , ConsecutiveFailures(0)
+	    , ProbeTime(0.0)
+	    , InitialBackoffSeconds(1.0)
+	    , MaxBackoffSeconds(60.0)
+	{
+	}
+
+	void SetBackoff(const double InInitialBackoffSeconds, const double InMaxBackoffSeconds)
+	{
+		InitialBackoffSeconds = FMath::Max(0.001, InInitialBackoffSeconds);
+		MaxBackoffSeconds     = FMath::Max(InitialBackoffSeconds.load(), InMaxBackoffSeconds);
+	}
+
+	inline EState GetState() const { return State.load(); }
+	inline bool   IsClosed() const { return State.load() == EState::Closed; }
+	inline uint32 GetConsecutiveFailures() const { return ConsecutiveFailures.load(); }
+	inline double GetProbeTime() const { return ProbeTime.load(); }
+
+	void RecordSuccess()
+	{
+		ConsecutiveFailures = 0;
+		State               = EState::Closed;
+	}
+
+	/// <param name="Now">FPlatformTime::Seconds()</param>
+	/// <param name="RetryAfterSeconds">Retry-After from the response, 0 if there was none.</param>
+	void RecordFailure(const double Now, const double RetryAfterSeconds = 0.0)
+	{
+		// several in-flight requests usually fail together when a server goes away, only the first one counts
+		EState Current = State.load();
+		if (Current == EState::Open)
+			return;
+
+		// schedule the probe before publishing Open, so the worker never sees Open with a stale probe time
+		const uint32 Failures = ConsecutiveFailures.load() + 1;
+		ProbeTime             = Now + FMath::Max(GetBackoffSeconds(Failures), RetryAfterSeconds);
+		if (State.compare_exchange_strong(Current, EState::Open))
+			ConsecutiveFailures = Failures;
+	}
+
+	/// <summary>
+	/// Called by the worker. Moves an open circuit whose backoff has elapsed to HalfOpen.
+	/// </summary>
+	/// <returns>true if the caller should send a single probe request now.</returns>
+	bool TryBeginProbe(const double Now)
+	{
+		if (Now < ProbeTime.load())
+			return false;
+
+		EState Expected = EState::Open;
+		return State.compare_exchange_strong(Expected, EState::HalfOpen);
+	}
+
+	/// <summary>
+	/// Takes over the health of a breaker that is being replaced. A probe in flight reports to the old one, so
+	/// HalfOpen carries over as Open and the probe is simply due again.
+	/// </summary>
+	void CarryOver(const FElasticTelemetryCircuitBreaker & Previous)
+	{
+		ConsecutiveFailures = Previous.ConsecutiveFailures.load();
+		ProbeTime           = Previous.ProbeTime.load();
+		State               = Previous.IsClosed() ? EState::Closed : EState::Open;
+	}
+
+	/// <summary>
+	/// Jittered backoff before the probe that follows the Failures-th consecutive failure.
+	/// </summary>
+	double GetBackoffSeconds(const uint32 Failures) const
+	{
+		const int32  Exponent = FMath::Clamp(static_cast<int32>(Failures) - 1, 0, 30);
+		const double Capped   = FMath::Min(MaxBackoffSeconds.load(), InitialBackoffSeconds.load() * (1u << Exponent));
+		return FMath::FRandRange(Capped * 0.5, Capped);
+	}
+
+  private:
+	std::atomic<EState> State;
+	std::atomic<uint32> ConsecutiveFailures;
+	std::atomic<double> ProbeTime;
+	std::atomic<double> InitialBackoffSeconds;
+	std::atomic<double> MaxBackoffSeconds;
+};
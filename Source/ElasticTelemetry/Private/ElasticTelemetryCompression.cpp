@@ -0,0 +1,123 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryCompression.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+	// 15 bits of window, +16 asks zlib for a gzip header and trailer rather than a raw zlib stream
+	constexpr int GzipWindowBits = 15 + 16;
+	constexpr int GzipMemLevel   = 8;
+} // namespace
+
+struct FElasticTelemetryGzip::FState
+{
+	z_stream Stream;
+};
+
+FElasticTelemetryGzip::FElasticTelemetryGzip()
+    : State(nullptr)
+    , CurrentLevel(0)
+{
+}
+
+FElasticTelemetryGzip::~FElasticTelemetryGzip()
+{
+	if (State)
+	{
+		deflateEnd(&State->Stream);
+		delete State;
+	}
+}
+
+bool FElasticTelemetryGzip::Initialize(const int32 Level)
+{
+	if (State && Level == CurrentLevel)
+	{
+		return deflateReset(&State->Stream) == Z_OK;
+	}
+
+	if (State)
+	{
+		deflateEnd(&State->Stream);
+	}
+	else
+	{
+		State = new FState();
+	}
+
+	FMemory::Memzero(State->Stream);
+	CurrentLevel = Level;
+	if (deflateInit2(&State->Stream, Level, Z_DEFLATED, GzipWindowBits, GzipMemLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		delete State;
+		State = nullptr;
+		return false;
+	}
+	return true;
+}
+
+bool FElasticTelemetryGzip::Compress(const uint8 * Data, const int64 Size, const int32 Level, TArray<uint8> & Out)
+{
+	Out.Reset();
+	if (!Initialize(FMath::Clamp(Level, 1, 9)))
+		return false;
+
+	z_stream & Stream = State->Stream;
+	Out.SetNumUninitialized(static_cast<int32>(deflateBound(&Stream, static_cast<uLong>(Size))));
+
+	Stream.next_in   = const_cast<Bytef *>(reinterpret_cast<const Bytef *>(Data));
+	Stream.avail_in  = static_cast<uInt>(Size);
+	Stream.next_out  = reinterpret_cast<Bytef *>(Out.GetData());
+	Stream.avail_out = static_cast<uInt>(Out.Num());
+
+	// deflateBound guarantees a single Z_FINISH call completes
+	if (deflate(&Stream, Z_FINISH) != Z_STREAM_END)
+	{
+		Out.Reset();
+		return false;
+	}
+
+	Out.SetNum(static_cast<int32>(Stream.total_out), EAllowShrinking::No);
+	return true;
+}
+
+bool FElasticTelemetryGzip::Decompress(const uint8 * Data, const int64 Size, TArray<uint8> & Out)
+{
+	Out.Reset();
+
+	z_stream Stream;
+	FMemory::Memzero(Stream);
+	if (inflateInit2(&Stream, GzipWindowBits) != Z_OK)
+		return false;
+
+	Stream.next_in  = const_cast<Bytef *>(reinterpret_cast<const Bytef *>(Data));
+	Stream.avail_in = static_cast<uInt>(Size);
+
+	// log batches typically compress 5-10x, grow from there if needed
+	int Result = Z_OK;
+	Out.SetNumUninitialized(static_cast<int32>(FMath::Max<int64>(Size * 8, 1024)));
+	while (Result == Z_OK)
+	{
+		if (Stream.total_out == static_cast<uLong>(Out.Num()))
+			Out.SetNumUninitialized(Out.Num() * 2);
+
+		Stream.next_out  = reinterpret_cast<Bytef *>(Out.GetData()) + Stream.total_out;
+		Stream.avail_out = static_cast<uInt>(Out.Num() - Stream.total_out);
+		Result           = inflate(&Stream, Z_NO_FLUSH);
+	}
+	inflateEnd(&Stream);
+
+	if (Result != Z_STREAM_END)
+	{
+		Out.Reset();
+		return false;
+	}
+
+	Out.SetNum(static_cast<int32>(Stream.total_out), EAllowShrinking::No);
+	return true;
+}
@@ -0,0 +1,45 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// <summary>
+/// Gzip (RFC 1952) compressor for request bodies sent with "Content-Encoding: gzip".
+///
+/// Log documents are extremely repetitive (headers, categories and verbosity strings repeat in every line), so a
+/// batch body typically compresses 5-10x. One instance is owned by each writer worker thread and reused for every
+/// request so the deflate state is allocated once, not per request. Not thread safe.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryGzip
+{
+  public:
+	FElasticTelemetryGzip();
+	~FElasticTelemetryGzip();
+
+	FElasticTelemetryGzip(const FElasticTelemetryGzip &)             = delete;
+	FElasticTelemetryGzip & operator=(const FElasticTelemetryGzip &) = delete;
+
+	/// <summary>
+	/// Compress Size bytes from Data into Out, replacing its contents. Out keeps its allocation between calls.
+	/// </summary>
+	/// <param name="Level">zlib compression level, 1 (fastest) to 9 (smallest).</param>
+	/// <returns>false if zlib reported an error, Out is empty in that case.</returns>
+	bool Compress(const uint8 * Data, int64 Size, int32 Level, TArray<uint8> & Out);
+
+	/// <summary>
+	/// Decompress a gzip stream into Out, replacing its contents. Used on the rare path where a request that was sent
+	/// compressed has to be taken apart again, so it does not keep any state between calls.
+	/// </summary>
+	/// <returns>false if Data is not a complete gzip stream, Out is empty in that case.</returns>
+	static bool Decompress(const uint8 * Data, int64 Size, TArray<uint8> & Out);
+
+  private:
+	bool Initialize(int32 Level);
+
+	// z_stream, kept opaque so zlib headers stay out of the writer
+	struct FState;
+	FState * State;
+	int32    CurrentLevel;
+};
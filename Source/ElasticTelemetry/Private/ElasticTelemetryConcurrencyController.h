@@ -0,0 +1,138 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+
+/// <summary>
+/// AIMD (additive increase, multiplicative decrease) controller for the number of requests a writer keeps in flight.
+///
+/// A dedicated server next to the cluster can keep dozens of requests in flight, a player on a poor home connection
+/// only a couple before latency climbs. Every successful completion grows the limit by 1/limit, so roughly one extra
+/// request per round trip while latency stays near its baseline. A 429, a 503, or a completion slower than
+/// LatencyTolerance times the baseline halves it, at most once per round trip so a burst of throttled responses to
+/// requests that were already in flight counts as a single signal. The limit never leaves [Floor, Ceiling].
+///
+/// The baseline is a slow moving average of latency, the signal a fast one. Connection failures are left to the
+/// circuit breaker, they say nothing about how much load the server can take.
+///
+/// Called from HTTP completions, which may run on any thread.
+/// </summary>
+class FElasticTelemetryConcurrencyController
+{
+  public:
+	enum class EOutcome : uint8
+	{
+		Success,   // any response that says the server is keeping up, including a rejected body
+		Throttled, // 429 or 503, the server asked us to slow down
+		Failed     // no response at all
+	};
+
+	FElasticTelemetryConcurrencyController()
+	    : bEnabled(false)
+	    , Floor(1)
+	    , Ceiling(1)
+	    , Window(1.0)
+	    , BaselineLatency(0.0)
+	    , SmoothedLatency(0.0)
+	    , NextDecreaseTime(0.0)
+	    , Decreases(0)
+	{
+	}
+
+	/// <param name="bInEnabled">When false the limit stays at InitialLimit.</param>
+	void Configure(const bool bInEnabled, const int32 InitialLimit, const int32 InFloor, const int32 InCeiling)
+	{
+		FScopeLock Lock(&Mutex);
+		bEnabled = bInEnabled;
+		Floor    = FMath::Max(1, InFloor);
+		Ceiling  = FMath::Max(Floor, InCeiling);
+		Window   = bEnabled ? FMath::Clamp<double>(InitialLimit, Floor, Ceiling) : FMath::Max(1, InitialLimit);
+	}
+
+	/// <param name="LatencySeconds">From the request being handed to the HTTP module to its completion.</param>
+	/// <param name="Now">FPlatformTime::Seconds()</param>
+	/// <returns>The in-flight limit to use from now on.</returns>
+	int32 OnRequestComplete(const double LatencySeconds, const EOutcome Outcome, const double Now)
+	{
+		FScopeLock Lock(&Mutex);
+		if (!bEnabled || Outcome == EOutcome::Failed)
+			return GetLimitLocked();
+
+		bool bSpike = false;
+		if (Outcome == EOutcome::Success)
+		{
+			if (BaselineLatency <= 0.0)
+			{
+				BaselineLatency = LatencySeconds;
+				SmoothedLatency = LatencySeconds;
+			}
+			SmoothedLatency += (LatencySeconds - SmoothedLatency) * FastSmoothing;
+			bSpike = SmoothedLatency > BaselineLatency * LatencyTolerance;
+
+			// a spike must not drag the baseline up with it, or sustained overload would become the new normal
+			if (!bSpike)
+				BaselineLatency += (LatencySeconds - BaselineLatency) * SlowSmoothing;
+		}
+
+		if (Outcome == EOutcome::Throttled || bSpike)
+		{
+			if (Now >= NextDecreaseTime)
+			{
+				Window           = FMath::Max<double>(Floor, Window * DecreaseFactor);
+				NextDecreaseTime = Now + FMath::Max(SmoothedLatency, MinimumDecreaseIntervalSeconds);
+				++Decreases;
+			}
+		}
+		else
+		{
+			Window = FMath::Min<double>(Ceiling, Window + 1.0 / Window);
+		}
+		return GetLimitLocked();
+	}
+
+	int32 GetLimit() const
+	{
+		FScopeLock Lock(&Mutex);
+		return GetLimitLocked();
+	}
+
+	double GetSmoothedLatency() const
+	{
+		FScopeLock Lock(&Mutex);
+		return SmoothedLatency;
+	}
+
+	double GetBaselineLatency() const
+	{
+		FScopeLock Lock(&Mutex);
+		return BaselineLatency;
+	}
+
+	uint64 GetDecreases() const
+	{
+		FScopeLock Lock(&Mutex);
+		return Decreases;
+	}
+
+	static constexpr double LatencyTolerance               = 2.0;
+	static constexpr double DecreaseFactor                 = 0.5;
+	static constexpr double FastSmoothing                  = 0.3;
+	static constexpr double SlowSmoothing                  = 0.02;
+	static constexpr double MinimumDecreaseIntervalSeconds = 0.05;
+
+  private:
+	inline int32 GetLimitLocked() const { return FMath::Max(1, FMath::FloorToInt32(Window)); }
+
+	mutable FCriticalSection Mutex;
+	bool                     bEnabled;
+	int32                    Floor;
+	int32                    Ceiling;
+	double                   Window;
+	double                   BaselineLatency;
+	double                   SmoothedLatency;
+	double                   NextDecreaseTime;
+	uint64                   Decreases;
+};
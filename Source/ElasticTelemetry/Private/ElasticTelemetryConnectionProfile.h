@@ -0,0 +1,233 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryEndpointPool.h"
+#include "ElasticTelemetryIndexName.h"
+#include "ElasticTelemetryTransport.h"
+#include "Misc/Base64.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+using FElasticTelemetryEndpointPoolRef = TSharedRef<FElasticTelemetryEndpointPool, ESPMode::ThreadSafe>;
+
+/// <summary>
+/// Everything about an ElasticSearch cluster that every request needs, resolved once. Immutable after it is built,
+/// a new one replaces it whenever the endpoints, index, credentials or transport change.
+/// </summary>
+struct FElasticTelemetryConnectionProfile
+{
+	uint64                           Version = 0;
+	FString                          IndexName; // resolved, see FElasticTelemetryIndexName
+	FElasticTelemetryEndpointPoolRef Endpoints;
+	FElasticTelemetryTransportRef    Transport;
+	TArray<TPair<FString, FString>>  Headers;     // sent with every request, Content-Type aside
+	bool                             bDataStream; // create only, in _bulk action lines and _doc requests
+
+	FElasticTelemetryConnectionProfile(const uint64 InVersion, const FString & InIndexName,
+	    FElasticTelemetryEndpointPoolRef InEndpoints, FElasticTelemetryTransportRef InTransport,
+	    const FString & Username, const FString & Password, const bool bInDataStream)
+	    : Version(InVersion)
+	    , IndexName(InIndexName)
+	    , Endpoints(InEndpoints)
+	    , Transport(InTransport)
+	    , bDataStream(bInDataStream)
+	{
+		Headers.Emplace(TEXT("User-Agent"), TEXT("X-UnrealEngine-Agent"));
+		Headers.Emplace(TEXT("Authorization"), TEXT("Basic ") + FBase64::Encode(Username + ":" + Password));
+	}
+};
+
+/// <summary>
+/// Hands the current connection profile from whichever thread configures the writer to the workers that send.
+///
+/// Publish() builds the profile up front, so the per-request path does no string building or Base64 encoding.
+/// Get() is one atomic load of the version while nothing changes, the lock is only taken on the send after a
+/// reconfiguration to pick the new profile up. Profiles are reference counted, a request built from an old one
+/// keeps it alive until it is sent.
+///
+/// Nodes found through _nodes/http discovery replace the configured endpoints until the configuration changes, the
+/// configured ones only seed discovery.
+///
+/// An index name with date fields is resolved when it is published, and again by RollIndex() once the day is over.
+/// The check in between is a single atomic load.
+/// </summary>
+class FElasticTelemetryConnection
+{
+  public:
+	using FProfileRef = TSharedRef<const FElasticTelemetryConnectionProfile, ESPMode::ThreadSafe>;
+
+	FElasticTelemetryConnection()
+	    : InitialBackoffSeconds(1.0)
+	    , MaxBackoffSeconds(60.0)
+	    , Transport(MakeShared<FElasticTelemetryHttpTransport, ESPMode::ThreadSafe>())
+	    , bDataStream(false)
+	    , NextRollover(TNumericLimits<double>::Max())
+	    , PublishedVersion(0)
+	    , Published(BuildLocked(0))
+	{
+	}
+
+	/// <summary>
+	/// Any thread.
+	/// </summary>
+	/// <param name="EndpointURLs">One or more URLs, see FElasticTelemetryEndpointPool::ParseEndpointList().</param>
+	/// <param name="InIndexPattern">Index name, may have date fields, see FElasticTelemetryIndexName.</param>
+	void Publish(const FString & EndpointURLs, const FString & InIndexPattern, const FString & InUsername,
+	    const FString & InPassword)
+	{
+		FScopeLock Lock(&Mutex);
+		ConfiguredURLs = FElasticTelemetryEndpointPool::ParseEndpointList(EndpointURLs);
+		IndexPattern   = InIndexPattern;
+		IndexName      = ResolveIndexLocked();
+		Username       = InUsername;
+		Password       = InPassword;
+		DiscoveredURLs.Reset();
+		PublishLocked();
+	}
+
+	/// <summary>
+	/// Any thread, before sending. Publishes a profile for the next index once the day in the index name is over.
+	/// </summary>
+	/// <param name="Now">FPlatformTime::Seconds()</param>
+	/// <returns>true if the index changed.</returns>
+	bool RollIndex(const double Now)
+	{
+		if (Now < NextRollover.load(std::memory_order_relaxed))
+			return false;
+
+		FScopeLock    Lock(&Mutex);
+		const FString Resolved = ResolveIndexLocked();
+		if (Resolved == IndexName)
+			return false;
+
+		IndexName = Resolved;
+		PublishLocked();
+		return true;
+	}
+
+	/// <summary>
+	/// Any thread. Data streams only accept documents with op_type create.
+	/// </summary>
+	void SetDataStream(const bool bInDataStream)
+	{
+		FScopeLock Lock(&Mutex);
+		if (bDataStream == bInDataStream)
+			return;
+
+		bDataStream = bInDataStream;
+		PublishLocked();
+	}
+
+	/// <summary>
+	/// Any thread, typically the completion of a _nodes/http request. An empty list keeps the current endpoints.
+	/// </summary>
+	void PublishDiscovered(TArray<FString> && BaseURLs)
+	{
+		FScopeLock Lock(&Mutex);
+		BaseURLs.Sort();
+		if (BaseURLs.Num() == 0 || BaseURLs == DiscoveredURLs)
+			return;
+
+		DiscoveredURLs = MoveTemp(BaseURLs);
+		PublishLocked();
+	}
+
+	/// <summary>
+	/// Any thread. Requests already sent complete through the transport they were sent with.
+	/// </summary>
+	void SetTransport(FElasticTelemetryTransportRef InTransport)
+	{
+		FScopeLock Lock(&Mutex);
+		Transport = InTransport;
+		PublishLocked();
+	}
+
+	/// <summary>
+	/// Any thread. Applies to the nodes of the current profile straight away.
+	/// </summary>
+	void SetBackoff(const double InInitialBackoffSeconds, const double InMaxBackoffSeconds)
+	{
+		FScopeLock Lock(&Mutex);
+		InitialBackoffSeconds = InInitialBackoffSeconds;
+		MaxBackoffSeconds     = InMaxBackoffSeconds;
+		Published->Endpoints->SetBackoff(InitialBackoffSeconds, MaxBackoffSeconds);
+	}
+
+	/// <summary>
+	/// Any worker thread. Cached belongs to the calling thread, it is replaced when a newer profile has been published.
+	/// </summary>
+	const FProfileRef & Get(FProfileRef & Cached) const
+	{
+		if (PublishedVersion.load(std::memory_order_acquire) != Cached->Version)
+		{
+			FScopeLock Lock(&Mutex);
+			Cached = Published;
+		}
+		return Cached;
+	}
+
+	/// <summary>
+	/// Any thread, for stats.
+	/// </summary>
+	FProfileRef GetPublished() const
+	{
+		FScopeLock Lock(&Mutex);
+		return Published;
+	}
+
+	inline uint64 GetVersion() const { return PublishedVersion.load(std::memory_order_relaxed); }
+
+  private:
+	FProfileRef BuildLocked(const uint64 Version) const
+	{
+		// the first profile is built by the constructor, before there is a previous one to carry health over from
+		const FElasticTelemetryEndpointPool * Previous = Version > 0 ? &Published->Endpoints.Get() : nullptr;
+		const TArray<FString> &               URLs     = DiscoveredURLs.Num() > 0 ? DiscoveredURLs : ConfiguredURLs;
+
+		FElasticTelemetryEndpointPoolRef Pool = MakeShared<FElasticTelemetryEndpointPool, ESPMode::ThreadSafe>(
+		    URLs, IndexName, Previous, InitialBackoffSeconds, MaxBackoffSeconds, bDataStream);
+		return MakeShared<FElasticTelemetryConnectionProfile, ESPMode::ThreadSafe>(
+		    Version, IndexName, Pool, Transport, Username, Password, bDataStream);
+	}
+
+	// The index name for today, and when to look at it again. The rollover is kept on the FPlatformTime clock the
+	// writer already reads, rather than asking for the calendar date on every send.
+	FString ResolveIndexLocked()
+	{
+		if (!FElasticTelemetryIndexName::HasDateFields(IndexPattern))
+		{
+			NextRollover.store(TNumericLimits<double>::Max(), std::memory_order_relaxed);
+			return IndexPattern;
+		}
+
+		const FDateTime UtcNow  = FDateTime::UtcNow();
+		const double    Seconds = (FElasticTelemetryIndexName::GetNextRollover(UtcNow) - UtcNow).GetTotalSeconds();
+		NextRollover.store(FPlatformTime::Seconds() + Seconds, std::memory_order_relaxed);
+		return FElasticTelemetryIndexName::Resolve(IndexPattern, UtcNow);
+	}
+
+	void PublishLocked()
+	{
+		const uint64 Version = PublishedVersion.load(std::memory_order_relaxed) + 1;
+		Published            = BuildLocked(Version);
+		PublishedVersion.store(Version, std::memory_order_release);
+	}
+
+	mutable FCriticalSection      Mutex;
+	TArray<FString>               ConfiguredURLs;        // under Mutex
+	TArray<FString>               DiscoveredURLs;        // under Mutex
+	FString                       IndexPattern;          // under Mutex
+	FString                       IndexName;             // under Mutex, IndexPattern resolved
+	FString                       Username;              // under Mutex
+	FString                       Password;              // under Mutex
+	double                        InitialBackoffSeconds; // under Mutex
+	double                        MaxBackoffSeconds;     // under Mutex
+	FElasticTelemetryTransportRef Transport;             // under Mutex
+	bool                          bDataStream;           // under Mutex
+	std::atomic<double>           NextRollover;          // FPlatformTime::Seconds() the index name is due to change
+	std::atomic<uint64>           PublishedVersion;
+	FProfileRef                   Published;             // under Mutex
+};
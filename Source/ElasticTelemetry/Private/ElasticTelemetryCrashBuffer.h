@@ -0,0 +1,203 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryBulkBuilder.h"
+#include <string_view>
+
+/// <summary>
+/// Memory reserved up front for the crash path, see IElasticTelemetryWriter::FlushForCrash().
+///
+/// By the time a fatal error is logged the heap may be what is broken, so nothing here allocates once Reserve() has
+/// run. Queued lines are added oldest first and only the newest MaxLines that fit in MaxBytes are kept, in a ring.
+/// BuildBulkBody() then lays them out as a _bulk body, followed by the fatal line and the crash report. Lines are
+/// compacted on the way in, as FElasticTelemetryBulkBuilder does, so each takes exactly one line of the body.
+///
+/// Used by one crashing thread at a time. Not thread safe.
+/// </summary>
+class FElasticTelemetryCrashBuffer
+{
+  public:
+	FElasticTelemetryCrashBuffer()
+	    : Ring()
+	    , Lines()
+	    , Body()
+	    , MaxLastBytes(0)
+	    , Head(0)
+	    , Count(0)
+	    , WriteOffset(0)
+	    , UsedBytes(0)
+	{
+	}
+
+	/// <summary>
+	/// Allocates everything the crash path will need. Not on the crash path.
+	/// </summary>
+	/// <param name="MaxLines">Queued lines kept, the newest ones.</param>
+	/// <param name="MaxBytes">Bound on the bytes of the lines kept.</param>
+	/// <param name="InMaxLastBytes">Bound on each last line once compacted, a longer one is cut short.</param>
+	void Reserve(const int32 MaxLines, const int32 MaxBytes, const int32 InMaxLastBytes)
+	{
+		Ring.SetNumUninitialized(FMath::Max(0, MaxBytes));
+		Lines.SetNumUninitialized(FMath::Max(0, MaxLines));
+		MaxLastBytes = FMath::Max(0, InMaxLastBytes);
+
+		// every line, and the last two, with the longer action line and its newline
+		const int32 PerLine = static_cast<int32>(MaxActionLineBytes) + 1;
+		Body.Reserve(Ring.Num() + MaxLastBytes * MaxLast + (Lines.Num() + MaxLast) * PerLine);
+		Reset();
+	}
+
+	inline bool IsReserved() const { return Lines.Num() > 0 || MaxLastBytes > 0; }
+
+	void Reset()
+	{
+		Head        = 0;
+		Count       = 0;
+		WriteOffset = 0;
+		UsedBytes   = 0;
+		Body.Reset();
+	}
+
+	/// <summary>
+	/// Keeps Line, compacted, pushing out the oldest lines to make room. A line larger than MaxBytes on its own is
+	/// skipped.
+	/// </summary>
+	void AddLine(const std::string_view & Line)
+	{
+		const bool bSingleLine = IsSingleLineJson(Line);
+		int32      Size        = 0;
+		if (bSingleLine)
+			Size = static_cast<int32>(FMath::Min<size_t>(Line.size(), MAX_int32));
+		else
+			ForEachCompactJsonByte(Line, [&Size](const char) { ++Size; });
+		if (Lines.Num() == 0 || Size == 0 || Size > Ring.Num())
+			return;
+
+		while (Count == Lines.Num() || UsedBytes + Size > Ring.Num())
+		{
+			UsedBytes -= Lines[Head].Size;
+			Head = (Head + 1) % Lines.Num();
+			--Count;
+		}
+
+		// lines are stored back to back, wrapping around the end of the ring
+		uint8 * const Data  = Ring.GetData();
+		const int32   Num   = Ring.Num();
+		int32         Write = WriteOffset;
+		if (bSingleLine)
+		{
+			const int32 First = FMath::Min(Size, Num - Write);
+			FMemory::Memcpy(Data + Write, Line.data(), First);
+			FMemory::Memcpy(Data, Line.data() + First, Size - First);
+		}
+		else
+		{
+			ForEachCompactJsonByte(Line, [Data, Num, &Write](const char c) {
+				Data[Write] = static_cast<uint8>(c);
+				Write       = Write + 1 == Num ? 0 : Write + 1;
+			});
+		}
+
+		Lines[(Head + Count) % Lines.Num()] = {WriteOffset, Size};
+		WriteOffset = (WriteOffset + Size) % Ring.Num();
+		UsedBytes += Size;
+		++Count;
+	}
+
+	/// <summary>
+	/// The kept lines oldest first, then Last, each after ActionLine. Valid until the next call.
+	/// </summary>
+	TArrayView<const uint8> BuildBulkBody(const std::string_view & ActionLine, const std::string_view & Last)
+	{
+		return BuildBulkBody(ActionLine, std::string_view(), Last);
+	}
+
+	/// <summary>
+	/// The kept lines oldest first, then Fatal and Last when they are not empty, each after ActionLine.
+	/// </summary>
+	TArrayView<const uint8> BuildBulkBody(
+	    const std::string_view & ActionLine, const std::string_view & Fatal, const std::string_view & Last)
+	{
+		Body.Reset();
+		if (ActionLine.size() > MaxActionLineBytes)
+			return Body;
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const FLine & Line  = Lines[(Head + i) % Lines.Num()];
+			const int32   First = FMath::Min(Line.Size, Ring.Num() - Line.Offset);
+			AppendBytes(ActionLine.data(), static_cast<int32>(ActionLine.size()));
+			AppendBytes(Ring.GetData() + Line.Offset, First);
+			AppendBytes(Ring.GetData(), Line.Size - First);
+			AppendBytes("\n", 1);
+		}
+
+		AppendLast(ActionLine, Fatal);
+		AppendLast(ActionLine, Last);
+		return Body;
+	}
+
+	inline int32 GetLineCount() const { return Count; }
+
+	/// <summary>
+	/// What Reserve() allocated, which the crash path never changes.
+	/// </summary>
+	inline SIZE_T GetAllocatedSize() const
+	{
+		return Ring.GetAllocatedSize() + Lines.GetAllocatedSize() + Body.GetAllocatedSize();
+	}
+
+	// {"create":{}} plus its newline, the longer of the two _bulk action lines
+	static constexpr size_t MaxActionLineBytes = 14;
+
+	// the fatal line and the crash report
+	static constexpr int32 MaxLast = 2;
+
+  private:
+	struct FLine
+	{
+		int32 Offset;
+		int32 Size;
+	};
+
+	void AppendLast(const std::string_view & ActionLine, const std::string_view & Last)
+	{
+		if (Last.empty())
+			return;
+
+		int32 Remaining = MaxLastBytes;
+		AppendBytes(ActionLine.data(), static_cast<int32>(ActionLine.size()));
+		if (IsSingleLineJson(Last))
+		{
+			AppendBytes(Last.data(), static_cast<int32>(FMath::Min<size_t>(Last.size(), Remaining)));
+		}
+		else
+		{
+			ForEachCompactJsonByte(Last, [this, &Remaining](const char c) {
+				if (Remaining-- > 0)
+					AppendBytes(&c, 1);
+			});
+		}
+		AppendBytes("\n", 1);
+	}
+
+	void AppendBytes(const void * Data, const int32 Size)
+	{
+		// never grow, a body that does not fit is cut short
+		const int32 Fits = FMath::Min(Size, Body.Max() - Body.Num());
+		if (Fits > 0)
+			Body.Append(static_cast<const uint8 *>(Data), Fits);
+	}
+
+	TArray<uint8> Ring;
+	TArray<FLine> Lines; // a ring of Count lines starting at Head
+	TArray<uint8> Body;
+	int32         MaxLastBytes;
+	int32         Head;
+	int32         Count;
+	int32         WriteOffset;
+	int32         UsedBytes;
+};
@@ -0,0 +1,218 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryCrashHandler.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryWriter.h"
+#include "Misc/CoreDelegates.h"
+
+namespace
+{
+	// Appends to a fixed buffer and remembers when something did not fit, nothing here allocates. Without a buffer it
+	// only counts.
+	struct FAnsiOut
+	{
+		ANSICHAR * Data;
+		int32      Capacity;
+		int32      Num;
+		bool       bOverflow;
+
+		void Append(const ANSICHAR * Text, const int32 Size)
+		{
+			if (bOverflow || Num + Size > Capacity)
+			{
+				bOverflow = true;
+				return;
+			}
+			if (Data)
+				FMemory::Memcpy(Data + Num, Text, Size);
+			Num += Size;
+		}
+
+		void Append(const ANSICHAR * Text) { Append(Text, FCStringAnsi::Strlen(Text)); }
+
+		void Append(const ANSICHAR Char) { Append(&Char, 1); }
+
+		void AppendDigits(int32 Value, const int32 Width)
+		{
+			ANSICHAR Digits[16];
+			for (int32 i = Width - 1; i >= 0; --i, Value /= 10)
+				Digits[i] = static_cast<ANSICHAR>('0' + Value % 10);
+			Append(Digits, Width);
+		}
+
+		void AppendCodePoint(const uint32 CodePoint)
+		{
+			static const ANSICHAR Hex[] = "0123456789abcdef";
+			switch (CodePoint)
+			{
+			case '"':
+				return Append("\\\"", 2);
+			case '\\':
+				return Append("\\\\", 2);
+			case '\n':
+				return Append("\\n", 2);
+			case '\r':
+				return Append("\\r", 2);
+			case '\t':
+				return Append("\\t", 2);
+			default:
+				break;
+			}
+
+			if (CodePoint < 0x20)
+			{
+				const ANSICHAR Escaped[] = {'\\', 'u', '0', '0', Hex[CodePoint >> 4], Hex[CodePoint & 0xF]};
+				Append(Escaped, 6);
+			}
+			else if (CodePoint < 0x80)
+			{
+				Append(static_cast<ANSICHAR>(CodePoint));
+			}
+			else if (CodePoint < 0x800)
+			{
+				const ANSICHAR Encoded[] = {
+				    static_cast<ANSICHAR>(0xC0 | (CodePoint >> 6)), static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F))};
+				Append(Encoded, 2);
+			}
+			else if (CodePoint < 0x10000)
+			{
+				const ANSICHAR Encoded[] = {static_cast<ANSICHAR>(0xE0 | (CodePoint >> 12)),
+				    static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)),
+				    static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F))};
+				Append(Encoded, 3);
+			}
+			else
+			{
+				const ANSICHAR Encoded[] = {static_cast<ANSICHAR>(0xF0 | (CodePoint >> 18)),
+				    static_cast<ANSICHAR>(0x80 | ((CodePoint >> 12) & 0x3F)),
+				    static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)),
+				    static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F))};
+				Append(Encoded, 4);
+			}
+		}
+
+		// The inside of a JSON string, UTF-8 encoded. A lone surrogate becomes U+FFFD. A character or escape goes in
+		// whole or not at all, and nothing after one that did not fit.
+		void AppendEscaped(const TCHAR * Text)
+		{
+			for (; *Text && !bOverflow; ++Text)
+			{
+				uint32 CodePoint = static_cast<uint32>(*Text);
+				if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && Text[1] >= 0xDC00 && Text[1] <= 0xDFFF)
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (static_cast<uint32>(Text[1]) - 0xDC00);
+					++Text;
+				}
+				else if ((CodePoint >= 0xD800 && CodePoint <= 0xDFFF) || CodePoint > 0x10FFFF)
+				{
+					CodePoint = 0xFFFD;
+				}
+				AppendCodePoint(CodePoint);
+			}
+		}
+
+		void AppendString(const TCHAR * Text)
+		{
+			Append('"');
+			AppendEscaped(Text);
+			Append('"');
+		}
+
+		// Herald's timestamp layout, in UTC
+		void AppendTimestamp(const FDateTime & Utc)
+		{
+			Append('"');
+			AppendDigits(Utc.GetYear(), 4);
+			Append('-');
+			AppendDigits(Utc.GetMonth(), 2);
+			Append('-');
+			AppendDigits(Utc.GetDay(), 2);
+			Append('T');
+			AppendDigits(Utc.GetHour(), 2);
+			Append(':');
+			AppendDigits(Utc.GetMinute(), 2);
+			Append(':');
+			AppendDigits(Utc.GetSecond(), 2);
+			Append('.');
+			AppendDigits(Utc.GetMillisecond(), 3);
+			Append("+0000\"");
+		}
+	};
+
+	// Everything in the crash document after the message, from its closing quote on
+	void AppendTail(FAnsiOut & Doc, const TCHAR * Category, const FDateTime & Utc, const FAnsiStringView & Headers)
+	{
+		Doc.Append("\",\"Category\":");
+		Doc.AppendString(Category);
+		Doc.Append(",\"Verbosity\":\"Fatal\"},");
+		Doc.Append(Headers.GetData(), Headers.Len());
+		Doc.Append(",\"timestamp\":");
+		Doc.AppendTimestamp(Utc);
+		Doc.Append('}');
+	}
+} // namespace
+
+FElasticTelemetryCrashHandler::FElasticTelemetryCrashHandler(Herald::ILogTransformerPtr InLogTransformer,
+    Herald::ILogWriterPtr InLogWriter, Herald::ILogWriterPtr InEventWriter)
+    : LogTransformer(MoveTemp(InLogTransformer))
+    , LogWriter(MoveTemp(InLogWriter))
+    , EventWriter(MoveTemp(InEventWriter))
+    , Document()
+{
+	Document.SetNumUninitialized(DocumentMaxBytes);
+	SystemErrorHandle =
+	    FCoreDelegates::OnHandleSystemError.AddRaw(this, &FElasticTelemetryCrashHandler::HandleSystemError);
+}
+
+FElasticTelemetryCrashHandler::~FElasticTelemetryCrashHandler()
+{
+	FCoreDelegates::OnHandleSystemError.Remove(SystemErrorHandle);
+}
+
+int32 FElasticTelemetryCrashHandler::FormatDocument(ANSICHAR * Out, const int32 Capacity, const TCHAR * Message,
+    const TCHAR * Category, const FDateTime & Utc, const FAnsiStringView & Headers)
+{
+	// Herald's JSON transformer layout, with the metadata the output device adds to UE_LOG lines
+	FAnsiOut Tail{nullptr, MAX_int32, 0, false};
+	AppendTail(Tail, Category, Utc, Headers);
+
+	FAnsiOut Doc{Out, Capacity, 0, false};
+	Doc.Append("{\"log\":{\"level\":\"Fatal\",\"message\":\"");
+	if (!Doc.bOverflow && Tail.Num <= Capacity - Doc.Num)
+	{
+		// a message too long for the buffer, a callstack most likely, is cut where the rest still fits
+		Doc.Capacity = Capacity - Tail.Num;
+		Doc.AppendEscaped(Message);
+		Doc.Capacity  = Capacity;
+		Doc.bOverflow = false;
+	}
+	AppendTail(Doc, Category, Utc, Headers);
+	return Doc.bOverflow ? 0 : Doc.Num;
+}
+
+void FElasticTelemetryCrashHandler::HandleSystemError()
+{
+	// GErrorHist holds the assert or fatal error message, and the callstack once the crash reporter has added it
+	const TCHAR * Message = GErrorHist[0] ? GErrorHist : TEXT("Unknown crash");
+
+	// the headers every line carries right now, escaped once already and shared rather than copied
+	static const ANSICHAR                    NoHeaders[] = "\"headers\":{}";
+	const std::shared_ptr<const std::string> Fragment =
+	    LogTransformer ? AsElasticTelemetryJsonTransformer(LogTransformer)->GetHeaderFragment() : nullptr;
+	const FAnsiStringView Headers = Fragment
+	                                    ? FAnsiStringView(Fragment->data(), static_cast<int32>(Fragment->size()))
+	                                    : FAnsiStringView(NoHeaders, UE_ARRAY_COUNT(NoHeaders) - 1);
+
+	const int32 Size = FormatDocument(
+	    Document.GetData(), Document.Num(), Message, TEXT("Crash"), FDateTime::UtcNow(), Headers);
+
+	if (LogWriter)
+	{
+		AsElasticTelemetryWriter(LogWriter)->FlushForCrash(std::string_view(Document.GetData(), Size));
+	}
+	if (EventWriter)
+	{
+		AsElasticTelemetryWriter(EventWriter)->FlushForCrash(std::string_view());
+	}
+}
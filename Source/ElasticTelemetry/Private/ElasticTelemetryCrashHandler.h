@@ -0,0 +1,44 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Herald/ILogTransformer.hpp"
+#include "Herald/ILogWriter.hpp"
+
+/// <summary>
+/// Writes what the writers still hold to the spool when the engine reports a crash, see
+/// IElasticTelemetryWriter::FlushForCrash(). The crash report itself goes out as a Fatal line with the "Crash"
+/// category, formatted into memory reserved here by the constructor. Nothing is sent, the next launch replays it.
+///
+/// Lives from StartupModule to ShutdownModule. The crash document carries the log transformer's headers as they are
+/// when the crash happens, see FElasticTelemetryJsonTransformer::GetHeaderFragment().
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryCrashHandler
+{
+  public:
+	FElasticTelemetryCrashHandler(Herald::ILogTransformerPtr InLogTransformer, Herald::ILogWriterPtr InLogWriter,
+	    Herald::ILogWriterPtr InEventWriter);
+	~FElasticTelemetryCrashHandler();
+
+	/// <summary>
+	/// Formats a Fatal log document into Out without allocating. A message too long for Capacity is cut at a whole
+	/// character, so the document stays valid JSON.
+	/// </summary>
+	/// <param name="Headers">The "headers":{..} member, already escaped.</param>
+	/// <returns>Bytes written, 0 when the document does not fit in Capacity even with an empty message.</returns>
+	static int32 FormatDocument(ANSICHAR * Out, int32 Capacity, const TCHAR * Message, const TCHAR * Category,
+	    const FDateTime & Utc, const FAnsiStringView & Headers);
+
+	static constexpr int32 DocumentMaxBytes = 64 * 1024;
+
+  private:
+	void HandleSystemError();
+
+	Herald::ILogTransformerPtr LogTransformer;
+	Herald::ILogWriterPtr      LogWriter;
+	Herald::ILogWriterPtr      EventWriter;
+	TArray<ANSICHAR>           Document;
+	FDelegateHandle            SystemErrorHandle;
+};
@@ -0,0 +1,169 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryEndpointPool.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+FElasticTelemetryEndpointPool::FElasticTelemetryEndpointPool(const TArray<FString> & BaseURLs,
+    const FString & IndexName, const FElasticTelemetryEndpointPool * Previous, const double InitialBackoffSeconds,
+    const double MaxBackoffSeconds, const bool bDataStream)
+    : Endpoints()
+    , Cursor(0)
+{
+	TArray<FString> URLs = BaseURLs;
+	if (URLs.Num() == 0)
+		URLs.Add(FString());
+
+	for (const FString & URL : URLs)
+	{
+		const FString DocumentURL = URL + IndexName + (bDataStream ? TEXT("/_doc?op_type=create") : TEXT("/_doc"));
+
+		// a node that is down stays down across a reconfiguration, as long as requests still go to the same node
+		const FElasticTelemetryEndpointRef * Existing = nullptr;
+		for (int32 i = 0; Previous && !Existing && i < Previous->Endpoints.Num(); ++i)
+		{
+			if (Previous->Endpoints[i]->BaseURL == URL)
+				Existing = &Previous->Endpoints[i];
+		}
+		if (Existing && (*Existing)->DocumentURL == DocumentURL)
+		{
+			Endpoints.Add(*Existing);
+			continue;
+		}
+
+		FElasticTelemetryEndpointRef Endpoint = MakeShared<FElasticTelemetryEndpoint, ESPMode::ThreadSafe>();
+		Endpoint->BaseURL     = URL;
+		Endpoint->DocumentURL = DocumentURL;
+		Endpoint->BulkURL     = URL + IndexName + TEXT("/_bulk");
+		if (Existing)
+		{
+			// same node, another index, typically the next day's
+			Endpoint->Health.CarryOver((*Existing)->Health);
+		}
+		Endpoints.Add(MoveTemp(Endpoint));
+	}
+	SetBackoff(InitialBackoffSeconds, MaxBackoffSeconds);
+}
+
+FElasticTelemetryEndpointRef FElasticTelemetryEndpointPool::Pick(const double Now)
+{
+	const uint32 Count = static_cast<uint32>(Endpoints.Num());
+	const uint32 Start = Cursor.fetch_add(1, std::memory_order_relaxed);
+
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		const FElasticTelemetryEndpointRef & Endpoint = Endpoints[(Start + i) % Count];
+		if (Endpoint->Health.IsClosed())
+			return Endpoint;
+	}
+
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		const FElasticTelemetryEndpointRef & Endpoint = Endpoints[(Start + i) % Count];
+		if (Endpoint->Health.TryBeginProbe(Now))
+			return Endpoint;
+	}
+
+	const FElasticTelemetryEndpointRef * Soonest = &Endpoints[0];
+	for (const FElasticTelemetryEndpointRef & Endpoint : Endpoints)
+	{
+		if (Endpoint->Health.GetProbeTime() < (*Soonest)->Health.GetProbeTime())
+			Soonest = &Endpoint;
+	}
+	return *Soonest;
+}
+
+bool FElasticTelemetryEndpointPool::IsAvailable(const FElasticTelemetryEndpoint & Endpoint, const double Now)
+{
+	switch (Endpoint.Health.GetState())
+	{
+	case FElasticTelemetryCircuitBreaker::EState::Closed:
+		return true;
+	case FElasticTelemetryCircuitBreaker::EState::Open:
+		return Now >= Endpoint.Health.GetProbeTime();
+	default:
+		return false; // a probe is already in flight
+	}
+}
+
+bool FElasticTelemetryEndpointPool::HasAvailable(const double Now) const
+{
+	return Endpoints.ContainsByPredicate(
+	    [Now](const FElasticTelemetryEndpointRef & Endpoint) { return IsAvailable(*Endpoint, Now); });
+}
+
+int32 FElasticTelemetryEndpointPool::GetAvailableCount(const double Now) const
+{
+	int32 Available = 0;
+	for (const FElasticTelemetryEndpointRef & Endpoint : Endpoints)
+	{
+		if (IsAvailable(*Endpoint, Now))
+			++Available;
+	}
+	return Available;
+}
+
+void FElasticTelemetryEndpointPool::SetBackoff(const double InitialBackoffSeconds, const double MaxBackoffSeconds)
+{
+	for (const FElasticTelemetryEndpointRef & Endpoint : Endpoints)
+	{
+		Endpoint->Health.SetBackoff(InitialBackoffSeconds, MaxBackoffSeconds);
+	}
+}
+
+TArray<FString> FElasticTelemetryEndpointPool::ParseEndpointList(const FString & List)
+{
+	TArray<FString> Parts;
+	const TCHAR *   Delimiters[] = {TEXT(","), TEXT(";"), TEXT(" "), TEXT("\t"), TEXT("\r"), TEXT("\n")};
+	List.ParseIntoArray(Parts, Delimiters, UE_ARRAY_COUNT(Delimiters), true);
+
+	TArray<FString> URLs;
+	for (FString & Part : Parts)
+	{
+		if (Part[Part.Len() - 1] != '/')
+			Part += '/';
+		URLs.AddUnique(MoveTemp(Part));
+	}
+	return URLs;
+}
+
+bool FElasticTelemetryEndpointPool::ParseNodesHttp(
+    const FString & Json, const FString & Scheme, TArray<FString> & OutBaseURLs)
+{
+	// {"nodes":{"<id>":{"http":{"publish_address":"10.0.0.1:9200"}},"<id>":{"http":{"publish_address":
+	// "es-2.internal/10.0.0.2:9200"}}}}
+	TSharedPtr<FJsonObject>   Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		return false;
+
+	const TSharedPtr<FJsonObject> * Nodes = nullptr;
+	if (!Root->TryGetObjectField(TEXT("nodes"), Nodes))
+		return false;
+
+	for (const auto & Node : (*Nodes)->Values)
+	{
+		const TSharedPtr<FJsonObject> * NodeObject = nullptr;
+		const TSharedPtr<FJsonObject> * Http       = nullptr;
+		FString                         Address;
+		if (!Node.Value->TryGetObject(NodeObject) || !(*NodeObject)->TryGetObjectField(TEXT("http"), Http) ||
+		    !(*Http)->TryGetStringField(TEXT("publish_address"), Address) || Address.IsEmpty())
+		{
+			continue;
+		}
+
+		// "host/ip:port" when the node has a host name. Prefer the name, TLS certificates are issued for it.
+		FString Host;
+		FString IpAndPort;
+		if (Address.Split(TEXT("/"), &Host, &IpAndPort))
+		{
+			FString Port;
+			IpAndPort.Split(TEXT(":"), nullptr, &Port, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+			Address = Host + TEXT(":") + Port;
+		}
+		OutBaseURLs.AddUnique(Scheme + TEXT("://") + Address + TEXT("/"));
+	}
+	return true;
+}
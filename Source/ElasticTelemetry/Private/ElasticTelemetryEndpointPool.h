@@ -0,0 +1,81 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryCircuitBreaker.h"
+#include <atomic>
+
+/// <summary>
+/// One ElasticSearch node a writer can send to, with its own health. A node that fails is marked down and probed
+/// again after a backoff, exactly like the writer's circuit breaker but per node.
+/// </summary>
+struct FElasticTelemetryEndpoint
+{
+	FString                         BaseURL; // always ends with a slash
+	FString                         DocumentURL;
+	FString                         BulkURL;
+	FElasticTelemetryCircuitBreaker Health;
+};
+
+using FElasticTelemetryEndpointRef = TSharedRef<FElasticTelemetryEndpoint, ESPMode::ThreadSafe>;
+
+/// <summary>
+/// The set of nodes a writer spreads its requests over.
+///
+/// Clusters without a load balancer in front of them expose several coordinating or ingest nodes, and sending every
+/// request to the first one turns it into a hot spot. Requests go round-robin over healthy nodes. A node that fails
+/// with a retryable error is skipped until its backoff elapses, then gets a single probe request, and the writer only
+/// stops sending altogether once every node is down.
+///
+/// The list itself is immutable once built, a new pool replaces it when the configuration or node discovery changes
+/// it. Nodes that are in both keep their health. Node health is atomic, so completions update it from any thread.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryEndpointPool
+{
+  public:
+	/// <param name="BaseURLs">Node URLs, a pool always has at least one node even if this is empty.</param>
+	/// <param name="Previous">Pool being replaced, nodes with the same URL carry their health over.</param>
+	/// <param name="bDataStream">IndexName is a data stream, single documents are sent with op_type=create.</param>
+	FElasticTelemetryEndpointPool(const TArray<FString> & BaseURLs, const FString & IndexName,
+	    const FElasticTelemetryEndpointPool * Previous, double InitialBackoffSeconds, double MaxBackoffSeconds,
+	    bool bDataStream = false);
+
+	/// <summary>
+	/// Next node to send to. Healthy nodes take turns. Failing that, a node whose backoff has elapsed is moved to
+	/// half-open for a probe. Failing that, every node is down and the writer's circuit breaker is probing, so the
+	/// node that is due back first is used.
+	/// </summary>
+	FElasticTelemetryEndpointRef Pick(double Now);
+
+	/// <summary>
+	/// Whether any node is healthy or due a probe. Any thread.
+	/// </summary>
+	bool HasAvailable(double Now) const;
+
+	int32 GetAvailableCount(double Now) const;
+
+	void SetBackoff(double InitialBackoffSeconds, double MaxBackoffSeconds);
+
+	inline const TArray<FElasticTelemetryEndpointRef> & GetEndpoints() const { return Endpoints; }
+
+	/// <summary>
+	/// Splits a list of URLs separated by commas, semicolons or whitespace, and adds the trailing slash the request
+	/// paths are appended to.
+	/// </summary>
+	static TArray<FString> ParseEndpointList(const FString & List);
+
+	/// <summary>
+	/// Reads node addresses from a GET _nodes/http response. Nodes without an HTTP publish address are skipped.
+	/// </summary>
+	/// <param name="Scheme">http or https, _nodes/http only reports host and port.</param>
+	/// <returns>false if Json is not a _nodes response.</returns>
+	static bool ParseNodesHttp(const FString & Json, const FString & Scheme, TArray<FString> & OutBaseURLs);
+
+  private:
+	static bool IsAvailable(const FElasticTelemetryEndpoint & Endpoint, double Now);
+
+	TArray<FElasticTelemetryEndpointRef> Endpoints;
+	std::atomic<uint32>                  Cursor;
+};
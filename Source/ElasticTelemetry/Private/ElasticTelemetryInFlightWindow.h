@@ -0,0 +1,117 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Event.h"
+#include <atomic>
+
+/// <summary>
+/// Bounds the number of HTTP requests a writer has outstanding at once.
+///
+/// Only the writer's worker thread acquires slots, so once it sees a free one nobody else can take it from under it.
+/// Completions release slots from whatever thread the HTTP module calls back on, and wake a waiting worker straight
+/// away instead of it polling. How often and how long the worker had to wait is recorded for the writer stats.
+/// </summary>
+class FElasticTelemetryInFlightWindow
+{
+  public:
+	explicit FElasticTelemetryInFlightWindow(const int32 InLimit)
+	    : InFlight(0)
+	    , Limit(FMath::Max(1, InLimit))
+	    , Peak(0)
+	    , Waits(0)
+	    , WaitCycles(0)
+	    , MaxWaitCycles(0)
+	    , bCancelled(false)
+	    , SlotFreed(FPlatformProcess::GetSynchEventFromPool(false))
+	{
+	}
+
+	~FElasticTelemetryInFlightWindow() { FPlatformProcess::ReturnSynchEventToPool(SlotFreed); }
+
+	FElasticTelemetryInFlightWindow(const FElasticTelemetryInFlightWindow &)             = delete;
+	FElasticTelemetryInFlightWindow & operator=(const FElasticTelemetryInFlightWindow &) = delete;
+
+	void SetLimit(const int32 InLimit)
+	{
+		const int32 NewLimit = FMath::Max(1, InLimit);
+		// a larger window may let a waiting worker through
+		if (Limit.exchange(NewLimit) < NewLimit)
+			SlotFreed->Trigger();
+	}
+
+	inline int32 GetLimit() const { return Limit.load(); }
+	inline int32 GetInFlight() const { return InFlight.load(); }
+	inline bool  HasFreeSlot() const { return InFlight.load() < Limit.load(); }
+
+	/// <summary>
+	/// Worker thread only. Blocks until a slot is free, or Cancel() is called.
+	/// </summary>
+	/// <returns>false if cancelled, no slot is taken in that case.</returns>
+	bool Acquire()
+	{
+		if (!HasFreeSlot())
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			while (!bCancelled && !HasFreeSlot())
+			{
+				SlotFreed->Wait();
+			}
+
+			const uint64 Waited = FPlatformTime::Cycles64() - StartCycles;
+			Waits.fetch_add(1, std::memory_order_relaxed);
+			WaitCycles.fetch_add(Waited, std::memory_order_relaxed);
+			if (Waited > MaxWaitCycles.load(std::memory_order_relaxed))
+				MaxWaitCycles.store(Waited, std::memory_order_relaxed);
+		}
+
+		if (bCancelled)
+			return false;
+
+		const int32 Now = InFlight.fetch_add(1) + 1;
+		if (Now > Peak.load(std::memory_order_relaxed))
+			Peak.store(Now, std::memory_order_relaxed);
+		return true;
+	}
+
+	/// <summary>
+	/// Any thread, once per successful Acquire().
+	/// </summary>
+	void Release()
+	{
+		InFlight.fetch_sub(1);
+		SlotFreed->Trigger();
+	}
+
+	/// <summary>
+	/// Wake a waiting Acquire() and make every later one fail, for shutdown.
+	/// </summary>
+	void Cancel()
+	{
+		bCancelled = true;
+		SlotFreed->Trigger();
+	}
+
+	inline int32  GetPeak() const { return Peak.load(std::memory_order_relaxed); }
+	inline uint64 GetWaits() const { return Waits.load(std::memory_order_relaxed); }
+	inline double GetWaitSeconds() const
+	{
+		return FPlatformTime::ToSeconds64(WaitCycles.load(std::memory_order_relaxed));
+	}
+	inline double GetMaxWaitSeconds() const
+	{
+		return FPlatformTime::ToSeconds64(MaxWaitCycles.load(std::memory_order_relaxed));
+	}
+
+  private:
+	std::atomic<int32>  InFlight;
+	std::atomic<int32>  Limit;
+	std::atomic<int32>  Peak;
+	std::atomic<uint64> Waits;
+	std::atomic<uint64> WaitCycles;
+	std::atomic<uint64> MaxWaitCycles;
+	std::atomic<bool>   bCancelled;
+	FEvent *            SlotFreed;
+};
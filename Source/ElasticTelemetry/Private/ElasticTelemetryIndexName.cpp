@@ -0,0 +1,94 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryIndexName.h"
+
+namespace
+{
+	void AppendDateField(FString & Out, const FStringView & Field, const FDateTime & UtcTime)
+	{
+		for (int32 i = 0; i < Field.Len();)
+		{
+			const FStringView Rest = Field.RightChop(i);
+			if (Rest.StartsWith(TEXT("yyyy"), ESearchCase::CaseSensitive))
+			{
+				Out.Appendf(TEXT("%04d"), UtcTime.GetYear());
+				i += 4;
+			}
+			else if (Rest.StartsWith(TEXT("yy"), ESearchCase::CaseSensitive))
+			{
+				Out.Appendf(TEXT("%02d"), UtcTime.GetYear() % 100);
+				i += 2;
+			}
+			else if (Rest.StartsWith(TEXT("MM"), ESearchCase::CaseSensitive))
+			{
+				Out.Appendf(TEXT("%02d"), UtcTime.GetMonth());
+				i += 2;
+			}
+			else if (Rest.StartsWith(TEXT("dd"), ESearchCase::CaseSensitive))
+			{
+				Out.Appendf(TEXT("%02d"), UtcTime.GetDay());
+				i += 2;
+			}
+			else
+			{
+				Out.AppendChar(Field[i++]);
+			}
+		}
+	}
+
+	// Calls OnText for the text between fields and OnField for the inside of each {field}. A brace that is never
+	// closed is text.
+	template <typename TOnText, typename TOnField>
+	void ForEachPart(const FString & Pattern, TOnText && OnText, TOnField && OnField)
+	{
+		const FStringView View(Pattern);
+		int32             Start = 0;
+		while (Start < View.Len())
+		{
+			int32 Open  = INDEX_NONE;
+			int32 Close = INDEX_NONE;
+			if (!View.RightChop(Start).FindChar(TEXT('{'), Open) ||
+			    !View.RightChop(Start + Open).FindChar(TEXT('}'), Close))
+			{
+				OnText(View.RightChop(Start));
+				return;
+			}
+			OnText(View.Mid(Start, Open));
+			OnField(View.Mid(Start + Open + 1, Close - 1));
+			Start += Open + Close + 1;
+		}
+	}
+} // namespace
+
+bool FElasticTelemetryIndexName::HasDateFields(const FString & Pattern)
+{
+	bool bHasFields = false;
+	ForEachPart(
+	    Pattern, [](const FStringView &) {}, [&bHasFields](const FStringView &) { bHasFields = true; });
+	return bHasFields;
+}
+
+FString FElasticTelemetryIndexName::Resolve(const FString & Pattern, const FDateTime & UtcTime)
+{
+	FString Resolved;
+	Resolved.Reserve(Pattern.Len() + 4);
+	ForEachPart(
+	    Pattern, [&Resolved](const FStringView & Text) { Resolved.Append(Text.GetData(), Text.Len()); },
+	    [&Resolved, &UtcTime](const FStringView & Field) { AppendDateField(Resolved, Field, UtcTime); });
+	return Resolved;
+}
+
+FDateTime FElasticTelemetryIndexName::GetNextRollover(const FDateTime & UtcTime)
+{
+	return UtcTime.GetDate() + FTimespan::FromDays(1.0);
+}
+
+FString FElasticTelemetryIndexName::ToWildcard(const FString & Pattern)
+{
+	FString Wildcard;
+	ForEachPart(
+	    Pattern, [&Wildcard](const FStringView & Text) { Wildcard.Append(Text.GetData(), Text.Len()); },
+	    [&Wildcard](const FStringView &) { Wildcard.AppendChar(TEXT('*')); });
+	return Wildcard;
+}
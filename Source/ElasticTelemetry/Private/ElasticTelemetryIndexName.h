@@ -0,0 +1,31 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// <summary>
+/// Index names with date fields, so telemetry rolls over to a new index every day.
+///
+/// A pattern such as uelog-{yyyy.MM.dd} resolves to uelog-2024.03.07. Inside braces yyyy, yy, MM and dd are
+/// replaced with the UTC date and anything else is kept as it is. A name without braces is used unchanged. Old data
+/// is then removed by deleting whole indices, and queries only touch the days they ask for.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryIndexName
+{
+  public:
+	static bool HasDateFields(const FString & Pattern);
+
+	static FString Resolve(const FString & Pattern, const FDateTime & UtcTime);
+
+	/// <summary>
+	/// When a name resolved at UtcTime changes next, the following UTC midnight.
+	/// </summary>
+	static FDateTime GetNextRollover(const FDateTime & UtcTime);
+
+	/// <summary>
+	/// The pattern with each date field replaced by *, to search every index it resolves to.
+	/// </summary>
+	static FString ToWildcard(const FString & Pattern);
+};
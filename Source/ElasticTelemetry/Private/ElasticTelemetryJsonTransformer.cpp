@@ -0,0 +1,320 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryJsonTransformer.h"
+#include "Herald/TransformerBuilder.hpp"
+#include <charconv>
+
+namespace
+{
+	/// <summary>
+	/// Appends Value as a quoted JSON string, escaped the way Herald's rapidjson writer escapes it: quote, backslash
+	/// and the short forms of control characters, \u00XX for the rest, everything else (UTF-8 included) as it is.
+	/// Runs that need no escaping are appended in one go.
+	/// </summary>
+	void AppendJsonString(std::string & Out, const std::string_view & Value)
+	{
+		static constexpr char Hex[] = "0123456789ABCDEF";
+
+		Out += '"';
+		size_t Run = 0;
+		for (size_t i = 0; i < Value.size(); ++i)
+		{
+			const unsigned char c = static_cast<unsigned char>(Value[i]);
+			if (c >= 0x20 && c != '"' && c != '\\')
+				continue;
+
+			Out.append(Value.data() + Run, i - Run);
+			Run = i + 1;
+			switch (c)
+			{
+			case '"':
+				Out += "\\\"";
+				break;
+			case '\\':
+				Out += "\\\\";
+				break;
+			case '\b':
+				Out += "\\b";
+				break;
+			case '\f':
+				Out += "\\f";
+				break;
+			case '\n':
+				Out += "\\n";
+				break;
+			case '\r':
+				Out += "\\r";
+				break;
+			case '\t':
+				Out += "\\t";
+				break;
+			default:
+				Out += "\\u00";
+				Out += Hex[c >> 4];
+				Out += Hex[c & 0xF];
+				break;
+			}
+		}
+		Out.append(Value.data() + Run, Value.size() - Run);
+		Out += '"';
+	}
+
+	/// <summary>
+	/// Herald::logTypeNames without the map lookup, every level is a single bit.
+	/// </summary>
+	std::string_view GetLevelName(const Herald::LogLevels Level)
+	{
+		static constexpr std::string_view Names[] = {
+		    "Analysis", "Trace", "Debug", "Info", "Warning", "Error", "Fatal", "Event"};
+
+		const uint32 Bit = FMath::CountTrailingZeros(static_cast<uint32>(Level));
+		return Bit < UE_ARRAY_COUNT(Names) ? Names[Bit] : std::string_view();
+	}
+
+	void AppendJsonNumber(std::string & Out, const int64 Value)
+	{
+		char       Buffer[24];
+		const auto Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+		Out.append(Buffer, Result.ptr - Buffer);
+	}
+
+	/// <summary>
+	/// The shortest of 15 or 17 significant digits that reads back as Value, always with a fraction or exponent so
+	/// ElasticSearch maps the field as a floating point number. JSON has no NaN or infinity, they are written as null.
+	/// </summary>
+	void AppendJsonNumber(std::string & Out, const double Value)
+	{
+		if (!FMath::IsFinite(Value))
+		{
+			Out += "null";
+			return;
+		}
+
+		char  Buffer[32];
+		int32 Length = FCStringAnsi::Snprintf(Buffer, sizeof(Buffer), "%.15g", Value);
+		if (FCStringAnsi::Atod(Buffer) != Value)
+			Length = FCStringAnsi::Snprintf(Buffer, sizeof(Buffer), "%.17g", Value);
+		Out.append(Buffer, Length);
+
+		if (std::string_view(Buffer, Length).find_first_of(".e") == std::string_view::npos)
+			Out += ".0";
+	}
+
+	/// <summary>
+	/// {"log":{"level":..,"message":..,metadata..},"headers":{..},"timestamp":..}, with AppendMetadata(Out) writing
+	/// the ,"key":value pairs. MetadataSize is what they take unescaped, so the common line is written without growing.
+	/// </summary>
+	template <typename AppendMetadataType>
+	void AppendDocument(std::string & Out, const Herald::LogLevels Level, const std::string_view & Message,
+	    const size_t MetadataSize, const std::string_view & Headers, const std::string_view & TimeStamp,
+	    AppendMetadataType && AppendMetadata)
+	{
+		Out.reserve(Out.size() + 64 + Message.size() + MetadataSize + Headers.size() + TimeStamp.size());
+
+		Out += "{\"log\":{\"level\":\"";
+		Out += GetLevelName(Level);
+		Out += Level == Herald::LogLevels::Event ? "\",\"event\":" : "\",\"message\":";
+		AppendJsonString(Out, Message);
+		AppendMetadata(Out);
+		Out += "},";
+		Out += Headers;
+		Out += ",\"timestamp\":\"";
+		Out += TimeStamp;
+		Out += "\"}";
+	}
+
+	thread_local std::string ThreadJsonBuffer;
+	thread_local int32       ThreadJsonDepth = 0;
+
+	/// <summary>
+	/// The logging thread's document buffer, cleared but not freed between lines, so a line only allocates when it is
+	/// longer than any this thread wrote before. A line logged while another is being delivered on the same thread,
+	/// by a writer or callback that logs, gets a buffer of its own.
+	/// </summary>
+	class FJsonBufferScope
+	{
+	  public:
+		explicit FJsonBufferScope(std::atomic<uint64> & InAllocations)
+		    : Allocations(InAllocations)
+		    , Nested()
+		    , Buffer(ThreadJsonDepth++ == 0 ? ThreadJsonBuffer : Nested)
+		    , Capacity(Buffer.capacity())
+		{
+			Buffer.clear();
+		}
+
+		~FJsonBufferScope()
+		{
+			--ThreadJsonDepth;
+			if (Buffer.capacity() != Capacity)
+				Allocations.fetch_add(1, std::memory_order_relaxed);
+
+			// a rare huge line, a callstack, should not pin its size for the life of the thread
+			if (Buffer.capacity() > MaxRetainedBytes)
+				std::string().swap(Buffer);
+		}
+
+		std::string & Get() { return Buffer; }
+
+	  private:
+		static constexpr size_t MaxRetainedBytes = 64 * 1024;
+
+		std::atomic<uint64> & Allocations;
+		std::string           Nested;
+		std::string &         Buffer;
+		const size_t          Capacity;
+	};
+} // namespace
+
+std::atomic<uint64> FElasticTelemetryJsonTransformer::BufferAllocations(0);
+
+FElasticTelemetryJsonTransformer::FElasticTelemetryJsonTransformer()
+    : HeaderWriteLock()
+    , HeaderSet(nullptr)
+    , bMonotonicTimeStamps(false)
+{
+	const auto Empty = std::make_shared<FHeaderSet>();
+	BuildFragment(*Empty);
+	HeaderSet.Store(Empty);
+}
+
+Herald::ILogTransformer & FElasticTelemetryJsonTransformer::addHeader(
+    const std::string & key, const std::string & value)
+{
+	FScopeLock Lock(&HeaderWriteLock);
+	const auto Next   = std::make_shared<FHeaderSet>();
+	Next->Values      = HeaderSet.Load()->Values;
+	Next->Values[key] = value;
+	BuildFragment(*Next);
+	HeaderSet.Store(Next);
+	return *this;
+}
+
+void FElasticTelemetryJsonTransformer::removeHeader(const std::string & key)
+{
+	FScopeLock Lock(&HeaderWriteLock);
+	const auto Next = std::make_shared<FHeaderSet>();
+	Next->Values    = HeaderSet.Load()->Values;
+	if (Next->Values.erase(key) == 0)
+		return;
+	BuildFragment(*Next);
+	HeaderSet.Store(Next);
+}
+
+void FElasticTelemetryJsonTransformer::log(const Herald::LogEntry & entry)
+{
+	// held until the line is written, a header change meanwhile publishes a new set rather than touching this one
+	const std::shared_ptr<const FHeaderSet> Headers = HeaderSet.Load();
+
+	size_t MetadataSize = 0;
+	for (const auto & [Key, Value] : entry.metadata)
+	{
+		MetadataSize += Key.size() + Value.size() + 6;
+	}
+
+	ANSICHAR         TimeStamp[FElasticTelemetryTimeStamp::BufferSize];
+	FJsonBufferScope JsonBuffer(BufferAllocations);
+	std::string &    Json = JsonBuffer.Get();
+	AppendDocument(Json, entry.logLevel, entry.message, MetadataSize, Headers->Fragment, FormatTimeStamp(TimeStamp),
+	    [&entry](std::string & Out) {
+		    for (const auto & [Key, Value] : entry.metadata)
+		    {
+			    Out += ',';
+			    AppendJsonString(Out, Key);
+			    Out += ':';
+			    AppendJsonString(Out, Value);
+		    }
+	    });
+	Deliver(Json);
+}
+
+void FElasticTelemetryJsonTransformer::Log(const FElasticTelemetryLogEntry & Entry)
+{
+	FJsonBufferScope JsonBuffer(BufferAllocations);
+	std::string &    Json = JsonBuffer.Get();
+	Format(Entry, Json);
+	Deliver(Json);
+}
+
+void FElasticTelemetryJsonTransformer::Format(const FElasticTelemetryLogEntry & Entry, std::string & Out) const
+{
+	const std::shared_ptr<const FHeaderSet> Headers = HeaderSet.Load();
+
+	size_t MetadataSize = 0;
+	for (const FElasticTelemetryLogEntry::FField & Field : Entry.GetFields())
+	{
+		MetadataSize += Field.Key.Length + 32 +
+		                (Field.Type == FElasticTelemetryLogEntry::EType::String ? Field.String.Length : 0);
+	}
+
+	ANSICHAR TimeStamp[FElasticTelemetryTimeStamp::BufferSize];
+	AppendDocument(Out, Entry.GetLevel(), Entry.GetMessage(), MetadataSize, Headers->Fragment,
+	    FormatTimeStamp(TimeStamp), [&Entry](std::string & Json) {
+		    for (const FElasticTelemetryLogEntry::FField & Field : Entry.GetFields())
+		    {
+			    Json += ',';
+			    AppendJsonString(Json, Entry.GetText(Field.Key));
+			    Json += ':';
+			    switch (Field.Type)
+			    {
+			    case FElasticTelemetryLogEntry::EType::Int64:
+				    AppendJsonNumber(Json, Field.Int);
+				    break;
+			    case FElasticTelemetryLogEntry::EType::Double:
+				    AppendJsonNumber(Json, Field.Real);
+				    break;
+			    case FElasticTelemetryLogEntry::EType::Bool:
+				    Json += Field.Bool ? "true" : "false";
+				    break;
+			    case FElasticTelemetryLogEntry::EType::String:
+				    AppendJsonString(Json, Entry.GetText(Field.String));
+				    break;
+			    }
+		    }
+	    });
+}
+
+std::string_view FElasticTelemetryJsonTransformer::FormatTimeStamp(
+    ANSICHAR (&Buffer)[FElasticTelemetryTimeStamp::BufferSize]) const
+{
+	return FElasticTelemetryTimeStamp::Format(
+	    FElasticTelemetryTimeStamp::Now(bMonotonicTimeStamps.load(std::memory_order_relaxed)), Buffer);
+}
+
+void FElasticTelemetryJsonTransformer::Deliver(const std::string & Json) const
+{
+	// ship it to the callbacks
+	for (const auto & callback : callbacks)
+	{
+		callback(Json);
+	}
+
+	// ship it to the writers
+	for (const auto & writer : writers)
+	{
+		if (auto w = writer.lock())
+			w->write(Json);
+	}
+}
+
+void FElasticTelemetryJsonTransformer::BuildFragment(FHeaderSet & Headers)
+{
+	// std::map iterates sorted, the order Herald writes them in
+	std::string & Fragment = Headers.Fragment;
+	Fragment               = "\"headers\":{";
+	for (const auto & [Key, Value] : Headers.Values)
+	{
+		if (Fragment.back() != '{')
+			Fragment += ',';
+		AppendJsonString(Fragment, Key);
+		Fragment += ':';
+		AppendJsonString(Fragment, Value);
+	}
+	Fragment += '}';
+}
+
+Herald::ILogTransformerBuilderPtr createElasticTelemetryJsonTransformerBuilder()
+{
+	return Herald::createTransformerBuilder<FElasticTelemetryJsonTransformer>();
+}
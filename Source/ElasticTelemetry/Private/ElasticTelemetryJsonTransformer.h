@@ -0,0 +1,106 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryAtomicSharedPtr.h"
+#include "ElasticTelemetryLogEntry.h"
+#include "ElasticTelemetryTimeStamp.h"
+#include "Herald/BaseLogTransformer.hpp"
+#include "Herald/ILogTransformerBuilder.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Writes the same documents as Herald's JSON transformer, compact rather than pretty printed:
+/// {"log":{"level":..,"message":..,metadata..},"headers":{..},"timestamp":..}, with events under "event" instead of
+/// "message". Headers are escaped once, into a fragment every document copies in as it is.
+///
+/// Headers can change from any thread while others log. Each change publishes a new, immutable FHeaderSet, and log()
+/// takes whichever is current with one atomic load, so a line always carries one whole version and logging never
+/// waits on a lock. Herald's own headers map is left empty.
+///
+/// Timestamps are formatted by FElasticTelemetryTimeStamp, the same text as Herald::getTimeStamp() at a fraction of
+/// the cost. Documents are written into a buffer each logging thread keeps for the next line, writers and callbacks
+/// get it by reference and copy what they keep.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryJsonTransformer : public Herald::BaseLogTransformer
+{
+  public:
+	FElasticTelemetryJsonTransformer();
+
+	virtual Herald::ILogTransformer & addHeader(const std::string & key, const std::string & value) override;
+	virtual void                      removeHeader(const std::string & key) override;
+	virtual void                      log(const Herald::LogEntry & entry) override;
+
+	/// <summary>
+	/// The same document from a typed entry, numbers and bools written as such, with no Herald::LogEntry built.
+	/// </summary>
+	void Log(const FElasticTelemetryLogEntry & Entry);
+
+	/// <summary>
+	/// The document Log() would deliver for Entry, appended to Out and delivered nowhere. For writers that add
+	/// documents of their own, which then carry the same headers as the lines around them.
+	/// </summary>
+	void Format(const FElasticTelemetryLogEntry & Entry, std::string & Out) const;
+
+	/// <summary>
+	/// The "headers":{..} member of the documents written now, already escaped. One atomic load and no allocation,
+	/// safe from any thread, the crash handler's included. A later header change does not touch the one returned.
+	/// </summary>
+	std::shared_ptr<const std::string> GetHeaderFragment() const
+	{
+		const std::shared_ptr<const FHeaderSet> Headers = HeaderSet.Load();
+		return std::shared_ptr<const std::string>(Headers, &Headers->Fragment);
+	}
+
+	/// <summary>
+	/// Takes timestamps from the monotonic source rather than the wall clock, see FElasticTelemetryTimeStamp::Now().
+	/// </summary>
+	void SetMonotonicTimeStamps(const bool bMonotonic)
+	{
+		bMonotonicTimeStamps.store(bMonotonic, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// How often a logging thread's document buffer had to grow, over all transformers and threads. Levels off once
+	/// every thread has written its longest line.
+	/// </summary>
+	static uint64 GetBufferAllocations() { return BufferAllocations.load(std::memory_order_relaxed); }
+
+  private:
+	struct FHeaderSet
+	{
+		std::map<std::string, std::string> Values;
+		std::string                        Fragment; // "headers":{...}, escaped
+	};
+
+	static void      BuildFragment(FHeaderSet & Headers);
+	std::string_view FormatTimeStamp(ANSICHAR (&Buffer)[FElasticTelemetryTimeStamp::BufferSize]) const;
+	void             Deliver(const std::string & Json) const;
+
+	FCriticalSection                             HeaderWriteLock; // one change at a time, readers never take it
+	TElasticTelemetryAtomicSharedPtr<FHeaderSet> HeaderSet;
+	std::atomic<bool>                            bMonotonicTimeStamps;
+
+	static std::atomic<uint64> BufferAllocations;
+};
+
+/// <summary>
+/// Transformers built by createElasticTelemetryJsonTransformerBuilder() are always FElasticTelemetryJsonTransformer
+/// instances, as are the module's log and event transformers.
+/// </summary>
+inline FElasticTelemetryJsonTransformer * AsElasticTelemetryJsonTransformer(
+    const Herald::ILogTransformerPtr & Transformer)
+{
+	return static_cast<FElasticTelemetryJsonTransformer *>(Transformer.get());
+}
+
+/// <summary>
+/// Builds FElasticTelemetryJsonTransformer instances, a drop-in for Herald::createJsonLogTransformerBuilder().
+/// </summary>
+ELASTICTELEMETRY_API Herald::ILogTransformerBuilderPtr createElasticTelemetryJsonTransformerBuilder();
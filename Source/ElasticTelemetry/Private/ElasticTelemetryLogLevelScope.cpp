@@ -0,0 +1,26 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryLogLevelScope.h"
+
+namespace
+{
+	// Defined here rather than inline in the header so every module sees the same thread local
+	thread_local Herald::LogLevels CurrentLogLevel = Herald::LogLevels::Info;
+} // namespace
+
+FElasticTelemetryLogLevelScope::FElasticTelemetryLogLevelScope(const Herald::LogLevels Level)
+    : Previous(CurrentLogLevel)
+{
+	CurrentLogLevel = Level;
+}
+
+FElasticTelemetryLogLevelScope::~FElasticTelemetryLogLevelScope()
+{
+	CurrentLogLevel = Previous;
+}
+
+Herald::LogLevels FElasticTelemetryLogLevelScope::GetCurrent()
+{
+	return CurrentLogLevel;
+}
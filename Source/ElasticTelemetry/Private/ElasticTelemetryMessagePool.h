@@ -0,0 +1,67 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryMpscQueue.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Recycles the std::string blocks queued log lines are copied into. The writer's worker hands a block back once its
+/// line is in a request body, and the next line logged takes it and copies into its capacity, so once the pool has
+/// warmed up a queued line costs no heap allocation. Free blocks are kept in a TElasticTelemetryMpscQueue, whose
+/// dequeue side is safe for any number of threads, so producers take blocks without a lock.
+///
+/// Blocks over MaxBlockBytes are not kept, a rare 32KB callstack should not pin that much memory per pooled block.
+/// </summary>
+class FElasticTelemetryMessagePool
+{
+  public:
+	static constexpr uint32 MaxBlocks     = 1024;
+	static constexpr size_t MaxBlockBytes = 4096;
+
+	FElasticTelemetryMessagePool()
+	    : FreeBlocks(MaxBlocks)
+	    , Allocated(0)
+	    , Reused(0)
+	{
+	}
+
+	/// <summary>
+	/// A block holding Bytes, recycled when a free one is large enough. Safe to call from any thread.
+	/// </summary>
+	std::string Acquire(const std::string_view & Bytes)
+	{
+		std::string Block;
+		if (FreeBlocks.TryDequeue(Block) && Block.capacity() >= Bytes.size())
+			Reused.fetch_add(1, std::memory_order_relaxed);
+		else
+			Allocated.fetch_add(1, std::memory_order_relaxed);
+
+		Block.assign(Bytes.data(), Bytes.size());
+		return Block;
+	}
+
+	/// <summary>
+	/// Returns a block whose line has been sent, or dropped. Freed instead when it is too large or the pool is full.
+	/// </summary>
+	void Release(std::string && Block)
+	{
+		if (Block.capacity() > MaxBlockBytes)
+			return;
+
+		Block.clear();
+		FreeBlocks.TryEnqueue(MoveTemp(Block));
+	}
+
+	uint64 GetAllocated() const { return Allocated.load(std::memory_order_relaxed); }
+	uint64 GetReused() const { return Reused.load(std::memory_order_relaxed); }
+
+  private:
+	TElasticTelemetryMpscQueue<std::string> FreeBlocks;
+	std::atomic<uint64>                     Allocated; // the pool was empty, or its block too small
+	std::atomic<uint64>                     Reused;
+};
@@ -0,0 +1,141 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include <memory>
+
+/// <summary>
+/// Bounded, lock-free, multi-producer/single-consumer ring buffer.
+///
+/// UE_LOG is called from the game thread, render thread, task graph workers and async loading all at once, and every
+/// one of those calls ends up in ElasticTelemetryWriter::write(). Producers claim a slot with a single CAS on the
+/// enqueue position, and each slot carries a sequence number so the consumer can tell a claimed-but-unpublished slot
+/// from a published one. No producer ever waits on another producer or on the consumer.
+///
+/// Capacity is rounded up to a power of two and fixed at construction. TryEnqueue() returns false when the ring is
+/// full, it is up to the caller to decide what to do with the element.
+///
+/// There is one regular consumer, but producers may also dequeue to evict the oldest element under memory pressure,
+/// so dequeue positions are claimed with a CAS the same way enqueue positions are.
+/// </summary>
+template <typename ElementType>
+class TElasticTelemetryMpscQueue
+{
+  public:
+	explicit TElasticTelemetryMpscQueue(const uint32 InCapacity)
+	    : Mask(FMath::RoundUpToPowerOfTwo(FMath::Max(2u, InCapacity)) - 1)
+	    , Cells(new FCell[Mask + 1])
+	    , EnqueuePosition(0)
+	    , DequeuePosition(0)
+	{
+		for (uint64 i = 0; i <= Mask; ++i)
+		{
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	TElasticTelemetryMpscQueue(const TElasticTelemetryMpscQueue &)             = delete;
+	TElasticTelemetryMpscQueue & operator=(const TElasticTelemetryMpscQueue &) = delete;
+
+	/// <summary>
+	/// Safe to call from any number of threads.
+	/// </summary>
+	/// <returns>false if the queue is full. Item is left untouched in that case.</returns>
+	bool TryEnqueue(ElementType && Item)
+	{
+		FCell * Cell     = nullptr;
+		uint64  Position = EnqueuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell                   = &Cells[Position & Mask];
+			const uint64 Sequence  = Cell->Sequence.load(std::memory_order_acquire);
+			const int64  Available = static_cast<int64>(Sequence - Position);
+			if (Available == 0)
+			{
+				// the slot is free for this lap, try to claim it
+				if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (Available < 0)
+			{
+				// the consumer has not released this slot from the previous lap yet
+				return false;
+			}
+			else
+			{
+				// another producer claimed it first
+				Position = EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		Cell->Data = MoveTemp(Item);
+		Cell->Sequence.store(Position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Called by the consumer thread, and by producers evicting the oldest element.
+	/// </summary>
+	/// <returns>false if there is nothing published to dequeue.</returns>
+	bool TryDequeue(ElementType & OutItem)
+	{
+		FCell * Cell     = nullptr;
+		uint64  Position = DequeuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell                   = &Cells[Position & Mask];
+			const uint64 Sequence  = Cell->Sequence.load(std::memory_order_acquire);
+			const int64  Published = static_cast<int64>(Sequence - (Position + 1));
+			if (Published == 0)
+			{
+				if (DequeuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (Published < 0)
+			{
+				// empty, or the producer that claimed this slot has not finished writing it
+				return false;
+			}
+			else
+			{
+				// an evicting producer took it first
+				Position = DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		OutItem = MoveTemp(Cell->Data);
+		// hand the slot to producers for the next lap around the ring
+		Cell->Sequence.store(Position + Mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Approximate number of elements, including slots claimed by producers that are still being written.
+	/// </summary>
+	uint32 Num() const
+	{
+		const uint64 Enqueued = EnqueuePosition.load(std::memory_order_relaxed);
+		const uint64 Dequeued = DequeuePosition.load(std::memory_order_relaxed);
+		return Enqueued > Dequeued ? static_cast<uint32>(Enqueued - Dequeued) : 0;
+	}
+
+	inline uint32 Capacity() const { return static_cast<uint32>(Mask + 1); }
+	inline bool   IsEmpty() const { return Num() == 0; }
+
+  private:
+	struct FCell
+	{
+		std::atomic<uint64> Sequence;
+		ElementType         Data;
+	};
+
+	const uint64             Mask;
+	std::unique_ptr<FCell[]> Cells;
+
+	// producers hammer EnqueuePosition, keep it off the dequeue cache line
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePosition;
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePosition;
+};
@@ -7,8 +7,9 @@
 #include "ElasticTelemetryEnvironmentSettings.h"
 #include "Herald/LogLevels.hpp"
 #include "Herald/Logger.hpp"
-#include "Herald/JsonLogTransformerFactory.hpp"
+#include "ElasticTelemetryJsonTransformer.h"
 #include "ElasticTelemetryWriter.h"
+#include "ElasticTelemetryLogLevelScope.h"
 #include "Herald/LogEntry.hpp"
 #include <string>
 #include "StringConversions.h"
@@ -69,7 +70,7 @@ FElasticTelemetryOutputDevice::FElasticTelemetryOutputDevice(const FElasticTelem
 	// TODO: this should happen via ElasticTelemetryModule::UpdateConfig() so the editor does not need a restart
 	//   to apply endpoint or configuration changes. Probably best to only have it applied there to avoid confusion.
 	std::string IndexName   = TCHAR_TO_UTF8(*FileNameFriendly(ActiveSettings.IndexName));
-	std::string EndpointURL = TCHAR_TO_UTF8(*ActiveSettings.EndpointURL);
+	std::string EndpointURL = TCHAR_TO_UTF8(*ActiveSettings.GetEndpointList());
 	std::string Username    = TCHAR_TO_UTF8(*ActiveSettings.Username);
 	std::string Password    = TCHAR_TO_UTF8(*ActiveSettings.Password);
 
@@ -80,7 +81,7 @@ FElasticTelemetryOutputDevice::FElasticTelemetryOutputDevice(const FElasticTelem
 	                    .build();
 
 	// Create the log transformer
-	auto LogFactory = Herald::createJsonLogTransformerBuilder();
+	auto LogFactory = createElasticTelemetryJsonTransformerBuilder();
 	if (nullptr == LogFactory)
 	{
 		UE_LOG(TelemetryLog, Error, TEXT("Failed to create log transformer factory."));
@@ -88,6 +89,7 @@ FElasticTelemetryOutputDevice::FElasticTelemetryOutputDevice(const FElasticTelem
 	}
 
 	JsonTransformer = LogFactory->attachLogWriter(ElasticWriter).build();
+	AsElasticTelemetryWriter(ElasticWriter)->SetJsonTransformer(JsonTransformer);
 	GLog->AddOutputDevice(
 	    this); // do this last, don't want log events arriving before the transformer/writer chain is in place
 }
@@ -110,8 +112,7 @@ void FElasticTelemetryOutputDevice::Serialize(
 	// early out opportunities
 	auto ActiveSettings = ElasticTelemetry.GetSettings();
 
-	const std::string Msg(TCHAR_TO_UTF8(Message));
-	bool              PrintCallStack = false;
+	bool PrintCallStack = false;
 
 	for (const auto excludedCategory : ActiveSettings.ExcludedLogCategories)
 	{
@@ -184,6 +185,15 @@ void FElasticTelemetryOutputDevice::Serialize(
 	// #endif
 	// --------------------------------------------------------------------------------------------
 
+	if (!Herald::isLogLevelEnabled(LType))
+		return;
+
+	// lets the writer make severity-aware queueing decisions for this line
+	const FElasticTelemetryLogLevelScope LevelScope(LType);
+
+	// the message is converted into the entry, category and verbosity are borrowed, no Herald::LogEntry map is built
+	FElasticTelemetryLogEntry Entry(LType, Message, CategoryKey, CategoryName, VerbosityKey, VerbosityString);
+
 	if (PrintCallStack)
 	{
 		constexpr SIZE_T HumanReadableStringSize = 32792;
@@ -193,12 +203,11 @@ void FElasticTelemetryOutputDevice::Serialize(
 		FGenericPlatformStackWalk::StackWalkAndDump(HumanReadableString, HumanReadableStringSize, IgnoreCount, nullptr);
 
 		static const std::string CallStackKey("CallStack");
-		const std::string        CallStack(HumanReadableString);
-		Herald::log(*JsonTransformer, LType, Msg, CategoryKey, CategoryName, VerbosityKey, VerbosityString,
-		    CallStackKey, CallStack);
+		Entry.Add(CallStackKey, std::string_view(HumanReadableString));
+		AsElasticTelemetryJsonTransformer(JsonTransformer)->Log(Entry);
 	}
 	else
 	{
-		Herald::log(*JsonTransformer, LType, Msg, CategoryKey, CategoryName, VerbosityKey, VerbosityString);
+		AsElasticTelemetryJsonTransformer(JsonTransformer)->Log(Entry);
 	}
-}
\ No newline at end of file
+}
@@ -12,9 +12,13 @@ FElasticTelemetrySettings::FElasticTelemetrySettings()
 	EndpointURL    = TEXT("https://localhost:9200");
 	IndexName      = TEXT("UELog");
 	EventIndexName = TEXT("testing_game_events");
+	UseDataStream  = false;
 	Username       = TEXT("DefaultUser");
 	Password       = TEXT("ChangeMe");
 
+	DiscoverEndpoints                = false; // nodes may publish addresses only reachable inside the cluster
+	EndpointDiscoveryIntervalSeconds = 5 * 60;
+
 	EnableFatal       = true;
 	EnableError       = true;
 	EnableWarning     = true;
@@ -30,6 +34,49 @@ FElasticTelemetrySettings::FElasticTelemetrySettings()
 	IncludeCallstacksOnLog         = false;
 	IncludeCallstacksOnVerbose     = false;
 	IncludeCallstacksOnVeryVerbose = false;
+
+	UseBulkAPI       = true;
+	BulkMaxDocuments = 500;
+	BulkMaxBytes     = 5 * 1024 * 1024;
+
+	FlushMaxDocuments       = 500;
+	FlushMaxBytes           = 1024 * 1024;
+	FlushLingerMilliseconds = 100;
+
+	CompressionLevel = 0; // opt-in, trades worker thread CPU for egress bandwidth
+	WriterShards     = 1;
+	PriorityLane     = true;
+
+	OutboundQueueMaxBytes = 32 * 1024 * 1024;
+	OverflowPolicy        = EElasticTelemetryOverflowPolicy::DropLowestSeverity;
+
+	EnableSpool   = true;
+	SpoolMaxBytes = 256 * 1024 * 1024;
+
+	ShutdownDrainMilliseconds = 5000;
+	CrashFlushLines           = 100;
+
+	PublishStatCounters = false;
+	MonotonicTimeStamps = false;
+
+	MaximumPendingRequests     = 4;
+	AdaptiveConcurrency        = true;
+	AdaptiveConcurrencyFloor   = 1;
+	AdaptiveConcurrencyCeiling = 32;
+
+	RetryInitialBackoffMilliseconds = 1000;
+	RetryMaxBackoffMilliseconds     = 60 * 1000;
+}
+
+FString FElasticTelemetrySettings::GetEndpointList() const
+{
+	FString List = EndpointURL;
+	for (const FString & Additional : AdditionalEndpointURLs)
+	{
+		if (!Additional.IsEmpty())
+			List += TEXT(",") + Additional;
+	}
+	return List;
 }
 
 bool FElasticTelemetrySettings::IsLogLevelEnabled(const ELogVerbosity::Type Level) const
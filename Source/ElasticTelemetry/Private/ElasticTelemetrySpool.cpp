@@ -0,0 +1,297 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetrySpool.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	constexpr uint32 RecordMagic = 0x4C4F5053; // "SPOL"
+
+	// ERecordFlags only take the low byte of Flags, the record's document count is kept above them. Records written
+	// before the count was stored have nothing there and read back as 0 documents.
+	constexpr uint32 FlagsMask      = 0xFF;
+	constexpr uint32 DocumentsShift = 8;
+	constexpr uint32 MaxDocuments   = MAX_uint32 >> DocumentsShift;
+
+	struct FRecordHeader
+	{
+		uint32 Magic;
+		uint32 Flags;
+		uint32 Size;
+		uint32 Crc;
+	};
+	static_assert(sizeof(FRecordHeader) == 16, "spool records are read back by older and newer builds");
+
+	FRecordHeader MakeRecordHeader(const uint32 Flags, const uint32 Documents, const uint8 * Data, const int64 Size)
+	{
+		FRecordHeader Header;
+		Header.Magic = RecordMagic;
+		Header.Flags = (Flags & FlagsMask) | (FMath::Min(Documents, MaxDocuments) << DocumentsShift);
+		Header.Size  = static_cast<uint32>(Size);
+		Header.Crc   = FCrc::MemCrc32(Data, static_cast<int32>(Size));
+		return Header;
+	}
+
+	const TCHAR * SegmentExtension = TEXT(".spool");
+} // namespace
+
+FElasticTelemetrySpool::FElasticTelemetrySpool()
+    : Directory()
+    , MaxBytes(0)
+    , SegmentBytes(DefaultSegmentBytes)
+    , Segments()
+    , ActiveHandle(nullptr)
+    , NextSequence(0)
+    , TotalBytes(0)
+    , ReadBuffer()
+    , ReadOffset(0)
+    , bReadLoaded(false)
+    , EvictedBytes(0)
+    , DiscardedBytes(0)
+{
+}
+
+FElasticTelemetrySpool::~FElasticTelemetrySpool()
+{
+	Close();
+}
+
+bool FElasticTelemetrySpool::Open(const FString & InDirectory, const int64 InMaxBytes, const int64 InSegmentBytes)
+{
+	Close();
+
+	IFileManager & FileManager = IFileManager::Get();
+	if (!FileManager.MakeDirectory(*InDirectory, true))
+		return false;
+
+	Directory    = InDirectory;
+	MaxBytes     = InMaxBytes;
+	SegmentBytes = FMath::Max<int64>(1, InSegmentBytes);
+
+	// Segments left behind by previous runs are replayed, never appended to, so a torn tail stays contained
+	TArray<FString> Names;
+	FileManager.FindFiles(Names, *(Directory / (FString(TEXT("*")) + SegmentExtension)), true, false);
+	for (const FString & Name : Names)
+	{
+		const FString Path     = Directory / Name;
+		const uint64  Sequence = FCString::Strtoui64(*FPaths::GetBaseFilename(Name), nullptr, 10);
+		const int64   Bytes    = FileManager.FileSize(*Path);
+		if (Bytes <= 0)
+		{
+			FileManager.Delete(*Path, false, true, true);
+			continue;
+		}
+		Segments.Add({Sequence, Bytes});
+		TotalBytes += Bytes;
+		NextSequence = FMath::Max(NextSequence, Sequence + 1);
+	}
+	Segments.Sort([](const FSegment & A, const FSegment & B) { return A.Sequence < B.Sequence; });
+	return true;
+}
+
+void FElasticTelemetrySpool::Close()
+{
+	CloseActiveSegment();
+	Directory.Reset();
+	Segments.Reset();
+	ReadBuffer.Reset();
+	ReadOffset   = 0;
+	bReadLoaded  = false;
+	TotalBytes   = 0;
+	NextSequence = 0;
+}
+
+bool FElasticTelemetrySpool::Append(const uint32 Flags, const uint8 * Data, const int64 Size, const uint32 Documents)
+{
+	const int64 RecordBytes = static_cast<int64>(sizeof(FRecordHeader)) + Size;
+	if (!IsOpen() || RecordBytes > MaxBytes || Size > MAX_uint32)
+	{
+		EvictedBytes += RecordBytes;
+		return false;
+	}
+
+	// oldest first, but never the segment being written
+	while (TotalBytes + RecordBytes > MaxBytes && Segments.Num() > (ActiveHandle ? 1 : 0))
+	{
+		EvictedBytes += Segments[0].Bytes;
+		DeleteOldestSegment();
+	}
+	if (TotalBytes + RecordBytes > MaxBytes && ActiveHandle)
+	{
+		// the active segment alone is in the way, start over with a fresh one
+		CloseActiveSegment();
+		EvictedBytes += Segments[0].Bytes;
+		DeleteOldestSegment();
+	}
+
+	if (ActiveHandle && Segments.Last().Bytes + RecordBytes > SegmentBytes)
+		CloseActiveSegment();
+
+	if (!ActiveHandle && !OpenActiveSegment())
+	{
+		EvictedBytes += RecordBytes;
+		return false;
+	}
+
+	const FRecordHeader Header   = MakeRecordHeader(Flags, Documents, Data, Size);
+	const bool          bWritten = ActiveHandle->Write(reinterpret_cast<const uint8 *>(&Header), sizeof(Header)) &&
+	                               ActiveHandle->Write(Data, Size) && ActiveHandle->Flush();
+	if (!bWritten)
+	{
+		// disk full or similar, whatever made it to disk is a torn record and replay will stop there
+		CloseActiveSegment();
+		EvictedBytes += RecordBytes;
+		return false;
+	}
+
+	Segments.Last().Bytes += RecordBytes;
+	TotalBytes += RecordBytes;
+	return true;
+}
+
+bool FElasticTelemetrySpool::ReadNext(FRecord & OutRecord)
+{
+	while (IsOpen())
+	{
+		if (!bReadLoaded && !LoadOldestSegment())
+			return false;
+
+		const int64 Remaining = ReadBuffer.Num() - ReadOffset;
+		if (Remaining == 0)
+		{
+			DeleteOldestSegment();
+			continue;
+		}
+
+		FRecordHeader Header;
+		bool          bValid = Remaining >= static_cast<int64>(sizeof(Header));
+		if (bValid)
+		{
+			FMemory::Memcpy(&Header, ReadBuffer.GetData() + ReadOffset, sizeof(Header));
+			bValid = Header.Magic == RecordMagic && Header.Size <= Remaining - static_cast<int64>(sizeof(Header)) &&
+			         FCrc::MemCrc32(ReadBuffer.GetData() + ReadOffset + sizeof(Header), Header.Size) == Header.Crc;
+		}
+		if (!bValid)
+		{
+			// torn write from a crash or a damaged file, nothing after this point can be trusted
+			DiscardedBytes += Remaining;
+			DeleteOldestSegment();
+			continue;
+		}
+
+		OutRecord.Flags     = Header.Flags & FlagsMask;
+		OutRecord.Documents = Header.Flags >> DocumentsShift;
+		OutRecord.Payload.Reset(Header.Size);
+		OutRecord.Payload.Append(ReadBuffer.GetData() + ReadOffset + sizeof(Header), Header.Size);
+		ReadOffset += sizeof(Header) + Header.Size;
+		return true;
+	}
+	return false;
+}
+
+bool FElasticTelemetrySpool::IsEmpty() const
+{
+	if (bReadLoaded && ReadOffset < ReadBuffer.Num())
+		return false;
+
+	// a loaded segment that has been fully handed out does not count, it is deleted on the next read
+	return Segments.Num() <= (bReadLoaded ? 1 : 0);
+}
+
+FString FElasticTelemetrySpool::GetSegmentPath(const uint64 Sequence) const
+{
+	return Directory / FString::Printf(TEXT("%020llu%s"), Sequence, SegmentExtension);
+}
+
+FString FElasticTelemetrySpool::GetCrashSegmentPath(const FString & InDirectory)
+{
+	// UTC ticks grow from one launch to the next, and a spool never gets through that many segments in between
+	const uint64 Sequence = static_cast<uint64>(FDateTime::UtcNow().GetTicks());
+	return InDirectory / FString::Printf(TEXT("%020llu%s"), Sequence, SegmentExtension);
+}
+
+bool FElasticTelemetrySpool::WriteSegment(
+    const TCHAR * Path, const uint32 Flags, const uint8 * Data, const int64 Size, const uint32 Documents)
+{
+	if (Size <= 0 || Size > MAX_uint32)
+		return false;
+
+	IFileHandle * Handle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(Path);
+	if (!Handle)
+		return false;
+
+	const FRecordHeader Header   = MakeRecordHeader(Flags, Documents, Data, Size);
+	const bool          bWritten = Handle->Write(reinterpret_cast<const uint8 *>(&Header), sizeof(Header)) &&
+	                               Handle->Write(Data, Size) && Handle->Flush(true);
+	delete Handle;
+	return bWritten;
+}
+
+bool FElasticTelemetrySpool::OpenActiveSegment()
+{
+	const uint64 Sequence = NextSequence++;
+	ActiveHandle          = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*GetSegmentPath(Sequence));
+	if (!ActiveHandle)
+		return false;
+
+	Segments.Add({Sequence, 0});
+	return true;
+}
+
+void FElasticTelemetrySpool::CloseActiveSegment()
+{
+	if (!ActiveHandle)
+		return;
+
+	delete ActiveHandle;
+	ActiveHandle = nullptr;
+
+	// a segment that never received a record is just an empty file
+	if (Segments.Num() > 0 && Segments.Last().Bytes == 0)
+	{
+		IFileManager::Get().Delete(*GetSegmentPath(Segments.Last().Sequence), false, true, true);
+		Segments.Pop(EAllowShrinking::No);
+	}
+}
+
+bool FElasticTelemetrySpool::LoadOldestSegment()
+{
+	if (Segments.Num() == 0)
+		return false;
+
+	// replay has caught up with the writer, seal the active segment so it can be read
+	if (ActiveHandle && Segments.Num() == 1)
+	{
+		CloseActiveSegment();
+		if (Segments.Num() == 0)
+			return false;
+	}
+
+	ReadBuffer.Reset();
+	ReadOffset  = 0;
+	bReadLoaded = true;
+	if (!FFileHelper::LoadFileToArray(ReadBuffer, *GetSegmentPath(Segments[0].Sequence), FILEREAD_Silent))
+	{
+		DiscardedBytes += Segments[0].Bytes;
+		ReadBuffer.Reset();
+	}
+	return true;
+}
+
+void FElasticTelemetrySpool::DeleteOldestSegment()
+{
+	if (Segments.Num() == 0)
+		return;
+
+	IFileManager::Get().Delete(*GetSegmentPath(Segments[0].Sequence), false, true, true);
+	TotalBytes -= Segments[0].Bytes;
+	Segments.RemoveAt(0, 1, EAllowShrinking::No);
+
+	ReadBuffer.Reset();
+	ReadOffset  = 0;
+	bReadLoaded = false;
+}
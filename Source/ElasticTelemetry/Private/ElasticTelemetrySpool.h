@@ -0,0 +1,129 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+
+/// <summary>
+/// Append-only, segmented disk spool for request bodies that could not be delivered.
+///
+/// While ElasticSearch is unreachable the writer's worker thread appends each request body it would have sent to the
+/// newest segment file. Once the endpoint is reachable again, or on the next launch, the worker replays records oldest
+/// first and deletes each segment after its last record has been handed out. The total size on disk is bounded, the
+/// oldest segments are evicted first to make room.
+///
+/// Each record is a small header (magic, flags and document count, size, CRC32) followed by the payload, streamed
+/// with a plain file handle. A crash can leave the last record of a segment half written. Segments from a previous
+/// run are never appended to, and replay stops at the first record that is truncated or fails its CRC, so a torn
+/// tail costs at most that record and the rest of its segment.
+///
+/// Only ever touched by the writer's worker thread. Not thread safe.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetrySpool
+{
+  public:
+	/// <summary>
+	/// What a record's payload is, so replay can send it exactly as it would have been sent originally.
+	/// </summary>
+	enum ERecordFlags : uint32
+	{
+		None = 0,
+		Bulk = 1 << 0, // NDJSON body for the _bulk API, otherwise a single _doc document
+		Gzip = 1 << 1  // payload is gzip compressed
+	};
+
+	struct FRecord
+	{
+		uint32        Flags = None;
+		TArray<uint8> Payload;
+		uint32        Documents = 0; // log lines in Payload, 0 for records written before the count was stored
+	};
+
+	FElasticTelemetrySpool();
+	~FElasticTelemetrySpool();
+
+	FElasticTelemetrySpool(const FElasticTelemetrySpool &)             = delete;
+	FElasticTelemetrySpool & operator=(const FElasticTelemetrySpool &) = delete;
+
+	/// <summary>
+	/// Open, or create, the spool in Directory and index the segments left by previous runs.
+	/// </summary>
+	/// <param name="MaxBytes">Bound on the total size of all segments, oldest segments are evicted beyond it.</param>
+	/// <param name="SegmentBytes">Size at which the active segment is closed and a new one started.</param>
+	/// <returns>false if the directory cannot be created.</returns>
+	bool Open(const FString & Directory, int64 MaxBytes, int64 SegmentBytes = DefaultSegmentBytes);
+
+	void Close();
+
+	inline bool           IsOpen() const { return !Directory.IsEmpty(); }
+	inline const FString & GetDirectory() const { return Directory; }
+
+	/// <summary>
+	/// Append a record to the active segment, evicting the oldest segments if the spool would exceed MaxBytes.
+	/// Documents is kept with it and handed back by ReadNext(), so replayed requests are counted like live ones.
+	/// </summary>
+	/// <returns>false if the record could not be written, or is larger than MaxBytes on its own.</returns>
+	bool Append(uint32 Flags, const uint8 * Data, int64 Size, uint32 Documents = 0);
+
+	/// <summary>
+	/// Hand out the oldest record. The active segment is closed first when it is the only one left.
+	/// </summary>
+	/// <returns>false if the spool is empty.</returns>
+	bool ReadNext(FRecord & OutRecord);
+
+	/// <summary>
+	/// Whether there is anything left to replay.
+	/// </summary>
+	bool IsEmpty() const;
+
+	/// <summary>
+	/// Where a crashing process writes its last record, see WriteSegment(). Numbered after the segments any earlier
+	/// run could have written, so a spool opened on the next launch replays it last.
+	/// </summary>
+	static FString GetCrashSegmentPath(const FString & Directory);
+
+	/// <summary>
+	/// Writes a single record as a segment file of its own, without an open spool, for the crash path. Replayed by
+	/// whichever spool next opens the directory.
+	/// </summary>
+	static bool WriteSegment(const TCHAR * Path, uint32 Flags, const uint8 * Data, int64 Size, uint32 Documents = 0);
+
+	inline int64  GetTotalBytes() const { return TotalBytes; }
+	inline int32  GetSegmentCount() const { return Segments.Num(); }
+	inline uint64 GetEvictedBytes() const { return EvictedBytes; }
+	inline uint64 GetDiscardedBytes() const { return DiscardedBytes; }
+
+	static constexpr int64 DefaultSegmentBytes = 4 * 1024 * 1024;
+
+  private:
+	struct FSegment
+	{
+		uint64 Sequence;
+		int64  Bytes;
+	};
+
+	FString GetSegmentPath(uint64 Sequence) const;
+	bool    OpenActiveSegment();
+	void    CloseActiveSegment();
+	bool    LoadOldestSegment();
+	void    DeleteOldestSegment();
+
+	FString          Directory;
+	int64            MaxBytes;
+	int64            SegmentBytes;
+	TArray<FSegment> Segments; // oldest first, the active segment (if any) is last
+	IFileHandle *    ActiveHandle;
+	uint64           NextSequence;
+	int64            TotalBytes;
+
+	// the oldest segment, loaded for replay
+	TArray<uint8> ReadBuffer;
+	int64         ReadOffset;
+	bool          bReadLoaded;
+
+	uint64 EvictedBytes;   // lost to MaxBytes
+	uint64 DiscardedBytes; // lost to torn or corrupt records
+};
@@ -0,0 +1,158 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryStatCounters.h"
+#include "ElasticTelemetry.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("ElasticTelemetry"), STATGROUP_ElasticTelemetry, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Log: queued lines"), STAT_ElasticTelemetryLogQueued, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Log: enqueued lines/s"), STAT_ElasticTelemetryLogEnqueueRate, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Log: requests in flight"), STAT_ElasticTelemetryLogInFlight, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Log: mean lines per batch"), STAT_ElasticTelemetryLogBatchDocuments, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Log: compression ratio"), STAT_ElasticTelemetryLogCompression, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Log: request latency p50 (ms)"), STAT_ElasticTelemetryLogLatencyP50, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Log: request latency p99 (ms)"), STAT_ElasticTelemetryLogLatencyP99, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Log: retryable failures"), STAT_ElasticTelemetryLogRetries, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Log: dropped lines"), STAT_ElasticTelemetryLogDropped, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Log: message blocks allocated"), STAT_ElasticTelemetryLogBlocksAllocated, STATGROUP_ElasticTelemetry);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Event: queued lines"), STAT_ElasticTelemetryEventQueued, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Event: enqueued lines/s"), STAT_ElasticTelemetryEventEnqueueRate, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Event: requests in flight"), STAT_ElasticTelemetryEventInFlight, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Event: mean lines per batch"), STAT_ElasticTelemetryEventBatchDocuments, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Event: compression ratio"), STAT_ElasticTelemetryEventCompression, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Event: request latency p50 (ms)"), STAT_ElasticTelemetryEventLatencyP50, STATGROUP_ElasticTelemetry);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Event: request latency p99 (ms)"), STAT_ElasticTelemetryEventLatencyP99, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Event: retryable failures"), STAT_ElasticTelemetryEventRetries, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Event: dropped lines"), STAT_ElasticTelemetryEventDropped, STATGROUP_ElasticTelemetry);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Event: message blocks allocated"), STAT_ElasticTelemetryEventBlocksAllocated, STATGROUP_ElasticTelemetry);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("JSON buffer allocations"), STAT_ElasticTelemetryJsonBufferAllocations, STATGROUP_ElasticTelemetry);
+
+// Stat names are pasted into identifiers, so the two writers need a macro rather than a function
+#define ELASTICTELEMETRY_SET_WRITER_STATS(Writer, Stats, Rate)                                                         \
+    SET_DWORD_STAT(STAT_ElasticTelemetry##Writer##Queued, Stats.QueuedMessages);                                       \
+    SET_FLOAT_STAT(STAT_ElasticTelemetry##Writer##EnqueueRate, Rate);                                                  \
+    SET_DWORD_STAT(STAT_ElasticTelemetry##Writer##InFlight, Stats.InFlightRequests);                                   \
+    SET_FLOAT_STAT(STAT_ElasticTelemetry##Writer##BatchDocuments, Stats.BatchDocuments.GetMean());                     \
+    SET_FLOAT_STAT(STAT_ElasticTelemetry##Writer##Compression, GetCompressionRatio(Stats));                            \
+    SET_FLOAT_STAT(STAT_ElasticTelemetry##Writer##LatencyP50, GetLatencyMilliseconds(Stats, 0.5));                     \
+    SET_FLOAT_STAT(STAT_ElasticTelemetry##Writer##LatencyP99, GetLatencyMilliseconds(Stats, 0.99));                    \
+    SET_DWORD_STAT(STAT_ElasticTelemetry##Writer##Retries, Stats.RetryableFailures);                                   \
+    SET_DWORD_STAT(STAT_ElasticTelemetry##Writer##Dropped, Stats.GetTotalDropped());                                   \
+    SET_DWORD_STAT(STAT_ElasticTelemetry##Writer##BlocksAllocated, Stats.MessageBlocksAllocated)
+
+namespace
+{
+	double GetCompressionRatio(const FElasticTelemetryWriterStats & Stats)
+	{
+		return Stats.CompressedBytes > 0 ? static_cast<double>(Stats.UncompressedBytes) / Stats.CompressedBytes : 1.0;
+	}
+
+	double GetLatencyMilliseconds(const FElasticTelemetryWriterStats & Stats, const double Percentile)
+	{
+		return Stats.RequestLatencyMicroseconds.GetPercentile(Percentile) / 1000.0;
+	}
+
+	FAutoConsoleCommandWithOutputDevice StatsCommand(TEXT("ElasticTelemetry.Stats"),
+	    TEXT("Prints queue depth, throughput, batch sizes, request latency, retries, drops and allocations of both "
+	         "writers."),
+	    FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice & Ar) {
+		    const FElasticTelemetryModule * Module =
+		        FModuleManager::GetModulePtr<FElasticTelemetryModule>("ElasticTelemetry");
+		    if (!Module)
+		    {
+			    Ar.Log(TEXT("ElasticTelemetry is not loaded."));
+			    return;
+		    }
+		    Ar.Log(FElasticTelemetryStatCounters::Format(TEXT("Log"), Module->GetLogWriterStats()));
+		    Ar.Log(FElasticTelemetryStatCounters::Format(TEXT("Event"), Module->GetEventWriterStats()));
+		    Ar.Log(FString::Printf(TEXT("ElasticTelemetry JSON buffers grown %llu times on the logging threads"),
+		        FElasticTelemetryJsonTransformer::GetBufferAllocations()));
+	    }));
+} // namespace
+
+FElasticTelemetryStatCounters::FElasticTelemetryStatCounters(const FElasticTelemetryModule & InModule)
+    : Module(InModule)
+    , TickerHandle()
+    , LogEnqueued(InModule.GetLogWriterStats().EnqueuedDocuments)
+    , EventEnqueued(InModule.GetEventWriterStats().EnqueuedDocuments)
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateRaw(this, &FElasticTelemetryStatCounters::Publish), 0.5f);
+}
+
+FElasticTelemetryStatCounters::~FElasticTelemetryStatCounters()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+bool FElasticTelemetryStatCounters::Publish(const float DeltaTime)
+{
+	const FElasticTelemetryWriterStats Log   = Module.GetLogWriterStats();
+	const FElasticTelemetryWriterStats Event = Module.GetEventWriterStats();
+	const double                       Scale = DeltaTime > 0.0f ? 1.0 / DeltaTime : 0.0;
+
+	ELASTICTELEMETRY_SET_WRITER_STATS(Log, Log, (Log.EnqueuedDocuments - LogEnqueued) * Scale);
+	ELASTICTELEMETRY_SET_WRITER_STATS(Event, Event, (Event.EnqueuedDocuments - EventEnqueued) * Scale);
+	SET_DWORD_STAT(
+	    STAT_ElasticTelemetryJsonBufferAllocations, FElasticTelemetryJsonTransformer::GetBufferAllocations());
+	LogEnqueued   = Log.EnqueuedDocuments;
+	EventEnqueued = Event.EnqueuedDocuments;
+	return true;
+}
+
+FString FElasticTelemetryStatCounters::Format(const TCHAR * Name, const FElasticTelemetryWriterStats & Stats)
+{
+	const double Uptime = FMath::Max(Stats.UptimeSeconds, 0.001);
+	const auto & Batch  = Stats.BatchDocuments;
+	const auto & Bytes  = Stats.BatchBytes;
+	const auto & Time   = Stats.RequestLatencyMicroseconds;
+
+	FString Out = FString::Printf(TEXT("ElasticTelemetry %s writer, up %.0fs, %u shard(s)\n"), Name,
+	    Stats.UptimeSeconds, Stats.WriterShards);
+	Out += FString::Printf(TEXT("  queued    %u lines, %llu bytes\n"), Stats.QueuedMessages, Stats.QueuedBytes);
+	Out += FString::Printf(TEXT("  enqueued  %llu lines (%.1f/s), %llu bytes (%.1f/s)\n"), Stats.EnqueuedDocuments,
+	    Stats.EnqueuedDocuments / Uptime, Stats.EnqueuedBytes, Stats.EnqueuedBytes / Uptime);
+	Out += FString::Printf(
+	    TEXT("  batches   %llu, lines p50 %llu p99 %llu max %llu, bytes p50 %llu p99 %llu max %llu\n"), Batch.Count,
+	    Batch.GetPercentile(0.5), Batch.GetPercentile(0.99), Batch.Max, Bytes.GetPercentile(0.5),
+	    Bytes.GetPercentile(0.99), Bytes.Max);
+	Out += FString::Printf(TEXT("  bytes     %llu before compression, %llu sent (%.2fx)\n"), Stats.UncompressedBytes,
+	    Stats.CompressedBytes, GetCompressionRatio(Stats));
+	Out += FString::Printf(TEXT("  requests  %llu, %d in flight (limit %d), latency p50 %.1fms p90 %.1fms p99 %.1fms "
+	                            "max %.1fms\n"),
+	    Stats.Requests, Stats.InFlightRequests, Stats.MaximumPendingRequests, Time.GetPercentile(0.5) / 1000.0,
+	    Time.GetPercentile(0.9) / 1000.0, Time.GetPercentile(0.99) / 1000.0, Time.Max / 1000.0);
+	Out += FString::Printf(TEXT("  retries   %llu retryable failures, %llu resent, %llu rejected, circuit %s\n"),
+	    Stats.RetryableFailures, Stats.ResentRequests, Stats.RejectedRequests,
+	    Stats.bCircuitOpen ? TEXT("open") : TEXT("closed"));
+	Out += FString::Printf(TEXT("  dropped   %llu newest, %llu oldest, %llu low severity, %llu held retries\n"),
+	    Stats.DroppedNewest, Stats.DroppedOldest, Stats.DroppedLowSeverity, Stats.DroppedRetries);
+	Out += FString::Printf(TEXT("  blocks    %llu allocated, %llu reused"), Stats.MessageBlocksAllocated,
+	    Stats.MessageBlocksReused);
+	return Out;
+}
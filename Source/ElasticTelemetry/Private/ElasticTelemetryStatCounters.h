@@ -0,0 +1,34 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ElasticTelemetryWriterStats.h"
+
+class FElasticTelemetryModule;
+
+/// <summary>
+/// Copies both writers' stats into the ElasticTelemetry stat group ("stat ElasticTelemetry") twice a second, while
+/// PublishStatCounters is set. Does nothing in builds without STATS.
+/// </summary>
+class FElasticTelemetryStatCounters
+{
+  public:
+	explicit FElasticTelemetryStatCounters(const FElasticTelemetryModule & InModule);
+	~FElasticTelemetryStatCounters();
+
+	/// <summary>
+	/// A multi-line report of one writer's stats, for the ElasticTelemetry.Stats console command.
+	/// </summary>
+	static FString Format(const TCHAR * Name, const FElasticTelemetryWriterStats & Stats);
+
+  private:
+	bool Publish(float DeltaTime);
+
+	const FElasticTelemetryModule & Module;
+	FTSTicker::FDelegateHandle      TickerHandle;
+	uint64                          LogEnqueued;
+	uint64                          EventEnqueued;
+};
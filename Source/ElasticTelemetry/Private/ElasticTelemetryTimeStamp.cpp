@@ -0,0 +1,80 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryTimeStamp.h"
+#include <ctime>
+
+namespace
+{
+	/// <summary>
+	/// The last second this thread formatted, as a whole timestamp with .000 for the milliseconds.
+	/// </summary>
+	struct FSecondCache
+	{
+		bool        bValid = false;
+		std::time_t Second = 0;
+		ANSICHAR    Text[FElasticTelemetryTimeStamp::BufferSize];
+		int32       Length       = 0;
+		int32       MillisOffset = 0; // where the three millisecond digits go
+	};
+
+	thread_local FSecondCache SecondCache;
+
+	void FormatSecond(FSecondCache & Cache, const std::time_t Second)
+	{
+		struct tm TimeInfo;
+#if PLATFORM_WINDOWS
+		localtime_s(&TimeInfo, &Second);
+#else
+		localtime_r(&Second, &TimeInfo);
+#endif
+
+		// the same strftime() formats put_time() uses, so the text is Herald's to the byte
+		const size_t Prefix = strftime(Cache.Text, sizeof(Cache.Text), "%Y-%m-%dT%H:%M:%S.000", &TimeInfo);
+		const size_t Offset = strftime(Cache.Text + Prefix, sizeof(Cache.Text) - Prefix, "%z", &TimeInfo);
+
+		Cache.bValid       = Prefix > 0;
+		Cache.Second       = Second;
+		Cache.Length       = static_cast<int32>(Prefix + Offset);
+		Cache.MillisOffset = static_cast<int32>(Prefix) - 3;
+	}
+} // namespace
+
+std::string_view FElasticTelemetryTimeStamp::Format(
+    const std::chrono::system_clock::time_point & TimePoint, ANSICHAR (&Buffer)[BufferSize])
+{
+	const int64 Milliseconds =
+	    std::chrono::duration_cast<std::chrono::milliseconds>(TimePoint.time_since_epoch()).count();
+	const std::time_t Second = std::chrono::system_clock::to_time_t(TimePoint);
+	const int32       Millis = static_cast<int32>(Milliseconds % 1000);
+
+	FSecondCache & Cache = SecondCache;
+	if (!Cache.bValid || Cache.Second != Second)
+	{
+		FormatSecond(Cache, Second);
+		if (!Cache.bValid)
+			return std::string_view();
+	}
+
+	FMemory::Memcpy(Buffer, Cache.Text, Cache.Length);
+	Buffer[Cache.MillisOffset]     = static_cast<ANSICHAR>('0' + Millis / 100);
+	Buffer[Cache.MillisOffset + 1] = static_cast<ANSICHAR>('0' + Millis / 10 % 10);
+	Buffer[Cache.MillisOffset + 2] = static_cast<ANSICHAR>('0' + Millis % 10);
+	return std::string_view(Buffer, Cache.Length);
+}
+
+std::chrono::system_clock::time_point FElasticTelemetryTimeStamp::Now(const bool bMonotonic)
+{
+	if (!bMonotonic)
+		return std::chrono::system_clock::now();
+
+	struct FAnchor
+	{
+		std::chrono::system_clock::time_point System;
+		std::chrono::steady_clock::time_point Steady;
+	};
+	static const FAnchor Anchor{std::chrono::system_clock::now(), std::chrono::steady_clock::now()};
+
+	const auto Elapsed = std::chrono::steady_clock::now() - Anchor.Steady;
+	return Anchor.System + std::chrono::duration_cast<std::chrono::system_clock::duration>(Elapsed);
+}
@@ -0,0 +1,33 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <chrono>
+#include <string_view>
+
+/// <summary>
+/// Formats timestamps exactly like Herald::getTimeStamp(), 2024-05-01T12:34:56.789+0200 in local time, without its
+/// stringstream and two put_time() calls per line. The date and time up to the second and the UTC offset are
+/// formatted once a second per thread and cached, each line copies them and writes its milliseconds. A new second
+/// formats both again, so daylight saving changes are picked up on the second they happen.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryTimeStamp
+{
+  public:
+	static constexpr int32 BufferSize = 40;
+
+	/// <summary>
+	/// Formats TimePoint into Buffer, returns the formatted part of it.
+	/// </summary>
+	static std::string_view Format(
+	    const std::chrono::system_clock::time_point & TimePoint, ANSICHAR (&Buffer)[BufferSize]);
+
+	/// <summary>
+	/// The wall clock, or with bMonotonic the wall clock read once per process plus a steady clock's time since. The
+	/// monotonic source never goes backwards, so a burst of lines keeps its order even when the system clock is stepped
+	/// meanwhile, at the cost of not following such adjustments for the rest of the session.
+	/// </summary>
+	static std::chrono::system_clock::time_point Now(bool bMonotonic);
+};
@@ -0,0 +1,94 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryTransport.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include <algorithm>
+#include <string_view>
+
+void FElasticTelemetryHttpTransport::Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete)
+{
+	auto HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetURL(Request.URL);
+	HttpRequest->SetVerb(Request.Verb);
+	for (const TPair<FString, FString> & Header : Request.Headers)
+	{
+		HttpRequest->SetHeader(Header.Key, Header.Value);
+	}
+	if (Request.ContentType)
+		HttpRequest->SetHeader(TEXT("Content-Type"), Request.ContentType);
+	if (Request.ContentEncoding)
+		HttpRequest->SetHeader(TEXT("Content-Encoding"), Request.ContentEncoding);
+	if (Request.Body.Num() > 0)
+		HttpRequest->SetContent(MoveTemp(Request.Body));
+
+	HttpRequest->OnProcessRequestComplete().BindLambda(
+	    [OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr Sent, FHttpResponsePtr Response, bool bWasSuccessful) {
+		    FElasticTelemetryTransportResponse Result;
+		    Result.bWasSuccessful = bWasSuccessful;
+		    Result.RequestBody    = Sent->GetContent();
+		    if (Response)
+		    {
+			    Result.Code    = Response->GetResponseCode();
+			    Result.Content = Response->GetContent();
+
+			    // only the delta-seconds form, an HTTP date is treated as no hint
+			    const FString RetryAfter = Response->GetHeader(TEXT("Retry-After"));
+			    if (RetryAfter.IsNumeric())
+				    Result.RetryAfterSeconds = FCString::Atod(*RetryAfter);
+		    }
+		    OnComplete(Result);
+	    });
+	HttpRequest->ProcessRequest();
+}
+
+void FElasticTelemetryHttpTransport::Pump()
+{
+	if (IsInGameThread())
+		FHttpModule::Get().GetHttpManager().Tick(0.0f);
+}
+
+FElasticTelemetryNullTransport::FElasticTelemetryNullTransport(const int32 InResponseCode)
+    : ResponseCode(InResponseCode)
+    , Requests(0)
+    , Documents(0)
+    , Bytes(0)
+{
+}
+
+void FElasticTelemetryNullTransport::Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete)
+{
+	static constexpr std::string_view BulkResponse     = "{\"took\":0,\"errors\":false,\"items\":[]}";
+	static constexpr std::string_view DocumentResponse = "{\"result\":\"created\"}";
+
+	const bool bBulk = Request.URL.EndsWith(TEXT("/_bulk"));
+	if (!Request.ContentEncoding)
+	{
+		// an action line and a source line per document
+		const std::string_view Body(reinterpret_cast<const char *>(Request.Body.GetData()), Request.Body.Num());
+		const uint64           Count = bBulk ? std::count(Body.begin(), Body.end(), '\n') / 2 : 1;
+		Documents.fetch_add(Count, std::memory_order_relaxed);
+	}
+	Requests.fetch_add(1, std::memory_order_relaxed);
+	Bytes.fetch_add(Request.Body.Num(), std::memory_order_relaxed);
+
+	const std::string_view Content     = bBulk ? BulkResponse : DocumentResponse;
+	const uint8 *          ContentData = reinterpret_cast<const uint8 *>(Content.data());
+
+	FElasticTelemetryTransportResponse Response;
+	Response.bWasSuccessful = true;
+	Response.Code           = ResponseCode;
+	Response.Content        = MakeArrayView(ContentData, static_cast<int32>(Content.size()));
+	Response.RequestBody    = Request.Body;
+	OnComplete(Response);
+}
+
+void FElasticTelemetryNullTransport::Reset()
+{
+	Requests.store(0, std::memory_order_relaxed);
+	Documents.store(0, std::memory_order_relaxed);
+	Bytes.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,97 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/// <summary>
+/// One request a writer sends. Headers are borrowed from the connection profile and only need to outlive Send().
+/// </summary>
+struct FElasticTelemetryTransportRequest
+{
+	const TCHAR *                            Verb = TEXT("POST");
+	FString                                  URL;
+	TConstArrayView<TPair<FString, FString>> Headers;
+	const TCHAR *                            ContentType     = nullptr;
+	const TCHAR *                            ContentEncoding = nullptr;
+	TArray<uint8>                            Body;
+};
+
+/// <summary>
+/// Outcome of a request, as seen by its completion. The views are only valid until the completion returns, copy
+/// whatever has to be kept.
+/// </summary>
+struct FElasticTelemetryTransportResponse
+{
+	bool                   bWasSuccessful    = false; // a response arrived, whatever its status code
+	int32                  Code              = 0;
+	double                 RetryAfterSeconds = 0.0; // delta-seconds form of Retry-After, 0 when absent
+	TConstArrayView<uint8> Content;
+	TConstArrayView<uint8> RequestBody;
+};
+
+/// <summary>
+/// What carries a writer's requests to ElasticSearch.
+///
+/// Writers use FHttpModule unless told otherwise. Swapping the transport takes the network out of measurements, so
+/// benchmarks and automation tests see the serialization, queueing and batching costs on their own. The writer calls
+/// Send() from its worker threads, the completion may be called from any thread, including inline from Send().
+/// </summary>
+class ELASTICTELEMETRY_API IElasticTelemetryTransport
+{
+  public:
+	using FOnComplete = TFunction<void(const FElasticTelemetryTransportResponse & Response)>;
+
+	virtual ~IElasticTelemetryTransport() = default;
+
+	virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) = 0;
+
+	/// <summary>
+	/// Delivers completions that wait for the calling thread, for a caller that blocks the thread they arrive on.
+	/// </summary>
+	virtual void Pump() {}
+};
+
+using FElasticTelemetryTransportRef = TSharedRef<IElasticTelemetryTransport, ESPMode::ThreadSafe>;
+
+/// <summary>
+/// Sends through FHttpModule, completions arrive on the game thread.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryHttpTransport : public IElasticTelemetryTransport
+{
+  public:
+	virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) override;
+
+	/// <summary>
+	/// Ticks the HTTP manager, on the game thread only.
+	/// </summary>
+	virtual void Pump() override;
+};
+
+/// <summary>
+/// Accepts every request on the spot without sending it anywhere, and counts what it was given.
+///
+/// Completes inline with ResponseCode, a _bulk request gets a response without item errors. Documents are counted
+/// from the uncompressed bodies only, a gzip body counts as bytes.
+/// </summary>
+class ELASTICTELEMETRY_API FElasticTelemetryNullTransport : public IElasticTelemetryTransport
+{
+  public:
+	explicit FElasticTelemetryNullTransport(int32 InResponseCode = 200);
+
+	virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) override;
+
+	inline uint64 GetRequests() const { return Requests.load(std::memory_order_relaxed); }
+	inline uint64 GetDocuments() const { return Documents.load(std::memory_order_relaxed); }
+	inline uint64 GetBytes() const { return Bytes.load(std::memory_order_relaxed); }
+
+	void Reset();
+
+  private:
+	int32               ResponseCode;
+	std::atomic<uint64> Requests;
+	std::atomic<uint64> Documents;
+	std::atomic<uint64> Bytes;
+};
@@ -2,49 +2,187 @@
 // MIT License, see LICENSE file for full details.
 
 #include "ElasticTelemetryWriter.h"
+#include "ElasticTelemetry.h"
+#include "ElasticTelemetryAtomicHistogram.h"
+#include "ElasticTelemetryBulkBuilder.h"
+#include "ElasticTelemetryBulkResponse.h"
+#include "ElasticTelemetryCircuitBreaker.h"
+#include "ElasticTelemetryConcurrencyController.h"
+#include "ElasticTelemetryCompression.h"
+#include "ElasticTelemetryConnectionProfile.h"
+#include "ElasticTelemetryCrashBuffer.h"
+#include "ElasticTelemetryEndpointPool.h"
+#include "ElasticTelemetryInFlightWindow.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryLogEntry.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetryMessagePool.h"
+#include "ElasticTelemetryMpscQueue.h"
+#include "ElasticTelemetrySettings.h"
+#include "ElasticTelemetrySpool.h"
+#include "ElasticTelemetryTransport.h"
 #include "Herald/ILogWriter.hpp"
 #include "Herald/WriterBuilder.hpp"
-#include "Interfaces/IHttpResponse.h"
-#include "HttpModule.h"
+#include "Containers/Queue.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeRWLock.h"
 
 // This is all hidden away from the Engine so, use C++ standard library types expected by Herald, no conversions needed
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-class ElasticTelemetryWriter : public Herald::ILogWriter, public FRunnable
+class ElasticTelemetryWriter : public IElasticTelemetryWriter
 {
   public:
+	// A worker thread with its own outbound queue, batch builder and request window. Shard 0 also looks after what
+	// is shared: held requests and the spool, per-document _bulk failures and node discovery. The priority lane is
+	// a shard of its own, see EnqueuePriority().
+	struct FShard : public FRunnable
+	{
+		FShard(ElasticTelemetryWriter & InWriter, const uint32 InIndex)
+		    : Writer(InWriter)
+		    , Index(InIndex)
+		    , OutboundMessages(InIndex == PriorityIndex ? PriorityQueueCapacity : OutboundQueueCapacity)
+		    , PendingDocuments(0)
+		    , PendingBytes(0)
+		    , QueueEvent(FPlatformProcess::GetSynchEventFromPool(false))
+		    , InFlight(InIndex == PriorityIndex ? 1 : 4)
+		    , bBusy(false)
+		    , Profile(InWriter.Connection.GetPublished())
+		    , Thread(nullptr)
+		{
+		}
+
+		virtual ~FShard() override { FPlatformProcess::ReturnSynchEventToPool(QueueEvent); }
+
+		void Start()
+		{
+			const FString Name = Index == 0               ? FString(TEXT("ElasticTelemetryWriter"))
+			                     : Index == PriorityIndex ? FString(TEXT("ElasticTelemetryWriterPriority"))
+			                                              : FString::Printf(TEXT("ElasticTelemetryWriter%u"), Index);
+			Thread             = FRunnableThread::Create(this, *Name);
+		}
+
+		void Join()
+		{
+			if (Thread)
+			{
+				Thread->WaitForCompletion();
+				delete Thread;
+				Thread = nullptr;
+			}
+		}
+
+		virtual uint32 Run() override { return Writer.Run(*this); }
+
+		inline bool IsPrimary() const { return Index == 0; }
+		inline bool IsPriority() const { return Index == PriorityIndex; }
+
+		ElasticTelemetryWriter &                 Writer;
+		const uint32                             Index;
+		TElasticTelemetryMpscQueue<std::string>  OutboundMessages;
+		FElasticTelemetryMessagePool             MessagePool; // blocks OutboundMessages lines are copied into
+		std::atomic<int64>                       PendingDocuments;
+		std::atomic<int64>                       PendingBytes;
+		FEvent *                                 QueueEvent;
+		FElasticTelemetryInFlightWindow          InFlight;
+		std::atomic<bool>                        bBusy;   // between waits, see IsDrained()
+		FElasticTelemetryGzip                    Gzip;    // worker thread only
+		FElasticTelemetryConnection::FProfileRef Profile; // worker thread only, see FElasticTelemetryConnection
+		FRunnableThread *                        Thread;
+	};
+
 	ElasticTelemetryWriter()
 	    : EndpointURL("")
 	    , Username("")
 	    , Password("")
 	    , IndexName("")
 	    , ConfigPairs()
-	    , CurrentPendingRequests(0)
-	    , MaximumPendingRequests(4)
-	    , WorkerThread(nullptr)
+	    , Connection()
+	    , bDiscoverEndpoints(false)
+	    , EndpointDiscoveryIntervalSeconds(300)
+	    , NextEndpointDiscoveryTime(0.0)
+	    , bEndpointDiscoveryInFlight(false)
+	    , FailedOverRequests(0)
+	    , bAdaptiveConcurrency(true)
+	    , InitialPendingRequests(4)
+	    , AdaptiveConcurrencyFloor(1)
+	    , AdaptiveConcurrencyCeiling(32)
+	    , bUseBulkAPI(true)
+	    , BulkMaxDocuments(500)
+	    , BulkMaxBytes(5 * 1024 * 1024)
+	    , FlushMaxDocuments(500)
+	    , FlushMaxBytes(1024 * 1024)
+	    , FlushLingerMilliseconds(100)
+	    , CompressionLevel(0)
+	    , CreatedAt(FPlatformTime::Seconds())
+	    , EnqueuedDocuments(0)
+	    , EnqueuedBytes(0)
+	    , UncompressedBytes(0)
+	    , CompressedBytes(0)
+	    , Requests(0)
+	    , ShardCount(0)
+	    , StartedShards(0)
+	    , bPriorityLane(false)
+	    , OutboundQueueMaxBytes(32 * 1024 * 1024)
+	    , OverflowPolicy(EElasticTelemetryOverflowPolicy::DropLowestSeverity)
+	    , DroppedNewest(0)
+	    , DroppedOldest(0)
+	    , DroppedLowSeverity(0)
+	    , ReportedNewest(0)
+	    , ReportedOldest(0)
+	    , ReportedLowSeverity(0)
+	    , RetryInitialBackoffMilliseconds(1000)
+	    , RetryMaxBackoffMilliseconds(60000)
+	    , RetryBytes(0)
+	    , RetryableFailures(0)
+	    , RejectedRequests(0)
+	    , DroppedRetries(0)
+	    , ResentRequests(0)
+	    , RequeuedDocuments(0)
+	    , DroppedPoisonDocuments(0)
+	    , UnreadableBulkResponses(0)
+	    , SpoolDirectory()
+	    , SpoolMaxBytes(256 * 1024 * 1024)
+	    , SpooledRequests(0)
+	    , SpoolBytes(0)
+	    , SpoolEvictedBytes(0)
+	    , SpoolDiscardedBytes(0)
+	    , bSpoolOpen(false)
+	    , CrashFlushLines(100)
+	    , CrashFlush(nullptr)
+	    , ArmedCrashFlush()
+	    , RetiredCrashFlushes()
+	    , CrashFatalLine()
+	    , CrashFatalBytes(0)
+	    , CrashFatalState(FatalLineEmpty)
+	    , bCrashFlushed(false)
+	    , bDraining(false)
+	    , InFlightDocuments(0)
+	    , DeliveredDocuments(0)
+	    , SpooledDocuments(0)
+	    , LostDocuments(0)
+	    , Lifetime(MakeShared<FLifetime, ESPMode::ThreadSafe>())
 	    , bStopWorkerThread(false)
-	    , QueueEvent(nullptr)
 	{
-		QueueEvent = FPlatformProcess::GetSynchEventFromPool(false);
-
-		// Start the worker thread
-		WorkerThread = FRunnableThread::Create(this, TEXT("ElasticTelemetryWriter"));
+		// Start the worker thread, WriterShards may add more
+		PriorityShard = MakeUnique<FShard>(*this, PriorityIndex);
+		SetShardCount(1);
+		SetPriorityLane(true);
 	}
 
 	virtual ~ElasticTelemetryWriter() override
 	{
 		Stop();
-		if (WorkerThread)
-		{
-			WorkerThread->WaitForCompletion();
-			delete WorkerThread;
-		}
+		JoinShards();
 
-		FPlatformProcess::ReturnSynchEventToPool(QueueEvent);
-		QueueEvent = nullptr;
+		// requests still in flight complete into nothing
+		FWriteScopeLock Guard(Lifetime->Mutex);
+		Lifetime->bAlive = false;
 	}
 
 	virtual ILogWriter & addConfigPair(const std::string & key, const std::string & value) override
@@ -63,71 +201,989 @@ class ElasticTelemetryWriter : public Herald::ILogWriter, public FRunnable
 				Password = value.c_str();
 			else if (key == "IndexName")
 				IndexName = value.c_str();
+			else if (key == "MaximumPendingRequests")
+			{
+				InitialPendingRequests = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+				ApplyConcurrencyConfig();
+			}
+			else if (key == "AdaptiveConcurrency")
+			{
+				bAdaptiveConcurrency = FCString::ToBool(UTF8_TO_TCHAR(value.c_str()));
+				ApplyConcurrencyConfig();
+			}
+			else if (key == "AdaptiveConcurrencyFloor")
+			{
+				AdaptiveConcurrencyFloor = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+				ApplyConcurrencyConfig();
+			}
+			else if (key == "AdaptiveConcurrencyCeiling")
+			{
+				AdaptiveConcurrencyCeiling = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+				ApplyConcurrencyConfig();
+			}
+			else if (key == "UseBulkAPI")
+				bUseBulkAPI = FCString::ToBool(UTF8_TO_TCHAR(value.c_str()));
+			else if (key == "BulkMaxDocuments")
+				BulkMaxDocuments = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "BulkMaxBytes")
+				BulkMaxBytes = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "FlushMaxDocuments")
+				FlushMaxDocuments = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "FlushMaxBytes")
+				FlushMaxBytes = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "FlushLingerMilliseconds")
+				FlushLingerMilliseconds = FMath::Max(0, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "CompressionLevel")
+				CompressionLevel = FMath::Clamp(FCString::Atoi(UTF8_TO_TCHAR(value.c_str())), 0, 9);
+			else if (key == "OutboundQueueMaxBytes")
+				OutboundQueueMaxBytes = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "OverflowPolicy")
+			{
+				if (value == "DropNewest")
+					OverflowPolicy = EElasticTelemetryOverflowPolicy::DropNewest;
+				else if (value == "DropOldest")
+					OverflowPolicy = EElasticTelemetryOverflowPolicy::DropOldest;
+				else
+					OverflowPolicy = EElasticTelemetryOverflowPolicy::DropLowestSeverity;
+			}
+			else if (key == "SpoolDirectory")
+			{
+				SpoolDirectory = UTF8_TO_TCHAR(value.c_str());
+				ArmCrashFlush();
+
+				// the primary worker opens the spool and replays what earlier runs left, without waiting for a line
+				Shards[0]->QueueEvent->Trigger();
+			}
+			else if (key == "CrashFlushLines")
+			{
+				CrashFlushLines = FMath::Max(0, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+				ArmCrashFlush();
+			}
+			else if (key == "SpoolMaxBytes")
+				SpoolMaxBytes = FMath::Max(0, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "RetryInitialBackoffMilliseconds")
+				RetryInitialBackoffMilliseconds = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "RetryMaxBackoffMilliseconds")
+				RetryMaxBackoffMilliseconds = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "DiscoverEndpoints")
+				bDiscoverEndpoints = FCString::ToBool(UTF8_TO_TCHAR(value.c_str()));
+			else if (key == "EndpointDiscoveryIntervalSeconds")
+				EndpointDiscoveryIntervalSeconds = FMath::Max(1, FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "UseDataStream")
+			{
+				Connection.SetDataStream(FCString::ToBool(UTF8_TO_TCHAR(value.c_str())));
+				ArmCrashFlush();
+			}
+			else if (key == "WriterShards")
+				SetShardCount(FCString::Atoi(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "PriorityLane")
+				SetPriorityLane(FCString::ToBool(UTF8_TO_TCHAR(value.c_str())));
+			else if (key == "Transport")
+			{
+				// Null accepts everything without sending it, to measure the writer without a cluster
+				if (value == "Null")
+					Connection.SetTransport(MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>());
+				else
+					Connection.SetTransport(MakeShared<FElasticTelemetryHttpTransport, ESPMode::ThreadSafe>());
+			}
+
+			// the same backoff applies to each node and, once they are all down, to the cluster as a whole
+			Circuit.SetBackoff(RetryInitialBackoffMilliseconds / 1000.0, RetryMaxBackoffMilliseconds / 1000.0);
+			Connection.SetBackoff(RetryInitialBackoffMilliseconds / 1000.0, RetryMaxBackoffMilliseconds / 1000.0);
 
-			// ensure endpoint URL ends with a trailing slash
-			if (EndpointURL.Len() > 0 && EndpointURL[EndpointURL.Len() - 1] != '/')
-				EndpointURL += '/';
+			// resolve URLs and headers now rather than for every request, EndpointURL may list several nodes
+			if (key == "EndpointURL" || key == "Username" || key == "Password" || key == "IndexName")
+				Connection.Publish(EndpointURL, IndexName, Username, Password);
 		}
 		return *this;
 	}
 
 	// This is going to happen in the same thread as the engine's GLog call context
 	// so the write() method will merely queue up the message for the worker thread
-	// to dispatch to the ElasticSearch server without blocking the game on I/O
+	// to dispatch to the ElasticSearch server without blocking the game on I/O.
+	// Msg is the transformer's reusable buffer, it is copied into a block from the shard's pool.
 	virtual void write(const std::string & Msg) override
 	{
-		if (bStopWorkerThread)
+		// a line logged from inside a transport's Send() would be sent, and logged about, again and again
+		if (bStopWorkerThread || IsSendingOnThisThread())
+			return;
+
+		FElasticTelemetryMessagePool & Pool     = GetProducerShard().MessagePool;
+		std::string                    Document = Pool.Acquire(Msg);
+		if (!Enqueue(MoveTemp(Document), FElasticTelemetryLogLevelScope::GetCurrent()))
+			Pool.Release(MoveTemp(Document)); // refused, and left untouched
+	}
+
+	// Lock-free, any number of threads can be logging at the same time. When the queue is over its memory budget,
+	// losing lines is better than stalling the game or growing without bound.
+	bool Enqueue(std::string && Document, const Herald::LogLevels Level)
+	{
+		// the process is about to go down. The line is still sent, a copy waits for the crash handler's flush.
+		if (Level == Herald::LogLevels::Fatal)
+			KeepFatalLine(Document);
+
+		const int64 Bytes = static_cast<int64>(Document.size());
+		if (bPriorityLane && IsPriorityLevel(Level) && EnqueuePriority(MoveTemp(Document)))
+		{
+			CountEnqueued(Bytes);
+			return true;
+		}
+
+		FShard & Shard = GetProducerShard();
+		if (!MakeRoom(Shard, Bytes, Level))
+			return false;
+
+		while (!Shard.OutboundMessages.TryEnqueue(MoveTemp(Document)))
+		{
+			// the ring is out of slots rather than bytes, the same policy applies
+			if (!MakeRoomForSlot(Shard, Level))
+				return false;
+		}
+
+		// Only wake the worker when the queue goes from empty to non-empty (to start the linger timer) or when the
+		// batch crosses a flush threshold. Everything in between rides along for free.
+		const int64 PreviousDocs  = Shard.PendingDocuments.fetch_add(1);
+		const int64 PreviousBytes = Shard.PendingBytes.fetch_add(Bytes);
+		if (PreviousDocs <= 0 || (PreviousDocs < FlushMaxDocuments && PreviousDocs + 1 >= FlushMaxDocuments) ||
+		    (PreviousBytes < FlushMaxBytes && PreviousBytes + Bytes >= FlushMaxBytes))
+		{
+			Shard.QueueEvent->Trigger();
+		}
+		CountEnqueued(Bytes);
+		return true;
+	}
+
+	void CountEnqueued(const int64 Bytes)
+	{
+		EnqueuedDocuments.fetch_add(1, std::memory_order_relaxed);
+		EnqueuedBytes.fetch_add(static_cast<uint64>(Bytes), std::memory_order_relaxed);
+	}
+
+	static bool IsPriorityLevel(const Herald::LogLevels Level)
+	{
+		return Level == Herald::LogLevels::Error || Level == Herald::LogLevels::Fatal;
+	}
+
+	// Errors should not wait behind thousands of verbose lines, or for a slot those lines hold. They go to a small
+	// queue of their own with its own worker and request slot, and are sent the moment they arrive. When the lane
+	// is full the line takes the normal path, Document is left untouched then.
+	bool EnqueuePriority(std::string && Document)
+	{
+		FShard &    Lane  = *PriorityShard;
+		const int64 Bytes = static_cast<int64>(Document.size());
+		if (Lane.PendingBytes.load() + Bytes > PriorityQueueMaxBytes ||
+		    !Lane.OutboundMessages.TryEnqueue(MoveTemp(Document)))
+			return false;
+
+		Lane.PendingDocuments.fetch_add(1);
+		Lane.PendingBytes.fetch_add(Bytes);
+		Lane.QueueEvent->Trigger();
+		return true;
+	}
+
+	// Set on a worker thread for the duration of a transport's Send(), which may complete inline. Each thread only
+	// ever reads its own flag, so there is nothing to race on.
+	static bool & IsSendingOnThisThread()
+	{
+		static thread_local bool bSending = false;
+		return bSending;
+	}
+
+	// A thread is numbered the first time it logs and always lands on the same shard, so its lines stay in order.
+	// Numbering rather than hashing thread ids spreads consecutive threads evenly.
+	FShard & GetProducerShard()
+	{
+		static std::atomic<uint32>       NextProducer(0);
+		static thread_local const uint32 Producer = NextProducer.fetch_add(1, std::memory_order_relaxed);
+
+		const uint32 Count = ShardCount.load(std::memory_order_acquire);
+		return *Shards[Count > 1 ? Producer % Count : 0];
+	}
+
+	// Starts shards up to Count. Lowering the count only stops routing new lines to the shards past it, they still
+	// send whatever they hold. Under ConfigMutex, or from the constructor.
+	void SetShardCount(const int32 Count)
+	{
+		const uint32 NewCount = static_cast<uint32>(FMath::Clamp(Count, 1, static_cast<int32>(MaxShards)));
+		for (uint32 Index = StartedShards.load(); Index < NewCount; ++Index)
+		{
+			Shards[Index] = MakeUnique<FShard>(*this, Index);
+			StartedShards.store(Index + 1, std::memory_order_release);
+			Shards[Index]->Start();
+		}
+		ShardCount.store(NewCount, std::memory_order_release);
+		ApplyConcurrencyConfig();
+	}
+
+	// The lane's worker starts the first time it is enabled. Disabling it only routes errors through the normal
+	// path again. Under ConfigMutex, or from the constructor.
+	void SetPriorityLane(const bool bEnable)
+	{
+		if (bEnable && !PriorityShard->Thread)
+			PriorityShard->Start();
+		bPriorityLane = bEnable;
+	}
+
+	// Reserves what FlushForCrash() needs and picks its segment, each time the spool, the line count or the action
+	// line changes. The crash path does not take ConfigMutex, so the new state is built aside and published whole,
+	// a flush already running keeps the one it loaded. Under ConfigMutex, never on the crash path.
+	void ArmCrashFlush()
+	{
+		TUniquePtr<FCrashFlush> Armed;
+		if (CrashFlushLines > 0 && !SpoolDirectory.IsEmpty() &&
+		    IFileManager::Get().MakeDirectory(*SpoolDirectory, true))
+		{
+			Armed = MakeUnique<FCrashFlush>();
+			Armed->Buffer.Reserve(CrashFlushLines, CrashFlushMaxBytes, CrashDocumentMaxBytes);
+			Armed->SegmentPath = FElasticTelemetrySpool::GetCrashSegmentPath(SpoolDirectory);
+			Armed->bCreate     = Connection.GetPublished()->bDataStream;
+
+			if (CrashFatalLine.Num() == 0)
+				CrashFatalLine.SetNumUninitialized(CrashDocumentMaxBytes);
+		}
+		CrashFlush.store(Armed.Get());
+
+		// A flush marks itself before loading CrashFlush. Not marked yet, it will load the new state, otherwise it
+		// may hold the previous one, which must then outlive it.
+		if (bCrashFlushed.load() && ArmedCrashFlush)
+			RetiredCrashFlushes.Add(MoveTemp(ArmedCrashFlush));
+		ArmedCrashFlush = MoveTemp(Armed);
+	}
+
+	// Copies the first Fatal line aside for FlushForCrash(), from the thread logging it, once the crash flush is
+	// armed. Lines that do not fit in the reserved memory are not kept.
+	void KeepFatalLine(const std::string_view & Document)
+	{
+		int32 Expected = FatalLineEmpty;
+		if (!CrashFlush.load(std::memory_order_acquire) ||
+		    !CrashFatalState.compare_exchange_strong(Expected, FatalLineCopying))
 			return;
 
+		CrashFatalBytes = Document.size() <= static_cast<size_t>(CrashFatalLine.Num()) ? Document.size() : 0;
+		FMemory::Memcpy(CrashFatalLine.GetData(), Document.data(), CrashFatalBytes);
+		CrashFatalState.store(FatalLineCopied, std::memory_order_release);
+	}
+
+	virtual bool FlushForCrash(const std::string_view & Document) override
+	{
+		// once, from the crash handler, with what ArmCrashFlush() published last
+		if (!CrashFlush.load() || bCrashFlushed.exchange(true))
+			return false;
+		FCrashFlush * const Armed = CrashFlush.load();
+		if (!Armed)
+			return false;
+
+		// the Fatal line goes just before Document. Still queued on its way out, it is not added twice.
+		const std::string_view Fatal = CrashFatalState.load(std::memory_order_acquire) == FatalLineCopied
+		                                   ? std::string_view(CrashFatalLine.GetData(), CrashFatalBytes)
+		                                   : std::string_view();
+
+		// moving a line out of the queue hands over its buffer, it does not allocate. The shards are not stopped
+		// first, a crashing process cannot wait for them, so a line one of them dequeues meanwhile is not recorded.
+		Armed->Buffer.Reset();
+		ForEachShard([Armed, &Fatal](FShard & Shard) {
+			std::string Msg;
+			while (Shard.OutboundMessages.TryDequeue(Msg))
+			{
+				Shard.PendingDocuments.fetch_sub(1);
+				Shard.PendingBytes.fetch_sub(static_cast<int64>(Msg.size()));
+				if (Fatal.empty() || std::string_view(Msg) != Fatal)
+					Armed->Buffer.AddLine(Msg);
+			}
+		});
+
+		const TArrayView<const uint8> Body =
+		    Armed->Buffer.BuildBulkBody(FElasticTelemetryBulkBuilder::ActionLine(Armed->bCreate), Fatal, Document);
+		const uint32 Documents = Armed->Buffer.GetLineCount() + (Fatal.empty() ? 0 : 1) + (Document.empty() ? 0 : 1);
+		return FElasticTelemetrySpool::WriteSegment(
+		    *Armed->SegmentPath, FElasticTelemetrySpool::Bulk, Body.GetData(), Body.Num(), Documents);
+	}
+
+	// The shards producers are routed to, then the priority lane
+	template <typename TFunction>
+	void ForEachShard(TFunction && Function) const
+	{
+		const uint32 Started = StartedShards.load(std::memory_order_acquire);
+		for (uint32 Index = 0; Index < Started; ++Index)
 		{
-			FScopeLock Lock(&QueueMutex);
-			OutboundMessages.Enqueue(Msg);
+			Function(*Shards[Index]);
 		}
-		QueueEvent->Trigger();
+		Function(*PriorityShard);
 	}
 
-	virtual uint32 Run() override
+	uint32 Run(FShard & Shard)
 	{
-		std::vector<FString> BatchMessages;
+		std::vector<std::string>     BatchMessages;
+		FElasticTelemetryBulkBuilder Bulk(BulkMaxDocuments, BulkMaxBytes);
 
 		while (!bStopWorkerThread)
 		{
-			QueueEvent->Wait();
+			WaitForFlush(Shard);
 
 			if (bStopWorkerThread)
 				break;
 
-			bool bHasMessage = false;
+			Shard.bBusy = true;
+			if (Shard.IsPrimary())
+			{
+				HoldFailedRequests();
+				RequeueFailedBulkItems();
+				DiscoverEndpoints(Shard);
+			}
+
+			// While the circuit is open, lines wait in the bounded outbound queue, unless there is a spool to put them
+			if (Circuit.IsClosed() || bSpoolOpen)
+			{
+				DrainOutboundMessages(Shard, BatchMessages);
+				SendBatch(Shard, BatchMessages, Bulk);
+				RecycleMessages(Shard, BatchMessages);
+			}
+
+			if (Shard.IsPrimary())
+			{
+				ReportDropsOnceRelieved();
+				ResendHeldRequests(Shard);
+			}
+			Shard.bBusy = false;
+		}
+		return 0;
+	}
+
+	virtual FElasticTelemetryWriterStats GetStats() const override
+	{
+		FElasticTelemetryWriterStats Stats;
+		Stats.UptimeSeconds     = FPlatformTime::Seconds() - CreatedAt;
+		Stats.EnqueuedDocuments = EnqueuedDocuments.load(std::memory_order_relaxed);
+		Stats.EnqueuedBytes     = EnqueuedBytes.load(std::memory_order_relaxed);
+		BatchDocuments.Snapshot(Stats.BatchDocuments);
+		BatchBytes.Snapshot(Stats.BatchBytes);
+		Stats.UncompressedBytes = UncompressedBytes.load(std::memory_order_relaxed);
+		Stats.CompressedBytes   = CompressedBytes.load(std::memory_order_relaxed);
+		Stats.Requests          = Requests.load(std::memory_order_relaxed);
+		RequestLatency.Snapshot(Stats.RequestLatencyMicroseconds);
+
+		Stats.WriterShards = ShardCount.load(std::memory_order_relaxed);
+
+		ForEachShard([&Stats](const FShard & Shard) {
+			Stats.QueuedMessages += Shard.OutboundMessages.Num();
+			Stats.QueuedBytes += static_cast<uint64>(FMath::Max<int64>(0, Shard.PendingBytes.load()));
+			Stats.InFlightRequests += Shard.InFlight.GetInFlight();
+			Stats.PeakInFlightRequests += Shard.InFlight.GetPeak();
+			Stats.InFlightWaits += Shard.InFlight.GetWaits();
+			Stats.InFlightWaitSeconds += Shard.InFlight.GetWaitSeconds();
+			Stats.MaxInFlightWaitSeconds = FMath::Max(Stats.MaxInFlightWaitSeconds, Shard.InFlight.GetMaxWaitSeconds());
+			Stats.MessageBlocksAllocated += Shard.MessagePool.GetAllocated();
+			Stats.MessageBlocksReused += Shard.MessagePool.GetReused();
+		});
+
+		Stats.DroppedNewest      = DroppedNewest.load(std::memory_order_relaxed);
+		Stats.DroppedOldest      = DroppedOldest.load(std::memory_order_relaxed);
+		Stats.DroppedLowSeverity = DroppedLowSeverity.load(std::memory_order_relaxed);
+
+		Stats.MaximumPendingRequests = Concurrency.GetLimit();
+		Stats.ConcurrencyDecreases   = Concurrency.GetDecreases();
+		Stats.SmoothedLatencySeconds = Concurrency.GetSmoothedLatency();
+		Stats.BaselineLatencySeconds = Concurrency.GetBaselineLatency();
+
+		const FElasticTelemetryConnection::FProfileRef Profile = Connection.GetPublished();
+		Stats.Endpoints          = Profile->Endpoints->GetEndpoints().Num();
+		Stats.AvailableEndpoints = Profile->Endpoints->GetAvailableCount(FPlatformTime::Seconds());
+		Stats.FailedOverRequests = FailedOverRequests.load(std::memory_order_relaxed);
+
+		Stats.bCircuitOpen      = !Circuit.IsClosed();
+		Stats.RetryableFailures = RetryableFailures.load(std::memory_order_relaxed);
+		Stats.ResentRequests    = ResentRequests.load(std::memory_order_relaxed);
+		Stats.RejectedRequests  = RejectedRequests.load(std::memory_order_relaxed);
+		Stats.DroppedRetries    = DroppedRetries.load(std::memory_order_relaxed);
+
+		Stats.RequeuedDocuments       = RequeuedDocuments.load(std::memory_order_relaxed);
+		Stats.DroppedPoisonDocuments  = DroppedPoisonDocuments.load(std::memory_order_relaxed);
+		Stats.UnreadableBulkResponses = UnreadableBulkResponses.load(std::memory_order_relaxed);
+
+		Stats.SpoolBytes          = SpoolBytes.load(std::memory_order_relaxed);
+		Stats.SpooledRequests     = SpooledRequests.load(std::memory_order_relaxed);
+		Stats.SpoolEvictedBytes   = SpoolEvictedBytes.load(std::memory_order_relaxed);
+		Stats.SpoolDiscardedBytes = SpoolDiscardedBytes.load(std::memory_order_relaxed);
+		return Stats;
+	}
+
+	virtual void SetTransport(FElasticTelemetryTransportRef Transport) override { Connection.SetTransport(Transport); }
+
+	virtual void SetJsonTransformer(const Herald::ILogTransformerPtr & Transformer) override
+	{
+		FScopeLock Lock(&ConfigMutex);
+		JsonTransformer = Transformer;
+	}
+
+	void Stop()
+	{
+		bStopWorkerThread = true;
+		ForEachShard([](FShard & Shard) {
+			Shard.QueueEvent->Trigger();
+			Shard.InFlight.Cancel();
+		});
+	}
+
+	void JoinShards()
+	{
+		ForEachShard([](FShard & Shard) { Shard.Join(); });
+	}
+
+	virtual FElasticTelemetryDrainReport Drain(const double Deadline) override
+	{
+		FElasticTelemetryDrainReport Report;
+		if (bStopWorkerThread)
+			return Report;
+
+		const double StartTime = FPlatformTime::Seconds();
+		const uint64 Delivered = DeliveredDocuments.load();
+		const uint64 Spooled   = SpooledDocuments.load();
+		const uint64 Lost      = LostDocuments.load() + GetStats().GetTotalDropped();
+
+		// the workers send what they have without lingering, and leave the spool for the next launch
+		bDraining = true;
+		ForEachShard([](FShard & Shard) { Shard.QueueEvent->Trigger(); });
+
+		// completions may need this thread, an HTTP request only completes when the game thread ticks the manager
+		while (!IsDrained() && FPlatformTime::Seconds() < Deadline)
+		{
+			Connection.GetPublished()->Transport->Pump();
+			FPlatformProcess::Sleep(0.001f);
+		}
+		Report.bTimedOut = !IsDrained();
+
+		Stop();
+		JoinShards();
+		SpillRemaining();
+
+		Report.FlushedDocuments = DeliveredDocuments.load() - Delivered;
+		Report.SpilledDocuments = SpooledDocuments.load() - Spooled;
+		Report.LostDocuments    = LostDocuments.load() + GetStats().GetTotalDropped() - Lost +
+		                       static_cast<uint64>(FMath::Max<int64>(0, InFlightDocuments.load()));
+		Report.Seconds          = FPlatformTime::Seconds() - StartTime;
+		return Report;
+	}
+
+	// Nothing queued, being sent or held in memory for retry. What is in the spool stays there.
+	bool IsDrained() const
+	{
+		bool bIdle = true;
+		ForEachShard([&bIdle](const FShard & Shard) {
+			bIdle &= !Shard.bBusy && Shard.PendingDocuments.load() <= 0 && Shard.InFlight.GetInFlight() == 0;
+		});
+		return bIdle && FailedRequests.IsEmpty() && BulkItemErrors.IsEmpty() && RetryBytes.load() == 0;
+	}
+
+	// Once the workers have stopped, on the thread that drains. Lines still queued are packed into _bulk bodies and
+	// held like failed requests, which puts them in the spool when there is one and loses them otherwise.
+	void SpillRemaining()
+	{
+		HoldFailedRequests();
+
+		FElasticTelemetryBulkBuilder Bulk(BulkMaxDocuments, BulkMaxBytes);
+		Bulk.SetCreate(Connection.GetPublished()->bDataStream);
+		auto Spill = [this, &Bulk]() {
+			const uint32 Documents = Bulk.GetDocumentCount();
+			HoldForRetry(FElasticTelemetrySpool::Bulk, Documents, Bulk.DetachBody());
+		};
 
+		ForEachShard([&Bulk, &Spill](FShard & Shard) {
 			std::string Msg;
+			while (Shard.OutboundMessages.TryDequeue(Msg))
 			{
-				FScopeLock Lock(&QueueMutex);
-				while (OutboundMessages.IsEmpty() == false)
+				if (!Bulk.CanAppend(Msg))
+					Spill();
+				Bulk.Append(Msg);
+			}
+		});
+		if (!Bulk.IsEmpty())
+			Spill();
+
+		FElasticTelemetrySpool::FRecord Held;
+		while (RetryRequests.Dequeue(Held))
+		{
+			RetryBytes -= Held.Payload.Num();
+			LostDocuments.fetch_add(Held.Documents, std::memory_order_relaxed);
+		}
+	}
+
+	// Sleeps until there is something worth sending: either the batch reached FlushMaxDocuments/FlushMaxBytes,
+	// or the oldest queued message has lingered for FlushLingerMilliseconds.
+	void WaitForFlush(FShard & Shard)
+	{
+		const bool bHoldingQueue = !Circuit.IsClosed() && !bSpoolOpen;
+		if (bHoldingQueue || Shard.PendingDocuments.load() <= 0)
+		{
+			// idle, the next write() or request completion will wake the worker, or it is time to resend
+			Shard.QueueEvent->Wait(GetIdleWaitMilliseconds(Shard));
+			if (bHoldingQueue || Shard.PendingDocuments.load() <= 0)
+				return;
+		}
+
+		const double LingerSeconds = FlushLingerMilliseconds.load() / 1000.0;
+		const double FlushDeadline = FPlatformTime::Seconds() + LingerSeconds;
+		while (!bStopWorkerThread && !bDraining && !Shard.IsPriority() && !IsFlushThresholdReached(Shard))
+		{
+			const double Remaining = FlushDeadline - FPlatformTime::Seconds();
+			if (Remaining <= 0.0)
+				break;
+			Shard.QueueEvent->Wait(FMath::Max(1u, static_cast<uint32>(Remaining * 1000.0)));
+		}
+	}
+
+	bool IsFlushThresholdReached(const FShard & Shard) const
+	{
+		return Shard.PendingDocuments.load() >= FlushMaxDocuments || Shard.PendingBytes.load() >= FlushMaxBytes;
+	}
+
+	void DrainOutboundMessages(FShard & Shard, std::vector<std::string> & BatchMessages)
+	{
+		int64       DrainedBytes = 0;
+		std::string Msg;
+		while (Shard.OutboundMessages.TryDequeue(Msg))
+		{
+			DrainedBytes += static_cast<int64>(Msg.size());
+			BatchMessages.push_back(std::move(Msg));
+		}
+		Shard.PendingDocuments.fetch_sub(static_cast<int64>(BatchMessages.size()));
+		Shard.PendingBytes.fetch_sub(DrainedBytes);
+	}
+
+	// The lines are in request bodies by now, their blocks go back to the pool for the next lines logged. Nobody
+	// takes blocks from the priority lane's pool, its lines came from the producer shards, so its blocks go to
+	// shard 0.
+	void RecycleMessages(FShard & Shard, std::vector<std::string> & BatchMessages)
+	{
+		FElasticTelemetryMessagePool & Pool = Shard.IsPriority() ? Shards[0]->MessagePool : Shard.MessagePool;
+		for (std::string & Msg : BatchMessages)
+		{
+			Pool.Release(MoveTemp(Msg));
+		}
+		BatchMessages.clear();
+	}
+
+	// Fraction of OutboundQueueMaxBytes the queue may reach before lines of Level are refused under
+	// DropLowestSeverity. Errors and above are never refused, they push out the oldest lines instead.
+	static double SeverityWatermark(const Herald::LogLevels Level)
+	{
+		switch (Level)
+		{
+		case Herald::LogLevels::Analysis:
+		case Herald::LogLevels::Trace:
+			return 0.5;
+		case Herald::LogLevels::Debug:
+			return 0.7;
+		case Herald::LogLevels::Info:
+			return 0.85;
+		case Herald::LogLevels::Warning:
+			return 0.95;
+		default:
+			return 1.0;
+		}
+	}
+
+	// Applies the overflow policy for a line of Bytes at Level. May evict older lines from the same shard. Returns
+	// false when the line itself must be dropped. OutboundQueueMaxBytes is shared out evenly between the shards.
+	bool MakeRoom(FShard & Shard, const int64 Bytes, const Herald::LogLevels Level)
+	{
+		const int64          Budget       = OutboundQueueMaxBytes / ShardCount.load(std::memory_order_relaxed);
+		std::atomic<int64> & PendingBytes = Shard.PendingBytes;
+		switch (OverflowPolicy.load(std::memory_order_relaxed))
+		{
+		case EElasticTelemetryOverflowPolicy::DropNewest:
+			if (PendingBytes.load() + Bytes > Budget)
+			{
+				DroppedNewest.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			return true;
+
+		case EElasticTelemetryOverflowPolicy::DropOldest:
+			while (PendingBytes.load() + Bytes > Budget && EvictOldest(Shard, DroppedOldest))
+			{
+			}
+			return true;
+
+		case EElasticTelemetryOverflowPolicy::DropLowestSeverity:
+		default:
+		{
+			const double Watermark = SeverityWatermark(Level);
+			if (Watermark < 1.0)
+			{
+				if (PendingBytes.load() + Bytes > static_cast<int64>(Budget * Watermark))
 				{
-					Msg.clear();
-					bHasMessage = OutboundMessages.Dequeue(Msg);
-					if (bHasMessage)
-						BatchMessages.push_back(FString(Msg.c_str()));
+					DroppedLowSeverity.fetch_add(1, std::memory_order_relaxed);
+					return false;
 				}
+				return true;
 			}
 
-			for (const auto i : BatchMessages)
+			while (PendingBytes.load() + Bytes > Budget && EvictOldest(Shard, DroppedLowSeverity))
 			{
-				// Send the message to the ElasticSearch server
-				// using the HTTP module
-				// LogUsingHttpModule(i, IndexName, nullptr);
-				SendHttpRequest(*i);
 			}
-			BatchMessages.clear();
+			return true;
+		}
 		}
-		return 0;
 	}
 
-	virtual void Stop() override
+	// Same as MakeRoom() for when the ring has run out of slots
+	bool MakeRoomForSlot(FShard & Shard, const Herald::LogLevels Level)
 	{
-		bStopWorkerThread = true;
-		if (QueueEvent)
-			QueueEvent->Trigger();
+		switch (OverflowPolicy.load(std::memory_order_relaxed))
+		{
+		case EElasticTelemetryOverflowPolicy::DropNewest:
+			DroppedNewest.fetch_add(1, std::memory_order_relaxed);
+			return false;
+
+		case EElasticTelemetryOverflowPolicy::DropOldest:
+			EvictOldest(Shard, DroppedOldest);
+			return true;
+
+		case EElasticTelemetryOverflowPolicy::DropLowestSeverity:
+		default:
+			if (SeverityWatermark(Level) < 1.0)
+			{
+				DroppedLowSeverity.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			EvictOldest(Shard, DroppedLowSeverity);
+			return true;
+		}
+	}
+
+	bool EvictOldest(FShard & Shard, std::atomic<uint64> & DropCounter)
+	{
+		std::string Evicted;
+		if (!Shard.OutboundMessages.TryDequeue(Evicted))
+			return false;
+
+		Shard.PendingDocuments.fetch_sub(1);
+		Shard.PendingBytes.fetch_sub(static_cast<int64>(Evicted.size()));
+		DropCounter.fetch_add(1, std::memory_order_relaxed);
+		Shard.MessagePool.Release(MoveTemp(Evicted));
+		return true;
+	}
+
+	// Once the queues are back under half of their budget, leave a record in this writer's own index of how much
+	// was lost since the last one. The document is the writer's own rather than a UE_LOG line, which would go to the
+	// log index whatever writer dropped the lines, be filtered out with TelemetryLog or Warning, and could itself be
+	// dropped by a log writer still under pressure. Runs every time the primary worker wakes, so it reads the
+	// counters it needs rather than a whole GetStats().
+	void ReportDropsOnceRelieved()
+	{
+		const uint64 Newest      = DroppedNewest.load(std::memory_order_relaxed) - ReportedNewest;
+		const uint64 Oldest      = DroppedOldest.load(std::memory_order_relaxed) - ReportedOldest;
+		const uint64 LowSeverity = DroppedLowSeverity.load(std::memory_order_relaxed) - ReportedLowSeverity;
+		const uint64 Total       = Newest + Oldest + LowSeverity;
+		if (Total == 0)
+			return;
+
+		int64 QueuedBytes = 0;
+		ForEachShard([&QueuedBytes](const FShard & Queued) {
+			QueuedBytes += FMath::Max<int64>(0, Queued.PendingBytes.load());
+		});
+		if (QueuedBytes > OutboundQueueMaxBytes / 2)
+			return;
+
+		const std::string               Message = std::to_string(Total) + " messages dropped";
+		const FElasticTelemetryLogEntry Entry(Herald::LogLevels::Warning, Message, "DroppedNewest", Newest,
+		    "DroppedOldest", Oldest, "DroppedLowSeverity", LowSeverity);
+		std::string                     Report;
+		Herald::ILogTransformerPtr      Transformer;
+		{
+			FScopeLock Lock(&ConfigMutex);
+			Transformer = JsonTransformer.lock();
+		}
+		if (Transformer)
+			AsElasticTelemetryJsonTransformer(Transformer)->Format(Entry, Report);
+		else
+			FElasticTelemetryJsonTransformer().Format(Entry, Report);
+
+		// past the budget and the watermarks, only a ring out of slots turns it away, to be tried again next time
+		if (!Requeue(MoveTemp(Report)))
+			return;
+		ReportedNewest += Newest;
+		ReportedOldest += Oldest;
+		ReportedLowSeverity += LowSeverity;
+	}
+
+	// Opens, moves or closes the spool to follow SpoolDirectory, then holds on to request bodies that failed with a
+	// retryable error. Runs on the worker thread, disk I/O never happens on a thread that logs. Setting
+	// SpoolDirectory wakes the worker, so a spool left by an earlier run is opened, and replayed, straight away.
+	void HoldFailedRequests()
+	{
+		FString Directory;
+		{
+			FScopeLock Lock(&ConfigMutex);
+			Directory = SpoolDirectory;
+		}
+		if (Directory != Spool.GetDirectory())
+		{
+			Spool.Close();
+			if (!Directory.IsEmpty() && !Spool.Open(Directory, SpoolMaxBytes))
+			{
+				UE_LOG(TelemetryLog, Warning, TEXT("ElasticTelemetry could not open spool directory %s"), *Directory);
+			}
+			bSpoolOpen = Spool.IsOpen();
+		}
+
+		FElasticTelemetrySpool::FRecord Failed;
+		while (FailedRequests.Dequeue(Failed))
+		{
+			HoldForRetry(Failed.Flags, Failed.Documents, MoveTemp(Failed.Payload));
+		}
+	}
+
+	// Requests waiting for the endpoint to come back go to the disk spool when there is one. Otherwise they wait in
+	// memory, bounded by OutboundQueueMaxBytes, oldest dropped first.
+	void HoldForRetry(const uint32 Flags, const uint32 Documents, TArray<uint8> && Payload)
+	{
+		if (Spool.IsOpen())
+		{
+			if (Spool.Append(Flags, Payload.GetData(), Payload.Num(), Documents))
+			{
+				SpooledRequests.fetch_add(1, std::memory_order_relaxed);
+				SpooledDocuments.fetch_add(Documents, std::memory_order_relaxed);
+			}
+			else
+			{
+				LostDocuments.fetch_add(Documents, std::memory_order_relaxed);
+			}
+			PublishSpoolStats();
+			return;
+		}
+
+		// a compressed body still has the capacity deflateBound() asked for, do not keep that around
+		Payload.Shrink();
+
+		FElasticTelemetrySpool::FRecord Evicted;
+		while (RetryBytes + Payload.Num() > OutboundQueueMaxBytes && RetryRequests.Dequeue(Evicted))
+		{
+			RetryBytes -= Evicted.Payload.Num();
+			DroppedRetries.fetch_add(1, std::memory_order_relaxed);
+			LostDocuments.fetch_add(Evicted.Documents, std::memory_order_relaxed);
+		}
+		RetryBytes += Payload.Num();
+		RetryRequests.Enqueue({Flags, MoveTemp(Payload), Documents});
+	}
+
+	bool HasHeldRequests() const
+	{
+		return !FailedRequests.IsEmpty() || !RetryRequests.IsEmpty() || (Spool.IsOpen() && !Spool.IsEmpty());
+	}
+
+	// Sends held requests oldest first. While the circuit is open nothing is sent until the backoff elapses, then a
+	// single request probes the endpoint and its success reopens the flood gates. First shard only.
+	void ResendHeldRequests(FShard & Shard)
+	{
+		if (!Circuit.IsClosed())
+		{
+			if (Circuit.TryBeginProbe(FPlatformTime::Seconds()) && !ResendNext(Shard))
+			{
+				// nothing held to probe with, let the next live request find out
+				Circuit.RecordSuccess();
+			}
+			return;
+		}
+
+		// resends share the request window with live traffic rather than starving it
+		while (!bStopWorkerThread && Shard.InFlight.HasFreeSlot() && ResendNext(Shard))
+		{
+		}
+	}
+
+	bool ResendNext(FShard & Shard)
+	{
+		FElasticTelemetrySpool::FRecord Record;
+		if (RetryRequests.Dequeue(Record))
+		{
+			RetryBytes -= Record.Payload.Num();
+		}
+		else
+		{
+			// a drain leaves the spool for the next launch
+			const bool bRead = !bDraining && Spool.IsOpen() && Spool.ReadNext(Record);
+			PublishSpoolStats();
+			if (!bRead)
+				return false;
+		}
+
+		ResentRequests.fetch_add(1, std::memory_order_relaxed);
+		SendPayload(Shard, Record.Flags, Record.Documents, MoveTemp(Record.Payload));
+		return true;
+	}
+
+	// A _bulk request can succeed as a whole with some of its documents refused. Documents refused for transient
+	// reasons go back on the outbound queue to ride along with the next batch, the rest are dropped and counted.
+	// Only the failed items are resent, so the documents that were indexed do not end up in the index twice.
+	void RequeueFailedBulkItems()
+	{
+		FBulkItemErrors Errors;
+		while (BulkItemErrors.Dequeue(Errors))
+		{
+			TArray<FElasticTelemetryBulkResponse::FItemFailure> Failures;
+			if (!FElasticTelemetryBulkResponse::Parse(Errors.Response.GetData(), Errors.Response.Num(), Failures))
+			{
+				// a 200 we cannot read, assume the documents were indexed rather than risk duplicating them
+				UnreadableBulkResponses.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			if (Failures.Num() == 0)
+				continue;
+
+			// The whole request was counted as delivered on its 200, the failed items were not indexed. A request
+			// replayed from a spool record older than its document count was counted as none.
+			DeliveredDocuments.fetch_sub(
+			    FMath::Min<uint64>(Failures.Num(), Errors.Documents), std::memory_order_relaxed);
+
+			// a node with a full write queue is the same back pressure as a 429 on the whole request
+			if (Failures.ContainsByPredicate([](const auto & Failure) { return Failure.IsRetryable(); }))
+			{
+				const double Now = FPlatformTime::Seconds();
+				SetInFlightLimit(Concurrency.OnRequestComplete(
+				    0.0, FElasticTelemetryConcurrencyController::EOutcome::Throttled, Now));
+			}
+
+			TArray<uint8> Decompressed;
+			if ((Errors.Flags & FElasticTelemetrySpool::Gzip) != 0)
+			{
+				if (!FElasticTelemetryGzip::Decompress(Errors.Body.GetData(), Errors.Body.Num(), Decompressed))
+				{
+					DroppedPoisonDocuments.fetch_add(Failures.Num(), std::memory_order_relaxed);
+					LostDocuments.fetch_add(Failures.Num(), std::memory_order_relaxed);
+					continue;
+				}
+			}
+			const TArray<uint8> & Body = Decompressed.Num() > 0 ? Decompressed : Errors.Body;
+
+			// item N is the document on line 2N+1, after its action line
+			const std::string_view Lines(reinterpret_cast<const char *>(Body.GetData()), Body.Num());
+			size_t                 LineStart = 0;
+			int32                  Line      = 0;
+			int32                  Next      = 0;
+			while (Next < Failures.Num() && LineStart < Lines.size())
+			{
+				const size_t LineEnd = FMath::Min(Lines.find('\n', LineStart), Lines.size());
+				if (Line == Failures[Next].Index * 2 + 1)
+				{
+					if (Failures[Next].IsRetryable())
+					{
+						if (Requeue(std::string(Lines.substr(LineStart, LineEnd - LineStart))))
+							RequeuedDocuments.fetch_add(1, std::memory_order_relaxed);
+					}
+					else
+					{
+						DroppedPoisonDocuments.fetch_add(1, std::memory_order_relaxed);
+						LostDocuments.fetch_add(1, std::memory_order_relaxed);
+					}
+					++Next;
+				}
+				LineStart = LineEnd + 1;
+				++Line;
+			}
+		}
+	}
+
+	// Puts a document refused by a _bulk item error back on the primary shard's queue, from its worker. It was
+	// admitted once already, so the byte budget and the severity watermarks do not get to refuse it a second time,
+	// only a ring out of slots does, under the same policy as an error line.
+	bool Requeue(std::string && Document)
+	{
+		FShard &    Shard = *Shards[0];
+		const int64 Bytes = static_cast<int64>(Document.size());
+		while (!Shard.OutboundMessages.TryEnqueue(MoveTemp(Document)))
+		{
+			if (!MakeRoomForSlot(Shard, Herald::LogLevels::Error))
+				return false;
+		}
+
+		// the worker drains its queue right after, no need to wake it
+		Shard.PendingDocuments.fetch_add(1);
+		Shard.PendingBytes.fetch_add(Bytes);
+		return true;
+	}
+
+	// How long the idle worker may sleep before it has held requests to deal with
+	uint32 GetIdleWaitMilliseconds(const FShard & Shard) const
+	{
+		// the other shards only look after their own queue, they check back now and then while the circuit is open
+		if (!Shard.IsPrimary())
+			return Circuit.IsClosed() ? MAX_uint32 : ResendIntervalMilliseconds;
+
+		switch (Circuit.GetState())
+		{
+		case FElasticTelemetryCircuitBreaker::EState::Open:
+		{
+			const double Remaining = Circuit.GetProbeTime() - FPlatformTime::Seconds();
+			return FMath::Max(1u, static_cast<uint32>(FMath::Max(0.0, Remaining) * 1000.0));
+		}
+		case FElasticTelemetryCircuitBreaker::EState::HalfOpen:
+			// the probe's completion wakes the worker
+			return MAX_uint32;
+		default:
+			return HasHeldRequests() ? ResendIntervalMilliseconds : MAX_uint32;
+		}
+	}
+
+	static FElasticTelemetryConcurrencyController::EOutcome GetConcurrencyOutcome(
+	    const bool bWasSuccessful, const int32 ResponseCode)
+	{
+		if (!bWasSuccessful || ResponseCode == 0)
+			return FElasticTelemetryConcurrencyController::EOutcome::Failed;
+		if (ResponseCode == 429 || ResponseCode == 503)
+			return FElasticTelemetryConcurrencyController::EOutcome::Throttled;
+		return FElasticTelemetryConcurrencyController::EOutcome::Success;
+	}
+
+	// Connection failures, timeouts, throttling and server errors are worth retrying. Any other 4xx means this body
+	// will never be accepted, so only it is dropped.
+	static bool IsRetryable(const bool bWasSuccessful, const int32 ResponseCode)
+	{
+		return !bWasSuccessful || ResponseCode == 0 || ResponseCode == 408 || ResponseCode == 429 ||
+		       ResponseCode >= 500;
+	}
+
+	void PublishSpoolStats()
+	{
+		SpoolBytes.store(static_cast<uint64>(Spool.GetTotalBytes()), std::memory_order_relaxed);
+		SpoolEvictedBytes.store(Spool.GetEvictedBytes(), std::memory_order_relaxed);
+		SpoolDiscardedBytes.store(Spool.GetDiscardedBytes(), std::memory_order_relaxed);
+	}
+
+	void SendBatch(FShard & Shard, const std::vector<std::string> & BatchMessages, FElasticTelemetryBulkBuilder & Bulk)
+	{
+		// a date in the index name moves on at midnight, the whole batch goes to the day it is sent on
+		Connection.RollIndex(FPlatformTime::Seconds());
+
+		if (bUseBulkAPI)
+		{
+			// Pack as many documents as the limits allow into each request. A drained batch of hundreds of
+			// log lines becomes a handful of requests rather than hundreds.
+			Bulk.SetLimits(BulkMaxDocuments, BulkMaxBytes);
+			Bulk.SetCreate(Connection.Get(Shard.Profile)->bDataStream);
+			for (const auto & Msg : BatchMessages)
+			{
+				if (!Bulk.CanAppend(Msg))
+				{
+					SendBulkRequest(Shard, Bulk);
+				}
+				Bulk.Append(Msg);
+			}
+
+			if (!Bulk.IsEmpty())
+			{
+				SendBulkRequest(Shard, Bulk);
+			}
+		}
+		else
+		{
+			for (const auto & Msg : BatchMessages)
+			{
+				// Send the message to the ElasticSearch server
+				// using the HTTP module
+				SendDocument(Shard, Msg);
+			}
+		}
 	}
 
 	FString                            EndpointURL;
@@ -135,81 +1191,389 @@ class ElasticTelemetryWriter : public Herald::ILogWriter, public FRunnable
 	FString                            Password;
 	FString                            IndexName;
 	std::map<std::string, std::string> ConfigPairs;
-	uint32_t                           CurrentPendingRequests;
-	uint32_t                           MaximumPendingRequests;
+	FElasticTelemetryConnection        Connection;
+
+	// optional _nodes/http discovery, see DiscoverEndpoints()
+	std::atomic<bool>   bDiscoverEndpoints;
+	std::atomic<int32>  EndpointDiscoveryIntervalSeconds;
+	double              NextEndpointDiscoveryTime; // worker thread only
+	std::atomic<bool>   bEndpointDiscoveryInFlight;
+	std::atomic<uint64> FailedOverRequests;
+
+	// bounds outstanding HTTP requests, sized by Concurrency when AdaptiveConcurrency is on, otherwise fixed at
+	// MaximumPendingRequests. Each shard has its own window, see SetInFlightLimit().
+	bool                                   bAdaptiveConcurrency;       // under ConfigMutex
+	int32                                  InitialPendingRequests;     // under ConfigMutex
+	int32                                  AdaptiveConcurrencyFloor;   // under ConfigMutex
+	int32                                  AdaptiveConcurrencyCeiling; // under ConfigMutex
+	FElasticTelemetryConcurrencyController Concurrency;
+
+	// _bulk API batching, see FElasticTelemetryBulkBuilder
+	std::atomic<bool>   bUseBulkAPI;
+	std::atomic<uint32> BulkMaxDocuments;
+	std::atomic<uint32> BulkMaxBytes;
+
+	// flush policy, see WaitForFlush()
+	std::atomic<int64>  FlushMaxDocuments;
+	std::atomic<int64>  FlushMaxBytes;
+	std::atomic<uint32> FlushLingerMilliseconds;
+
+	// gzip request bodies when CompressionLevel > 0, each shard has its own deflate state
+	std::atomic<int32> CompressionLevel;
+
+	// throughput, batch and latency metrics, see GetStats()
+	const double                     CreatedAt;
+	std::atomic<uint64>              EnqueuedDocuments;
+	std::atomic<uint64>              EnqueuedBytes;
+	FElasticTelemetryAtomicHistogram BatchDocuments;
+	FElasticTelemetryAtomicHistogram BatchBytes;
+	std::atomic<uint64>              UncompressedBytes;
+	std::atomic<uint64>              CompressedBytes;
+	std::atomic<uint64>              Requests;
+	FElasticTelemetryAtomicHistogram RequestLatency; // microseconds
+
+	// Worker threads, see FShard. Every thread that logs writes to the outbound queue of one of the first
+	// ShardCount shards. Shards are only ever added, up to MaxShards, and live as long as the writer.
+	static constexpr uint32 OutboundQueueCapacity = 64 * 1024;
+	static constexpr uint32 MaxShards             = 16;
+	std::atomic<uint32>     ShardCount;
+	std::atomic<uint32>     StartedShards;
+	TUniquePtr<FShard>      Shards[MaxShards];
+
+	// Error and Fatal lines, see EnqueuePriority()
+	static constexpr uint32 PriorityIndex         = MaxShards;
+	static constexpr uint32 PriorityQueueCapacity = 1024;
+	static constexpr int64  PriorityQueueMaxBytes = 1024 * 1024;
+	std::atomic<bool>       bPriorityLane;
+	TUniquePtr<FShard>      PriorityShard;
+
+	// memory bound and overflow policy for OutboundMessages, see MakeRoom()
+	std::atomic<int64>                           OutboundQueueMaxBytes;
+	std::atomic<EElasticTelemetryOverflowPolicy> OverflowPolicy;
+	std::atomic<uint64>                          DroppedNewest;
+	std::atomic<uint64>                          DroppedOldest;
+	std::atomic<uint64>                          DroppedLowSeverity;
+	uint64                                       ReportedNewest;      // worker thread only
+	uint64                                       ReportedOldest;      // worker thread only
+	uint64                                       ReportedLowSeverity; // worker thread only
+	std::weak_ptr<Herald::ILogTransformer>       JsonTransformer;     // under ConfigMutex, formats the drop report
 
-	// queue for outbound messages for the worker thread to pick up
-	FRunnableThread *   WorkerThread;
-	TQueue<std::string> OutboundMessages;
-	FThreadSafeBool     bStopWorkerThread;
-	FCriticalSection    QueueMutex;
-	FEvent *            QueueEvent;
-	FCriticalSection    ConfigMutex;
+	// retry, backoff and circuit breaking, see HoldFailedRequests() and ResendHeldRequests()
+	static constexpr uint32                                   ResendIntervalMilliseconds = 250;
+	std::atomic<int32>                                        RetryInitialBackoffMilliseconds;
+	std::atomic<int32>                                        RetryMaxBackoffMilliseconds;
+	FElasticTelemetryCircuitBreaker                           Circuit;
+	TQueue<FElasticTelemetrySpool::FRecord, EQueueMode::Mpsc> FailedRequests;
+	TQueue<FElasticTelemetrySpool::FRecord, EQueueMode::Spsc> RetryRequests; // worker thread only
+	std::atomic<int64>                                        RetryBytes;    // written by the worker thread only
+	std::atomic<uint64>                                       RetryableFailures;
+	std::atomic<uint64>                                       RejectedRequests;
+	std::atomic<uint64>                                       DroppedRetries;
+	std::atomic<uint64>                                       ResentRequests;
+
+	// per-document failures inside successful _bulk responses, see RequeueFailedBulkItems()
+	struct FBulkItemErrors
+	{
+		uint32        Flags     = 0;
+		uint32        Documents = 0; // what the request counted as delivered
+		TArray<uint8> Body;
+		TArray<uint8> Response;
+	};
+	TQueue<FBulkItemErrors, EQueueMode::Mpsc> BulkItemErrors;
+	std::atomic<uint64>                       RequeuedDocuments;
+	std::atomic<uint64>                       DroppedPoisonDocuments;
+	std::atomic<uint64>                       UnreadableBulkResponses;
+
+	// disk spool for requests held for retry, see FElasticTelemetrySpool
+	FString                SpoolDirectory;
+	std::atomic<int64>     SpoolMaxBytes;
+	FElasticTelemetrySpool Spool; // worker thread only
+	std::atomic<uint64>    SpooledRequests;
+	std::atomic<uint64>    SpoolBytes;
+	std::atomic<uint64>    SpoolEvictedBytes;
+	std::atomic<uint64>    SpoolDiscardedBytes;
+	std::atomic<bool>      bSpoolOpen; // Spool.IsOpen() for the other shards
+
+	// crash path, see FlushForCrash(). What a flush needs is published by ArmCrashFlush() and not changed after.
+	struct FCrashFlush
+	{
+		FElasticTelemetryCrashBuffer Buffer;
+		FString                      SegmentPath;
+		bool                         bCreate = false;
+	};
+	static constexpr int32          CrashFlushMaxBytes    = 256 * 1024;
+	static constexpr int32          CrashDocumentMaxBytes = 64 * 1024;
+	static constexpr int32          FatalLineEmpty        = 0;
+	static constexpr int32          FatalLineCopying      = 1;
+	static constexpr int32          FatalLineCopied       = 2;
+	int32                           CrashFlushLines;     // under ConfigMutex
+	std::atomic<FCrashFlush *>      CrashFlush;          // null when disarmed
+	TUniquePtr<FCrashFlush>         ArmedCrashFlush;     // under ConfigMutex, owns CrashFlush
+	TArray<TUniquePtr<FCrashFlush>> RetiredCrashFlushes; // replaced while a flush may have held them
+	TArray<ANSICHAR>                CrashFatalLine;      // reserved by the first ArmCrashFlush(), never resized
+	size_t                          CrashFatalBytes;
+	std::atomic<int32>              CrashFatalState;
+	std::atomic<bool>               bCrashFlushed;
+
+	// shutdown, see Drain(). Log lines are counted from the request that carries them to its outcome.
+	std::atomic<bool>   bDraining;
+	std::atomic<int64>  InFlightDocuments;
+	std::atomic<uint64> DeliveredDocuments;
+	std::atomic<uint64> SpooledDocuments;
+	std::atomic<uint64> LostDocuments;
+
+	// completions outlive the writer when it is destroyed with requests in flight
+	struct FLifetime
+	{
+		FRWLock Mutex;
+		bool    bAlive = true;
+	};
+	TSharedRef<FLifetime, ESPMode::ThreadSafe> Lifetime;
+
+	FThreadSafeBool  bStopWorkerThread;
+	FCriticalSection ConfigMutex;
+
+	// Herald hands over UTF-8, which is what goes on the wire, so a document is copied once into the request body
+	// and never converted to or from TCHAR on the way
+	void SendDocument(FShard & Shard, const std::string & Document)
+	{
+		const uint8 * Data = reinterpret_cast<const uint8 *>(Document.data());
+		TArray<uint8> Payload;
+		uint32        Flags = FElasticTelemetrySpool::None;
+		if (!TryCompress(Shard, Data, Document.size(), Payload, Flags))
+			Payload.Append(Data, static_cast<int32>(Document.size()));
+		CountBatch(1, Document.size(), Payload.Num());
+		SendOrHold(Shard, Flags, 1, MoveTemp(Payload));
+	}
 
-	void SendHttpRequest(const FString & Message)
+	// _bulk requires newline delimited JSON, and the body must end with a newline, which the builder ensures.
+	// An uncompressed body is handed to the request as is, the builder starts a new one.
+	void SendBulkRequest(FShard & Shard, FElasticTelemetryBulkBuilder & Bulk)
 	{
-		static FString InCall;
-		if (Message == InCall)
+		const TArray<uint8> & Body      = Bulk.GetBody();
+		const uint32          Documents = Bulk.GetDocumentCount();
+		TArray<uint8>         Payload;
+		uint32                Flags = FElasticTelemetrySpool::Bulk;
+		const int32           Bytes = Body.Num();
+		if (TryCompress(Shard, Body.GetData(), Body.Num(), Payload, Flags))
+			Bulk.Reset();
+		else
+			Payload = Bulk.DetachBody();
+		CountBatch(Documents, Bytes, Payload.Num());
+		SendOrHold(Shard, Flags, Documents, MoveTemp(Payload));
+	}
+
+	void CountBatch(const uint32 Documents, const uint64 Bytes, const uint64 SentBytes)
+	{
+		BatchDocuments.Record(Documents);
+		BatchBytes.Record(Bytes);
+		UncompressedBytes.fetch_add(Bytes, std::memory_order_relaxed);
+		CompressedBytes.fetch_add(SentBytes, std::memory_order_relaxed);
+	}
+
+	// Compresses into Out when CompressionLevel > 0. Runs on the worker thread, so the game thread never pays for
+	// compression.
+	bool TryCompress(FShard & Shard, const uint8 * Data, const int64 Size, TArray<uint8> & Out, uint32 & Flags)
+	{
+		const int32 Level = CompressionLevel;
+		if (Level <= 0)
+			return false;
+
+		// zlib failure should never happen, but the uncompressed body is still perfectly valid
+		if (!Shard.Gzip.Compress(Data, Size, Level, Out))
+			return false;
+
+		Flags |= FElasticTelemetrySpool::Gzip;
+		return true;
+	}
+
+	// Sends the body, or holds it for retry straight away while the circuit is open. Held requests and the spool
+	// belong to the first shard, the others hand theirs over.
+	void SendOrHold(FShard & Shard, const uint32 Flags, const uint32 Documents, TArray<uint8> && Payload)
+	{
+		if (!Circuit.IsClosed())
 		{
-			return; // avoid recursion in case something in FHttpModule or elsewhere logs
+			if (Shard.IsPrimary())
+			{
+				HoldForRetry(Flags, Documents, MoveTemp(Payload));
+			}
+			else
+			{
+				FailedRequests.Enqueue({Flags, MoveTemp(Payload), Documents});
+				Shards[0]->QueueEvent->Trigger();
+			}
+			return;
 		}
-		InCall = Message;
+		SendPayload(Shard, Flags, Documents, MoveTemp(Payload));
+	}
+
+	void SendPayload(FShard & Shard, const uint32 Flags, const uint32 Documents, TArray<uint8> && Payload)
+	{
+		const FElasticTelemetryConnection::FProfileRef Profile  = Connection.Get(Shard.Profile);
+		const FElasticTelemetryEndpointRef             Endpoint = Profile->Endpoints->Pick(FPlatformTime::Seconds());
+
+		const bool                        bBulk   = (Flags & FElasticTelemetrySpool::Bulk) != 0;
+		FElasticTelemetryTransportRequest Request = CreateRequest(
+		    *Profile, bBulk ? Endpoint->BulkURL : Endpoint->DocumentURL, TEXT("POST"));
+		Request.ContentType = bBulk ? TEXT("application/x-ndjson") : TEXT("application/json");
+		if (Flags & FElasticTelemetrySpool::Gzip)
+			Request.ContentEncoding = TEXT("gzip");
+		Request.Body = MoveTemp(Payload);
+		ProcessRequest(Shard, Profile, MoveTemp(Request), Flags, Documents, Endpoint);
+	}
+
+	// The connection profile is resolved ahead of time, so this does no string building
+	static FElasticTelemetryTransportRequest CreateRequest(
+	    const FElasticTelemetryConnectionProfile & Profile, const FString & URL, const TCHAR * Verb)
+	{
+		FElasticTelemetryTransportRequest Request;
+		Request.Verb    = Verb;
+		Request.URL     = URL;
+		Request.Headers = Profile.Headers;
+		return Request;
+	}
+
+	// Asks the cluster which nodes serve HTTP every EndpointDiscoveryIntervalSeconds, when DiscoverEndpoints is set.
+	// The answer replaces the configured endpoints, which then only serve to find the cluster.
+	void DiscoverEndpoints(FShard & Shard)
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (!bDiscoverEndpoints || bEndpointDiscoveryInFlight || Now < NextEndpointDiscoveryTime || !Circuit.IsClosed())
+			return;
+		NextEndpointDiscoveryTime = Now + EndpointDiscoveryIntervalSeconds.load();
+
+		const FElasticTelemetryConnection::FProfileRef Profile  = Connection.Get(Shard.Profile);
+		const FElasticTelemetryEndpointRef             Endpoint = Profile->Endpoints->Pick(Now);
+
+		// _nodes/http reports host:port only, the nodes are assumed to use the scheme they were configured with
+		FString Scheme;
+		if (!Endpoint->BaseURL.Split(TEXT("://"), &Scheme, nullptr))
+			Scheme = TEXT("http");
 
-		FHttpModule & Http    = FHttpModule::Get();
-		auto          Request = Http.CreateRequest();
-		// const int32	 MaximumPendingRequests = Settings.MaximumPendingRequests;
+		FElasticTelemetryTransportRequest Request = CreateRequest(
+		    *Profile, Endpoint->BaseURL + TEXT("_nodes/http?filter_path=nodes.*.http.publish_address"), TEXT("GET"));
+		bEndpointDiscoveryInFlight = true;
+		Profile->Transport->Send(MoveTemp(Request),
+		    [this, Guard = Lifetime, Endpoint, Scheme](const FElasticTelemetryTransportResponse & Response) {
+			    FReadScopeLock Alive(Guard->Mutex);
+			    if (!Guard->bAlive)
+				    return;
 
-		FString FullURL;
-		FString Auth;
-		FString AuthLine;
+			    const FUTF8ToTCHAR Json(
+			        reinterpret_cast<const ANSICHAR *>(Response.Content.GetData()), Response.Content.Num());
+			    const FString Nodes(Json.Length(), Json.Get());
 
+			    TArray<FString> Discovered;
+			    if (Response.bWasSuccessful && Response.Code == 200 &&
+			        FElasticTelemetryEndpointPool::ParseNodesHttp(Nodes, Scheme, Discovered))
+			    {
+				    Endpoint->Health.RecordSuccess();
+				    Connection.PublishDiscovered(MoveTemp(Discovered));
+			    }
+			    else if (!Response.bWasSuccessful)
+			    {
+				    Endpoint->Health.RecordFailure(FPlatformTime::Seconds());
+			    }
+			    bEndpointDiscoveryInFlight = false;
+		    });
+	}
+
+	void ApplyConcurrencyConfig()
+	{
+		Concurrency.Configure(
+		    bAdaptiveConcurrency, InitialPendingRequests, AdaptiveConcurrencyFloor, AdaptiveConcurrencyCeiling);
+		SetInFlightLimit(Concurrency.GetLimit());
+	}
+
+	// The limit covers the whole writer, each shard producers are routed to gets an even share of it. The priority
+	// lane keeps its single slot on top.
+	void SetInFlightLimit(const int32 Limit)
+	{
+		const int32  PerShard = FMath::DivideAndRoundUp(Limit, static_cast<int32>(ShardCount.load()));
+		const uint32 Started  = StartedShards.load(std::memory_order_acquire);
+		for (uint32 Index = 0; Index < Started; ++Index)
 		{
-			FScopeLock Lock(&ConfigMutex);
-			FullURL  = EndpointURL + IndexName + "/_doc";
-			Auth     = FBase64::Encode(Username + ":" + Password);
-			AuthLine = FString("Basic ") + Auth;
+			Shards[Index]->InFlight.SetLimit(PerShard);
 		}
-		Request->SetURL(FullURL);
-		Request->SetVerb("POST");
-		Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
-		Request->SetHeader("Content-Type", "application/json");
-		Request->SetHeader("Authorization", AuthLine);
+	}
 
-		Request->SetContentAsString(Message);
+	void ProcessRequest(FShard & Shard, const FElasticTelemetryConnection::FProfileRef & Profile,
+	    FElasticTelemetryTransportRequest && Request, const uint32 Flags, const uint32 Documents,
+	    const FElasticTelemetryEndpointRef & Endpoint)
+	{
 		// Prevent flooding libcurl. If it runs out of connections, it will spam like mad and drop the frame rate to
 		// 2FPS
-		while (!bStopWorkerThread && CurrentPendingRequests >= MaximumPendingRequests)
+		if (!Shard.InFlight.Acquire())
 		{
-			FPlatformProcess::Sleep(0.1f);
+			// shutting down, a drain may still spool the body
+			FailedRequests.Enqueue({Flags, MoveTemp(Request.Body), Documents});
+			return;
 		}
 
-		// Increment the pending request count
-		// This is the only thread accessing it, so no need to lock
-		CurrentPendingRequests++;
-		Request->ProcessRequest();
-		Request->OnProcessRequestComplete().BindLambda(
-		    [this](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-			    // Decrement the pending request count
-			    // This is the only thread accessing it, so no need to lock
-			    CurrentPendingRequests--;
-			    InCall.Reset();
+		// the completion may run inline, from Send() itself, when the transport does not go over the network
+		FShard *                               Sender    = &Shard;
+		const double                           StartTime = FPlatformTime::Seconds();
+		const FElasticTelemetryEndpointPoolRef Endpoints = Profile->Endpoints;
+		InFlightDocuments.fetch_add(Documents);
+		Requests.fetch_add(1, std::memory_order_relaxed);
+		TGuardValue<bool> Sending(IsSendingOnThisThread(), true);
+		Profile->Transport->Send(MoveTemp(Request),
+		    [this, Guard = Lifetime, Sender, Flags, Documents, StartTime, Endpoints, Endpoint](
+		        const FElasticTelemetryTransportResponse & Response) {
+			    FReadScopeLock Alive(Guard->Mutex);
+			    if (!Guard->bAlive)
+				    return;
 
-			    int32 ResponseCode = 0;
-			    if (Response)
-				    ResponseCode = Response->GetResponseCode();
+			    InFlightDocuments.fetch_sub(Documents);
 
-			    if (ResponseCode > 399 || !bWasSuccessful) // error
+			    const int32 ResponseCode = Response.Code;
+			    if (Response.bWasSuccessful && ResponseCode > 0 && ResponseCode < 400)
+			    {
+				    DeliveredDocuments.fetch_add(Documents, std::memory_order_relaxed);
+				    Endpoint->Health.RecordSuccess();
+				    Circuit.RecordSuccess();
+
+				    // some documents in a _bulk request may still have failed, the worker sorts out which
+				    if ((Flags & FElasticTelemetrySpool::Bulk) != 0 &&
+				        !FElasticTelemetryBulkResponse::HasNoErrors(Response.Content.GetData(), Response.Content.Num()))
+				    {
+					    BulkItemErrors.Enqueue({Flags, Documents, TArray<uint8>(Response.RequestBody),
+					        TArray<uint8>(Response.Content)});
+					    Shards[0]->QueueEvent->Trigger();
+				    }
+			    }
+			    else if (IsRetryable(Response.bWasSuccessful, ResponseCode))
+			    {
+				    // keep the body for the worker to hold and resend once the endpoint is back, the worker does any
+				    // disk I/O since this may well be the game thread
+				    RetryableFailures.fetch_add(1, std::memory_order_relaxed);
+				    FailedRequests.Enqueue({Flags, TArray<uint8>(Response.RequestBody), Documents});
+				    Shards[0]->QueueEvent->Trigger();
+
+				    // take this node out of rotation, sending only stops once no node is left to fail over to
+				    const double FailedAt = FPlatformTime::Seconds();
+				    Endpoint->Health.RecordFailure(FailedAt, Response.RetryAfterSeconds);
+				    if (Endpoints->HasAvailable(FailedAt))
+					    FailedOverRequests.fetch_add(1, std::memory_order_relaxed);
+				    else
+					    Circuit.RecordFailure(FailedAt, Response.RetryAfterSeconds);
+			    }
+			    else
 			    {
-				    // for debugging - do not submit a change with this active.
-				    // Because this lambda capture may trigger with HttpResponse
-				    // in an unknown state late in the application's lifecycle!
-				    // auto Content = Response->GetContentAsString();
-
-				    // the log server is having problems, or the client cannot reach it, so
-				    // stop doing all of this work for nothing.
-				    Request->CancelRequest();
-				    Stop();
+				    // the server is up, it just will never accept this body (mapping error, too large, ...)
+				    RejectedRequests.fetch_add(1, std::memory_order_relaxed);
+				    LostDocuments.fetch_add(Documents, std::memory_order_relaxed);
+				    Endpoint->Health.RecordSuccess();
+				    Circuit.RecordSuccess();
 			    }
+			    // let latency and throttling resize the window before this request's slot is handed back
+			    const double Now     = FPlatformTime::Seconds();
+			    const auto   Outcome = GetConcurrencyOutcome(Response.bWasSuccessful, ResponseCode);
+			    RequestLatency.Record(static_cast<uint64>((Now - StartTime) * 1000000.0));
+			    SetInFlightLimit(Concurrency.OnRequestComplete(Now - StartTime, Outcome, Now));
+			    Sender->InFlight.Release();
+			    // held requests may be waiting for a free slot too
+			    Sender->QueueEvent->Trigger();
 		    });
 	}
 };
@@ -2,6 +2,60 @@
 // MIT License, see LICENSE file for full details.
 
 #pragma once
+#include "Herald/ILogTransformer.hpp"
 #include "Herald/ILogWriterBuilder.hpp"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriterStats.h"
+#include <string_view>
 
-Herald::ILogWriterBuilderPtr createElasticTelemetryWriterBuilder();
+/// <summary>
+/// Herald::ILogWriter plus the ElasticTelemetry specific runtime queries.
+/// </summary>
+class IElasticTelemetryWriter : public Herald::ILogWriter
+{
+  public:
+	virtual FElasticTelemetryWriterStats GetStats() const = 0;
+
+	/// <summary>
+	/// Replaces what carries requests, FElasticTelemetryHttpTransport by default. Any thread, takes effect from the
+	/// next request. The "Transport" config pair does the same for the built-in transports, "Http" or "Null".
+	/// </summary>
+	virtual void SetTransport(FElasticTelemetryTransportRef Transport) = 0;
+
+	/// <summary>
+	/// The FElasticTelemetryJsonTransformer this writer is attached to. Documents the writer adds of its own, the
+	/// report of lines dropped under queue pressure, are formatted by it and carry its headers, without one they carry
+	/// none. Only a weak reference is kept, any thread.
+	/// </summary>
+	virtual void SetJsonTransformer(const Herald::ILogTransformerPtr & Transformer) = 0;
+
+	/// <summary>
+	/// Stops the writer after sending what it still has, for shutdown. Queued lines are sent without waiting for
+	/// FlushLingerMilliseconds, and the calling thread waits for the answers until Deadline. Whatever is left then
+	/// goes to the spool, when there is one. Requests still in flight are not waited for any longer.
+	///
+	/// Lines written afterwards are never sent. Call it from the game thread, HTTP completions are delivered there.
+	/// </summary>
+	/// <param name="Deadline">FPlatformTime::Seconds() to give up at.</param>
+	virtual FElasticTelemetryDrainReport Drain(double Deadline) = 0;
+
+	/// <summary>
+	/// For a crashing process: writes the newest CrashFlushLines queued lines, then the first Fatal line written, then
+	/// Document, to one spool segment the next launch replays. Nothing is sent. Runs once, from any thread, without
+	/// allocating. FElasticTelemetryCrashHandler calls it, a Fatal line is sent as usual and only kept for it.
+	/// </summary>
+	/// <param name="Document">The crash report, or empty.</param>
+	/// <returns>Whether the segment was written, false when there is no spool or it already ran.</returns>
+	virtual bool FlushForCrash(const std::string_view & Document) = 0;
+};
+
+ELASTICTELEMETRY_API Herald::ILogWriterBuilderPtr createElasticTelemetryWriterBuilder();
+
+/// <summary>
+/// Writers built by createElasticTelemetryWriterBuilder() are always IElasticTelemetryWriter instances. Do not pass
+/// anything else (a test's mock writer, for example).
+/// </summary>
+inline IElasticTelemetryWriter * AsElasticTelemetryWriter(const Herald::ILogWriterPtr & Writer)
+{
+	return static_cast<IElasticTelemetryWriter *>(Writer.get());
+}
@@ -2,12 +2,45 @@
 // MIT License, see LICENSE file for full details.
 
 #include "ElasticTelemetry.h"
+#include "ElasticTelemetryCrashHandler.h"
 #include "ElasticTelemetryOutputDevice.h"
+#include "ElasticTelemetryStatCounters.h"
+#include "ElasticTelemetryWriter.h"
 
 #define LOCTEXT_NAMESPACE "FElasticTelemetryModule"
 
+namespace
+{
+	void DrainWriter(const Herald::ILogWriterPtr & Writer, const TCHAR * Name, const double Deadline)
+	{
+		if (!Writer)
+			return;
+
+		const FElasticTelemetryDrainReport Report = AsElasticTelemetryWriter(Writer)->Drain(Deadline);
+		if (Report.GetTotal() == 0)
+			return;
+
+		UE_LOG(TelemetryLog, Log,
+		    TEXT("ElasticTelemetry %s writer drained in %.3fs%s: %llu flushed, %llu spilled to the spool, %llu lost"),
+		    Name, Report.Seconds, Report.bTimedOut ? TEXT(" (timed out)") : TEXT(""), Report.FlushedDocuments,
+		    Report.SpilledDocuments, Report.LostDocuments);
+	}
+} // namespace
+
 void FElasticTelemetryModule::ShutdownModule()
 {
+	// past this point, a crash is not the writers' business any more
+	CrashHandler.Reset();
+	StatCounters.Reset();
+
+	// both writers share one deadline, so shutdown never waits longer than ShutdownDrainMilliseconds
+	const double Deadline = FPlatformTime::Seconds() + GetSettings().ShutdownDrainMilliseconds / 1000.0;
+	if (OutputDevice)
+	{
+		DrainWriter(OutputDevice->GetElasticWriter(), TEXT("log"), Deadline);
+	}
+	DrainWriter(EventWriter, TEXT("event"), Deadline);
+
 	if (OutputDevice)
 	{
 		delete OutputDevice;
@@ -7,6 +7,7 @@
 #include "Dom/JsonObject.h"
 #include "ElasticTelemetry.h"
 #include "ElasticTelemetryEditorModule.h"
+#include "ElasticTelemetryIndexName.h"
 #include "FileNameFriendly.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
@@ -39,7 +40,9 @@ void FElasticQueryClient::QueryIndex(
 	{
 		normalizedIndex += '/';
 	}
-	const FString TelemetryURL = normalizedIndex + WriterSettings.EventIndexName + "/_search";
+	// every day of a rolling index
+	const FString EventIndex   = FileNameFriendly(WriterSettings.EventIndexName);
+	const FString TelemetryURL = normalizedIndex + FElasticTelemetryIndexName::ToWildcard(EventIndex) + "/_search";
 
 	const FString Auth     = FBase64::Encode(TelemetryUserName + ":" + TelemetryPassword);
 	const FString AuthLine = FString("Basic ") + Auth;
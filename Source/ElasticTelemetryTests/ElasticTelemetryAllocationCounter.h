@@ -0,0 +1,91 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include <atomic>
+
+/// <summary>
+/// Counts the heap allocations the constructing thread makes while it is in scope, std::string and std::map included
+/// since UE routes operator new through GMalloc. Swaps a forwarding proxy into GMalloc for its lifetime, so other
+/// threads keep allocating through the real allocator unaffected. A Realloc() counts, it may move the block. One at
+/// a time.
+/// </summary>
+class FElasticTelemetryAllocationCounter
+{
+  public:
+	FElasticTelemetryAllocationCounter()
+	    : Proxy(GetProxy())
+	{
+		check(GMalloc != &Proxy);
+		Proxy.Inner = GMalloc;
+		Proxy.Allocations.store(0, std::memory_order_relaxed);
+		Proxy.CountingThread.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+		GMalloc = &Proxy;
+	}
+
+	~FElasticTelemetryAllocationCounter()
+	{
+		GMalloc = Proxy.Inner;
+		Proxy.CountingThread.store(0, std::memory_order_relaxed);
+	}
+
+	uint64 GetAllocations() const { return Proxy.Allocations.load(std::memory_order_relaxed); }
+
+  private:
+	class FCountingMalloc : public FMalloc
+	{
+	  public:
+		FMalloc *           Inner = nullptr;
+		std::atomic<uint64> Allocations{0};
+		std::atomic<uint32> CountingThread{0};
+
+		virtual void * Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void * Realloc(void * Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+				CountAllocation();
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void * Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void * Original, SIZE_T & SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR * GetDescriptiveName() override { return TEXT("ElasticTelemetryAllocationCounter"); }
+
+	  private:
+		void CountAllocation()
+		{
+			if (CountingThread.load(std::memory_order_relaxed) == FPlatformTLS::GetCurrentThreadId())
+				Allocations.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	// never destroyed, another thread may still be inside it just after GMalloc is put back
+	static FCountingMalloc & GetProxy()
+	{
+		static FCountingMalloc * Instance = new FCountingMalloc();
+		return *Instance;
+	}
+
+	FCountingMalloc & Proxy;
+};
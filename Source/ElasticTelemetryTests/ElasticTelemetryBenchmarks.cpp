@@ -0,0 +1,556 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "StringConversions.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Compression.h"
+#include "HAL/Thread.h"
+#include "Containers/Queue.h"
+#include "ElasticTelemetryBulkBuilder.h"
+#include "ElasticTelemetryCompression.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetryMpscQueue.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryTimeStamp.h"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include "Herald/GetTimeStamp.hpp"
+#include "Herald/JsonLogTransformerFactory.hpp"
+#include "Herald/LogEntry.hpp"
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Benchmarks are automation tests in the Perf filter. They report their measurements with AddInfo() and only fail
+// when the code under test produces wrong results, never on timing, so they are safe to run on any machine.
+
+namespace
+{
+	/// <summary>
+	/// Produces log lines the way the output device does, through Herald's JSON transformer with the same headers
+	/// the module adds at startup.
+	/// </summary>
+	std::vector<std::string> MakeSampleLogLines(const int32 Count)
+	{
+		std::vector<std::string> Lines;
+		Lines.reserve(Count);
+
+		auto Transformer = Herald::createJsonLogTransformerBuilder()
+		                       ->attachLogWriterCallback([&Lines](const std::string & Json) { Lines.push_back(Json); })
+		                       .build();
+		Transformer->addHeader("SessionID", TCHAR_TO_UTF8(*FGuid::NewGuid().ToString()));
+		Transformer->addHeader("ComputerName", "BENCHMARK-MACHINE");
+		Transformer->addHeader("UserName", "DedicatedServer");
+
+		static const char * Categories[]  = {"LogStreaming", "LogNet", "LogTemp", "LogAudio"};
+		static const char * Verbosities[] = {"Log", "Verbose", "Warning", "Display"};
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const std::string Message = "Loaded package /Game/Maps/Arena/Chunk_" + std::to_string(i % 97) +
+			                            " in " + std::to_string((i * 7) % 1000) + "ms";
+			Transformer->log(Herald::LogEntry(Herald::LogLevels::Debug, Message, "Category", Categories[i % 4],
+			    "Verbosity", Verbosities[i % 4]));
+		}
+		return Lines;
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryGzipBenchmark, "ElasticTelemetry.Benchmark.GzipBulkBody",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FElasticTelemetryGzipBenchmark::RunTest(const FString & Parameters)
+{
+	// one full default-sized _bulk request worth of log lines
+	const auto                   Lines = MakeSampleLogLines(500);
+	FElasticTelemetryBulkBuilder Bulk(500, 5 * 1024 * 1024);
+	for (const auto & Line : Lines)
+	{
+		Bulk.Append(Line);
+	}
+	const TArray<uint8> & Body   = Bulk.GetBody();
+	const double          BodyMB = Body.Num() / (1024.0 * 1024.0);
+	constexpr int32       Rounds = 20;
+	FElasticTelemetryGzip Gzip;
+	TArray<uint8>         Compressed;
+
+	for (const int32 Level : {1, 6, 9})
+	{
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			TestTrue(TEXT("Compression succeeds"),
+			    Gzip.Compress(Body.GetData(), Body.Num(), Level, Compressed));
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Ratio   = static_cast<double>(Body.Num()) / FMath::Max(1, Compressed.Num());
+
+		AddInfo(FString::Printf(TEXT("gzip level %d: %d -> %d bytes, ratio %.2fx, %.2f ms CPU per MB"), Level,
+		    Body.Num(), Compressed.Num(), Ratio, (Elapsed * 1000.0) / (BodyMB * Rounds)));
+		TestTrue(TEXT("Repetitive log bodies compress"), Ratio > 2.0);
+
+		// what goes on the wire must be valid gzip that decodes back to the original body
+		TArray<uint8> Decompressed;
+		Decompressed.SetNumUninitialized(Body.Num());
+		TestTrue(TEXT("Body decompresses"), FCompression::UncompressMemory(NAME_Gzip, Decompressed.GetData(),
+		                                        Decompressed.Num(), Compressed.GetData(), Compressed.Num()));
+		TestTrue(TEXT("Round trip matches"), Decompressed == Body);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryQueueContentionBenchmark,
+    "ElasticTelemetry.Benchmark.QueueContention", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+	/// <summary>
+	/// N producer threads each push MessagesPerProducer log-line sized strings while one consumer drains, the shape of
+	/// a level streaming log storm. Returns wall time in seconds.
+	/// </summary>
+	template <typename EnqueueFunc, typename DequeueFunc>
+	double RunContention(const int32 ProducerCount, const int32 MessagesPerProducer, EnqueueFunc && Enqueue,
+	    DequeueFunc && Dequeue)
+	{
+		const std::string Line(300, 'x');
+		const double      Start = FPlatformTime::Seconds();
+
+		TArray<TUniquePtr<FThread>> Producers;
+		for (int32 Producer = 0; Producer < ProducerCount; ++Producer)
+		{
+			Producers.Add(MakeUnique<FThread>(TEXT("ElasticTelemetryBenchmarkProducer"), [&]() {
+				for (int32 i = 0; i < MessagesPerProducer;)
+				{
+					if (Enqueue(Line))
+						++i;
+				}
+			}));
+		}
+
+		int64       Received = 0;
+		std::string Msg;
+		while (Received < static_cast<int64>(ProducerCount) * MessagesPerProducer)
+		{
+			if (Dequeue(Msg))
+				++Received;
+		}
+
+		for (auto & Producer : Producers)
+		{
+			Producer->Join();
+		}
+		return FPlatformTime::Seconds() - Start;
+	}
+} // namespace
+
+bool FElasticTelemetryQueueContentionBenchmark::RunTest(const FString & Parameters)
+{
+	constexpr int32 MessagesPerProducer = 100000;
+
+	for (const int32 ProducerCount : {1, 2, 4, 8})
+	{
+		const double TotalMessages = static_cast<double>(ProducerCount) * MessagesPerProducer;
+
+		// what the writer used before: a critical section around a TQueue
+		FCriticalSection    Mutex;
+		TQueue<std::string> Locked;
+
+		auto LockedEnqueue = [&](const std::string & Line) {
+			FScopeLock Lock(&Mutex);
+			return Locked.Enqueue(Line);
+		};
+		auto LockedDequeue = [&](std::string & Out) {
+			FScopeLock Lock(&Mutex);
+			return Locked.Dequeue(Out);
+		};
+		const double LockedSeconds = RunContention(ProducerCount, MessagesPerProducer, LockedEnqueue, LockedDequeue);
+
+		TElasticTelemetryMpscQueue<std::string> LockFree(64 * 1024);
+
+		auto LockFreeEnqueue = [&](const std::string & Line) {
+			std::string Copy(Line);
+			return LockFree.TryEnqueue(MoveTemp(Copy));
+		};
+		auto LockFreeDequeue = [&](std::string & Out) { return LockFree.TryDequeue(Out); };
+		const double LockFreeSeconds =
+		    RunContention(ProducerCount, MessagesPerProducer, LockFreeEnqueue, LockFreeDequeue);
+
+		AddInfo(FString::Printf(TEXT("%d producers: FCriticalSection+TQueue %.1f ns/msg, lock-free MPSC %.1f ns/msg"),
+		    ProducerCount, LockedSeconds * 1e9 / TotalMessages, LockFreeSeconds * 1e9 / TotalMessages));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryPayloadCopyBenchmark, "ElasticTelemetry.Benchmark.PayloadCopies",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FElasticTelemetryPayloadCopyBenchmark::RunTest(const FString & Parameters)
+{
+	// Both pipelines start from the UTF-8 line Herald hands the writer and end with the bytes an IHttpRequest owns.
+	// Every buffer a line passes through is counted, conversions count the bytes they write.
+	const auto      Lines  = MakeSampleLogLines(500);
+	constexpr int32 Rounds = 20;
+
+	uint64 LineBytes = 0;
+	for (const auto & Line : Lines)
+	{
+		LineBytes += Line.size();
+	}
+
+	// single documents, before: queue copy, UTF8 -> FString, FString -> UTF8, UTF8 -> request body
+	{
+		uint64       Copied = 0;
+		const double Start  = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (const auto & Line : Lines)
+			{
+				const std::string  Queued(Line);
+				const FString      Message(UTF8_TO_TCHAR(Queued.c_str()));
+				const FTCHARToUTF8 Utf8(*Message);
+				TArray<uint8>      Content(reinterpret_cast<const uint8 *>(Utf8.Get()), Utf8.Length());
+				Copied += Queued.size() + Message.Len() * sizeof(TCHAR) + Utf8.Length() + Content.Num();
+			}
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Count   = static_cast<double>(Lines.size()) * Rounds;
+		AddInfo(FString::Printf(TEXT("_doc via FString: %.1f bytes copied per %.1f byte message, %.0f ns/msg"),
+		    Copied / Count, LineBytes / static_cast<double>(Lines.size()), Elapsed * 1e9 / Count));
+	}
+
+	// single documents, after: queue copy, UTF-8 -> request body
+	{
+		uint64       Copied = 0;
+		const double Start  = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (const auto & Line : Lines)
+			{
+				const std::string Queued(Line);
+				TArray<uint8>     Content(reinterpret_cast<const uint8 *>(Queued.data()), Queued.size());
+				Copied += Queued.size() + Content.Num();
+			}
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Count   = static_cast<double>(Lines.size()) * Rounds;
+		AddInfo(FString::Printf(TEXT("_doc as UTF-8: %.1f bytes copied per message, %.0f ns/msg"), Copied / Count,
+		    Elapsed * 1e9 / Count));
+	}
+
+	// _bulk, before: queue copy, compacted into the body, body copied into the request
+	// _bulk, after: queue copy, compacted into the body, which the request takes over
+	FElasticTelemetryBulkBuilder Bulk(0, 0);
+	for (const bool bDetach : {false, true})
+	{
+		uint64       Copied = 0;
+		const double Start  = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (const auto & Line : Lines)
+			{
+				const std::string Queued(Line);
+				Bulk.Append(Queued);
+				Copied += Queued.size();
+			}
+			Copied += Bulk.GetBody().Num();
+
+			TArray<uint8> Content;
+			if (bDetach)
+			{
+				Content = Bulk.DetachBody();
+			}
+			else
+			{
+				Content = Bulk.GetBody();
+				Copied += Content.Num();
+				Bulk.Reset();
+			}
+			TestTrue(TEXT("Request body holds every document"), Content.Num() > static_cast<int32>(LineBytes / 2));
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		const double Count   = static_cast<double>(Lines.size()) * Rounds;
+		AddInfo(FString::Printf(TEXT("_bulk %s: %.1f bytes copied per message, %.0f ns/msg"),
+		    bDetach ? TEXT("body moved into the request") : TEXT("body copied into the request"), Copied / Count,
+		    Elapsed * 1e9 / Count));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryPipelineBenchmark, "ElasticTelemetry.Benchmark.PipelineThroughput",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FElasticTelemetryPipelineBenchmark::RunTest(const FString & Parameters)
+{
+	// From write() until the transport has every line. The null transport takes the network out, leaving queueing,
+	// batching and compression. The stand-in server puts HTTP over loopback back in, the difference is what the
+	// HTTP module and sockets cost.
+	const auto   Lines = MakeSampleLogLines(20000);
+	const uint64 Count = Lines.size();
+
+	FElasticTelemetryStandInServer Server;
+	if (!TestTrue(TEXT("Stand-in server starts"), Server.Start()))
+		return false;
+
+	struct FRun
+	{
+		const TCHAR * Name;
+		bool          bUseBulkAPI;
+		bool          bNullTransport;
+		const char *  CompressionLevel;
+	};
+	const FRun Runs[] = {
+	    {TEXT("_doc, null transport"), false, true, "0"},
+	    {TEXT("_bulk, null transport"), true, true, "0"},
+	    {TEXT("_bulk, stand-in server"), true, false, "0"},
+	    {TEXT("_bulk gzip 1, stand-in server"), true, false, "1"},
+	};
+	for (const FRun & Run : Runs)
+	{
+		const auto   Sink           = MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>();
+		const uint64 ServerDocs     = Server.GetDocumentCount();
+		const uint64 ServerRequests = Server.GetRequests();
+
+		Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+		                                   ->addConfigPair("IndexName", "uelog")
+		                                   .addConfigPair("EndpointURL", TCHAR_TO_UTF8(*Server.GetURL()))
+		                                   .addConfigPair("UseBulkAPI", Run.bUseBulkAPI ? "true" : "false")
+		                                   .addConfigPair("CompressionLevel", Run.CompressionLevel)
+		                                   .build();
+		IElasticTelemetryWriter * ElasticWriter = AsElasticTelemetryWriter(Writer);
+		if (Run.bNullTransport)
+			ElasticWriter->SetTransport(Sink);
+
+		const double Start = FPlatformTime::Seconds();
+		for (const auto & Line : Lines)
+		{
+			Writer->write(Line);
+		}
+		auto Delivered = [&]() {
+			return Run.bNullTransport ? Sink->GetDocuments() : Server.GetDocumentCount() - ServerDocs;
+		};
+		const bool bDelivered =
+		    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Delivered() >= Count; }, 60.0);
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		TestTrue(FString::Printf(TEXT("%s delivers every line"), Run.Name), bDelivered);
+
+		const uint64 Requests = Run.bNullTransport ? Sink->GetRequests() : Server.GetRequests() - ServerRequests;
+		AddInfo(FString::Printf(TEXT("%s: %.0f ns/msg, %.0f msg/s, %llu requests"), Run.Name,
+		    Elapsed * 1e9 / Count, Count / Elapsed, Requests));
+
+		// completions reference the writer
+		FElasticTelemetryStandInServer::PumpHttpUntil(
+		    [ElasticWriter]() { return ElasticWriter->GetStats().InFlightRequests == 0; });
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryPriorityLatencyBenchmark,
+    "ElasticTelemetry.Benchmark.ErrorLatencyUnderStorm",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+	/// <summary>
+	/// Every request takes as long as a round trip to a busy cluster, on the thread that sends it, so a storm of
+	/// lines backs up the way it would in production. Records when each error line is sent.
+	/// </summary>
+	class FTimedTransport : public IElasticTelemetryTransport
+	{
+	  public:
+		static constexpr char ErrorKey[] = "{\"error\":";
+
+		explicit FTimedTransport(const int32 Errors) { SentAt.Init(0.0, Errors); }
+
+		virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) override
+		{
+			FPlatformProcess::Sleep(0.002f);
+
+			const double           Now = FPlatformTime::Seconds();
+			const std::string_view Body(reinterpret_cast<const char *>(Request.Body.GetData()), Request.Body.Num());
+			for (size_t At = Body.find(ErrorKey); At != std::string_view::npos; At = Body.find(ErrorKey, At + 1))
+			{
+				const int32 Error = FCStringAnsi::Atoi(Body.data() + At + sizeof(ErrorKey) - 1);
+				FScopeLock  Lock(&Mutex);
+				if (SentAt.IsValidIndex(Error))
+					SentAt[Error] = Now;
+			}
+
+			static constexpr std::string_view Content     = "{\"took\":0,\"errors\":false,\"items\":[]}";
+			const uint8 *                     ContentData = reinterpret_cast<const uint8 *>(Content.data());
+
+			FElasticTelemetryTransportResponse Response;
+			Response.bWasSuccessful = true;
+			Response.Code           = 200;
+			Response.Content        = MakeArrayView(ContentData, static_cast<int32>(Content.size()));
+			Response.RequestBody    = Request.Body;
+			OnComplete(Response);
+		}
+
+		TArray<double> GetSentAt() const
+		{
+			FScopeLock Lock(&Mutex);
+			return SentAt;
+		}
+
+	  private:
+		mutable FCriticalSection Mutex;
+		TArray<double>           SentAt; // under Mutex, 0 until sent
+	};
+} // namespace
+
+bool FElasticTelemetryPriorityLatencyBenchmark::RunTest(const FString & Parameters)
+{
+	// One thread logs verbose lines as fast as it can while the game thread logs an error every 20ms. Latency is
+	// from write() until the request carrying the error is sent.
+	const auto      Lines  = MakeSampleLogLines(10000);
+	constexpr int32 Errors = 50;
+
+	for (const bool bPriorityLane : {true, false})
+	{
+		const TSharedRef<FTimedTransport, ESPMode::ThreadSafe> Sink =
+		    MakeShared<FTimedTransport, ESPMode::ThreadSafe>(Errors);
+
+		Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+		                                   ->addConfigPair("IndexName", "uelog")
+		                                   .addConfigPair("PriorityLane", bPriorityLane ? "true" : "false")
+		                                   .build();
+		AsElasticTelemetryWriter(Writer)->SetTransport(Sink);
+
+		// give the storm a head start so the queue is full before the first error
+		std::atomic<bool> bStorming(true);
+
+		FThread Storm(TEXT("ElasticTelemetryBenchmarkStorm"), [&]() {
+			FElasticTelemetryLogLevelScope Verbose(Herald::LogLevels::Trace);
+			while (bStorming)
+			{
+				for (const auto & Line : Lines)
+				{
+					Writer->write(Line);
+				}
+			}
+		});
+		FPlatformProcess::Sleep(0.2f);
+
+		TArray<double> WrittenAt;
+		for (int32 Error = 0; Error < Errors; ++Error)
+		{
+			FElasticTelemetryLogLevelScope Scope(Herald::LogLevels::Error);
+			WrittenAt.Add(FPlatformTime::Seconds());
+			Writer->write("{\"error\":" + std::to_string(Error) + "}");
+			FPlatformProcess::Sleep(0.02f);
+		}
+
+		const bool bSent = FElasticTelemetryStandInServer::PumpHttpUntil(
+		    [&Sink]() { return !Sink->GetSentAt().Contains(0.0); }, 60.0);
+		bStorming = false;
+		Storm.Join();
+		TestTrue(FString::Printf(TEXT("Every error is sent (priority lane %d)"), bPriorityLane), bSent);
+
+		const TArray<double> SentAt = Sink->GetSentAt();
+		TArray<double>       Latency;
+		for (int32 Error = 0; Error < Errors; ++Error)
+		{
+			Latency.Add((SentAt[Error] - WrittenAt[Error]) * 1000.0);
+		}
+		Latency.Sort();
+		AddInfo(FString::Printf(TEXT("priority lane %s: error latency median %.2f ms, p95 %.2f ms, max %.2f ms"),
+		    bPriorityLane ? TEXT("on") : TEXT("off"), Latency[Errors / 2], Latency[Errors * 95 / 100],
+		    Latency.Last()));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryHeaderBenchmark, "ElasticTelemetry.Benchmark.HeaderSerialization",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FElasticTelemetryHeaderBenchmark::RunTest(const FString & Parameters)
+{
+	// Cost per line of turning a LogEntry into JSON, as headers are added. Herald's transformer serializes every
+	// header into every line, ours splices in a fragment escaped when the headers changed. Ours also formats its
+	// timestamp from a per-second cache (see ElasticTelemetry.Benchmark.TimeStamp), so compare the slopes.
+	constexpr int32        Count = 20000;
+	const Herald::LogEntry Entry(Herald::LogLevels::Debug, "Loaded package /Game/Maps/Arena/Chunk_12 in 42ms",
+	    "Category", "LogStreaming", "Verbosity", "Log");
+
+	for (const int32 Headers : {0, 5, 20})
+	{
+		uint64     Bytes    = 0;
+		const auto Callback = [&Bytes](const std::string & Json) { Bytes += Json.size(); };
+
+		struct FRun
+		{
+			const TCHAR *              Name;
+			Herald::ILogTransformerPtr Transformer;
+		};
+		const FRun Runs[] = {
+		    {TEXT("Herald"), Herald::createJsonLogTransformerBuilder()->attachLogWriterCallback(Callback).build()},
+		    {TEXT("header fragment"),
+		        createElasticTelemetryJsonTransformerBuilder()->attachLogWriterCallback(Callback).build()},
+		};
+		for (const FRun & Run : Runs)
+		{
+			const Herald::ILogTransformerPtr & Transformer = Run.Transformer;
+			for (int32 Header = 0; Header < Headers; ++Header)
+			{
+				Transformer->addHeader("Header" + std::to_string(Header), TCHAR_TO_UTF8(*FGuid::NewGuid().ToString()));
+			}
+
+			Bytes              = 0;
+			const double Start = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Transformer->log(Entry);
+			}
+			const double Elapsed = FPlatformTime::Seconds() - Start;
+			TestTrue(TEXT("Every line is written"), Bytes > 0);
+
+			AddInfo(FString::Printf(TEXT("%d headers, %s: %.0f ns/line, %.0f bytes/line"), Headers, Run.Name,
+			    Elapsed * 1e9 / Count, Bytes / static_cast<double>(Count)));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryTimeStampBenchmark, "ElasticTelemetry.Benchmark.TimeStamp",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FElasticTelemetryTimeStampBenchmark::RunTest(const FString & Parameters)
+{
+	// Cost of one timestamp per line, clock read included. Herald::getTimeStamp() converts to local time and runs a
+	// stringstream with two put_time() calls every time, the cached formatter does that once a second.
+	constexpr int32 Count = 200000;
+
+	struct FRun
+	{
+		const TCHAR *                 Name;
+		TFunction<std::string_view()> Format;
+	};
+	ANSICHAR    Buffer[FElasticTelemetryTimeStamp::BufferSize];
+	std::string Reference;
+	const FRun  Runs[] = {
+	    {TEXT("Herald::getTimeStamp"),
+	        [&Reference]() {
+		        Reference = Herald::getTimeStamp();
+		        return std::string_view(Reference);
+	        }},
+	    {TEXT("cached, wall clock"),
+	        [&Buffer]() { return FElasticTelemetryTimeStamp::Format(FElasticTelemetryTimeStamp::Now(false), Buffer); }},
+	    {TEXT("cached, monotonic"),
+	        [&Buffer]() { return FElasticTelemetryTimeStamp::Format(FElasticTelemetryTimeStamp::Now(true), Buffer); }},
+	};
+	for (const FRun & Run : Runs)
+	{
+		uint64       Bytes = 0;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Bytes += Run.Format().size();
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		TestEqual(TEXT("Every timestamp is whole"), Bytes, static_cast<uint64>(Count) * Herald::getTimeStamp().size());
+
+		AddInfo(FString::Printf(TEXT("%s: %.0f ns/timestamp"), Run.Name, Elapsed * 1e9 / Count));
+	}
+	return true;
+}
@@ -0,0 +1,331 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "ElasticTelemetryBulkBuilder.h"
+#include "ElasticTelemetryBulkResponse.h"
+#include "ElasticTelemetryCompression.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetryScriptedTransport.h"
+#include "ElasticTelemetrySpool.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	FString BodyToString(const TArray<uint8> & Body)
+	{
+		const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR *>(Body.GetData()), Body.Num());
+		return FString(Text.Length(), Text.Get());
+	}
+
+	// 100 bytes, whatever the name and index
+	std::string MakePaddedLine(const char * Name, const int32 Index)
+	{
+		std::string Line = "{\"log\":{\"message\":\"" + std::string(Name) + " " + std::to_string(Index);
+		Line += "\",\"pad\":\"";
+		Line.append(100 - Line.size() - 3, '.');
+		return Line + "\"}}";
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCompactJsonTest, "ElasticTelemetry.Bulk.CompactJson",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCompactJsonTest::RunTest(const FString & Parameters)
+{
+	// PrettyWriter output, as produced by Herald's JsonLogTransformer
+	const std::string Pretty = "{\n    \"log\": {\n        \"message\": \"hello world \\\"quoted\\\" \\\\\"\n    }\n}";
+	TArray<uint8>     Compact;
+	AppendCompactJson(Compact, Pretty);
+
+	TestEqual(TEXT("Whitespace outside strings is removed, strings are untouched"), BodyToString(Compact),
+	    FString(TEXT("{\"log\":{\"message\":\"hello world \\\"quoted\\\" \\\\\"}}")));
+	TestFalse(TEXT("Compacted document is a single line"), Compact.Contains('\n'));
+
+	// what the ElasticTelemetry transformer writes is already on one line and is appended byte for byte
+	const std::string OneLine = "{\"log\":{\"message\":\"already compact \\\"quoted\\\"\"}}";
+	TestTrue(TEXT("A compact document is recognised"), IsSingleLineJson(OneLine));
+	TestFalse(TEXT("A pretty printed document is not"), IsSingleLineJson(Pretty));
+	Compact.Reset();
+	AppendCompactJson(Compact, OneLine);
+	TestEqual(TEXT("A compact document is appended as it is"), BodyToString(Compact),
+	    FString(UTF8_TO_TCHAR(OneLine.c_str())));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryBulkBuilderTest, "ElasticTelemetry.Bulk.Builder",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryBulkBuilderTest::RunTest(const FString & Parameters)
+{
+	const std::string Document = "{\"message\": \"a\"}";
+
+	// document count limit
+	{
+		FElasticTelemetryBulkBuilder Bulk(2, 1024 * 1024);
+		TestTrue(TEXT("Empty builder accepts a document"), Bulk.CanAppend(Document));
+		Bulk.Append(Document);
+		Bulk.Append(Document);
+		TestFalse(TEXT("Builder refuses documents past MaxDocuments"), Bulk.CanAppend(Document));
+		TestEqual(TEXT("Two documents were appended"), Bulk.GetDocumentCount(), 2u);
+		TestEqual(TEXT("Body is NDJSON with an action line per document"), BodyToString(Bulk.GetBody()),
+		    FString(TEXT("{\"index\":{}}\n{\"message\":\"a\"}\n{\"index\":{}}\n{\"message\":\"a\"}\n")));
+
+		Bulk.Reset();
+		TestTrue(TEXT("Reset empties the builder"), Bulk.IsEmpty());
+		TestTrue(TEXT("Reset builder accepts documents again"), Bulk.CanAppend(Document));
+
+		// data streams only take create
+		Bulk.SetCreate(true);
+		Bulk.Append(Document);
+		TestEqual(TEXT("Create action lines"), BodyToString(Bulk.GetBody()),
+		    FString(TEXT("{\"create\":{}}\n{\"message\":\"a\"}\n")));
+	}
+
+	// the body is handed over without a copy
+	{
+		FElasticTelemetryBulkBuilder Bulk(1000, 1024 * 1024);
+		Bulk.Append(Document);
+		const uint8 * Data     = Bulk.GetBody().GetData();
+		TArray<uint8> Detached = Bulk.DetachBody();
+		TestTrue(TEXT("Detaching moves the buffer out"), Detached.GetData() == Data);
+		TestTrue(TEXT("Detaching empties the builder"), Bulk.IsEmpty() && Bulk.GetBody().Num() == 0);
+		TestTrue(TEXT("The next body is allocated up front"), Bulk.GetBody().Max() >= Detached.Num());
+	}
+
+	// byte limit
+	{
+		const uint32                 OneDocument = FElasticTelemetryBulkBuilder::ActionLine().size() + Document.size() + 1;
+		FElasticTelemetryBulkBuilder Bulk(1000, OneDocument);
+		Bulk.Append(Document);
+		TestFalse(TEXT("Builder refuses documents past MaxBytes"), Bulk.CanAppend(Document));
+	}
+
+	// oversized documents are still sent, on their own
+	{
+		FElasticTelemetryBulkBuilder Bulk(1000, 4);
+		TestTrue(TEXT("Empty builder accepts an oversized document"), Bulk.CanAppend(Document));
+		Bulk.Append(Document);
+		TestFalse(TEXT("Nothing else is packed with an oversized document"), Bulk.CanAppend(Document));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryBulkResponseTest, "ElasticTelemetry.Bulk.ResponseItems",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryBulkResponseTest::RunTest(const FString & Parameters)
+{
+	const std::string Clean = "{\"took\":30,\"errors\":false,\"items\":[{\"index\":{\"status\":201}}]}";
+	TestTrue(TEXT("A response without errors is recognised without parsing"),
+	    FElasticTelemetryBulkResponse::HasNoErrors(reinterpret_cast<const uint8 *>(Clean.data()), Clean.size()));
+
+	const FString Mixed = TEXT("{\"took\":3,\"errors\":true,\"items\":["
+	                           "{\"index\":{\"_index\":\"uelog\",\"status\":201,\"result\":\"created\"}},"
+	                           "{\"index\":{\"_index\":\"uelog\",\"status\":400,\"error\":{\"type\":"
+	                           "\"mapper_parsing_exception\",\"reason\":\"failed to parse\",\"caused_by\":{\"type\":"
+	                           "\"illegal_argument_exception\"}}}},"
+	                           "{\"index\":{\"_index\":\"uelog\",\"status\":201}},"
+	                           "{\"create\":{\"_index\":\"uelog\",\"status\":429,\"error\":{\"type\":"
+	                           "\"es_rejected_execution_exception\"}}}]}");
+	const std::string MixedUtf8 = TCHAR_TO_UTF8(*Mixed);
+	TestFalse(TEXT("A response with errors needs parsing"),
+	    FElasticTelemetryBulkResponse::HasNoErrors(
+	        reinterpret_cast<const uint8 *>(MixedUtf8.data()), MixedUtf8.size()));
+
+	TArray<FElasticTelemetryBulkResponse::FItemFailure> Failures;
+	TestTrue(TEXT("Response parses"), FElasticTelemetryBulkResponse::Parse(Mixed, Failures));
+	TestEqual(TEXT("Only failed items are reported"), Failures.Num(), 2);
+	if (Failures.Num() != 2)
+		return false;
+
+	TestEqual(TEXT("Mapping error index"), Failures[0].Index, 1);
+	TestEqual(TEXT("Mapping error status"), Failures[0].Status, 400);
+	TestEqual(TEXT("Nested caused_by does not replace the error type"), Failures[0].ErrorType,
+	    FString(TEXT("mapper_parsing_exception")));
+	TestFalse(TEXT("Mapping errors are poison"), Failures[0].IsRetryable());
+
+	TestEqual(TEXT("Rejected execution index"), Failures[1].Index, 3);
+	TestTrue(TEXT("Rejected execution is retryable"), Failures[1].IsRetryable());
+
+	// the writer parses the bytes as they arrived
+	TArray<FElasticTelemetryBulkResponse::FItemFailure> Utf8Failures;
+	const uint8 *                                       Utf8Data = reinterpret_cast<const uint8 *>(MixedUtf8.data());
+	TestTrue(TEXT("The UTF-8 response parses"),
+	    FElasticTelemetryBulkResponse::Parse(Utf8Data, MixedUtf8.size(), Utf8Failures));
+	TestTrue(TEXT("The UTF-8 response has the same failures"),
+	    Utf8Failures.Num() == 2 && Utf8Failures[0].Index == 1 && Utf8Failures[0].Status == 400 &&
+	        Utf8Failures[0].ErrorType == Failures[0].ErrorType && Utf8Failures[1].Index == 3 &&
+	        Utf8Failures[1].IsRetryable());
+
+	Failures.Reset();
+	TestFalse(TEXT("A truncated response is not trusted"),
+	    FElasticTelemetryBulkResponse::Parse(TEXT("{\"took\":3,\"errors\":true,\"items\":[{\"index\":"), Failures));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryGzipRoundTripTest, "ElasticTelemetry.Bulk.GzipRoundTrip",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryGzipRoundTripTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryBulkBuilder Builder(0, 0);
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		Builder.Append("{\"log\":{\"message\":\"line " + std::to_string(i) + "\"}}");
+	}
+	const TArray<uint8> & Body = Builder.GetBody();
+
+	FElasticTelemetryGzip Gzip;
+	TArray<uint8>         Compressed;
+	TestTrue(TEXT("Compresses"), Gzip.Compress(Body.GetData(), Body.Num(), 6, Compressed));
+
+	TArray<uint8> Decompressed;
+	TestTrue(TEXT("Decompresses"),
+	    FElasticTelemetryGzip::Decompress(Compressed.GetData(), Compressed.Num(), Decompressed));
+	TestTrue(TEXT("Round trip is lossless"), Decompressed == Body);
+
+	TestFalse(TEXT("A truncated stream is refused"),
+	    FElasticTelemetryGzip::Decompress(Compressed.GetData(), Compressed.Num() / 2, Decompressed));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryBulkPartialFailureTest, "ElasticTelemetry.Bulk.PartialFailure",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryBulkPartialFailureTest::RunTest(const FString & Parameters)
+{
+	// errors go out at once on the priority lane, the warnings linger in the queue until the drain
+	Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+	                                   ->addConfigPair("IndexName", "uelog")
+	                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+	                                   .addConfigPair("FlushLingerMilliseconds", "600000")
+	                                   .addConfigPair("OverflowPolicy", "DropLowestSeverity")
+	                                   .addConfigPair("OutboundQueueMaxBytes", "1050")
+	                                   .addConfigPair("PriorityLane", "True")
+	                                   .build();
+	const TSharedRef<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe> Transport =
+	    MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+	AsElasticTelemetryWriter(Writer)->SetTransport(Transport);
+
+	// error 1 fails mapping every time, error 2 is turned away once by a node with a full write queue
+	bool bRejected = false;
+	Transport->SetItemStatus([&bRejected](const std::string_view & Document) {
+		if (Document.find("error 1\"") != std::string_view::npos)
+			return 400;
+		if (Document.find("error 2\"") != std::string_view::npos && !bRejected)
+		{
+			bRejected = true;
+			return 429;
+		}
+		return 201;
+	});
+
+	// nine warnings fill the queue past the 892 of 1050 bytes info lines may take
+	{
+		FElasticTelemetryLogLevelScope Warning(Herald::LogLevels::Warning);
+		for (int32 i = 0; i < 9; ++i)
+		{
+			Writer->write(MakePaddedLine("warning", i));
+		}
+	}
+	{
+		FElasticTelemetryLogLevelScope Error(Herald::LogLevels::Error);
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Writer->write(MakePaddedLine("error", i));
+		}
+	}
+	const bool bAnswered = FElasticTelemetryStandInServer::PumpHttpUntil([&Writer, &Transport]() {
+		const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+		return Transport->GetDocuments().size() == 4 && Stats.InFlightRequests == 0;
+	});
+	if (!TestTrue(TEXT("The errors are answered"), bAnswered))
+		return false;
+
+	// the drain sorts out the failed items, then sends the warnings and what was requeued
+	IElasticTelemetryWriter * const    Telemetry = AsElasticTelemetryWriter(Writer);
+	const FElasticTelemetryDrainReport Report    = Telemetry->Drain(FPlatformTime::Seconds() + 10.0);
+	const FElasticTelemetryWriterStats Stats     = Telemetry->GetStats();
+	const std::vector<std::string>     Documents = Transport->GetDocuments();
+	Writer.reset();
+
+	TestEqual(TEXT("The rejected document is requeued"), Stats.RequeuedDocuments, 1ull);
+	TestEqual(TEXT("The mapping failure is dropped"), Stats.DroppedPoisonDocuments, 1ull);
+	TestEqual(TEXT("The severity watermarks do not refuse a requeued document"), Stats.GetTotalDropped(), 0ull);
+	TestTrue(TEXT("The warnings are sent, then the requeued document"),
+	    Documents.size() == 14 && Documents[4] == MakePaddedLine("warning", 0) &&
+	        Documents.back() == MakePaddedLine("error", 2));
+	TestEqual(TEXT("The poison document is not sent again"),
+	    static_cast<int32>(std::count(Documents.begin(), Documents.end(), MakePaddedLine("error", 1))), 1);
+
+	// The errors' request counted its four documents as delivered when its 200 arrived, before the drain. The drain
+	// takes the two failed items back off, and adds the nine warnings and the requeued document.
+	TestEqual(TEXT("Only indexed documents count as delivered"), Report.FlushedDocuments, 8ull);
+	TestEqual(TEXT("The poison document counts as lost"), Report.LostDocuments, 1ull);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryBulkPartialFailureReplayedTest,
+    "ElasticTelemetry.Bulk.PartialFailureReplayed",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryBulkPartialFailureReplayedTest::RunTest(const FString & Parameters)
+{
+	const FString Directory =
+	    FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / TEXT("PartialFailureReplayed");
+
+	// three spooled documents, one of which fails mapping. A record from before the spool stored document counts
+	// says 0, the request then counted nothing as delivered and has nothing to take back.
+	std::string Body;
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Body += "{\"index\":{}}\n" + MakePaddedLine("spooled", i) + "\n";
+	}
+	for (const uint32 Documents : {3u, 0u})
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		IFileManager::Get().MakeDirectory(*Directory, true);
+		FElasticTelemetrySpool::WriteSegment(*FElasticTelemetrySpool::GetCrashSegmentPath(Directory),
+		    FElasticTelemetrySpool::Bulk, reinterpret_cast<const uint8 *>(Body.data()), Body.size(), Documents);
+
+		Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+		                                   ->addConfigPair("IndexName", "uelog")
+		                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+		                                   .build();
+		const TSharedRef<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe> Transport =
+		    MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+		Transport->SetItemStatus([](const std::string_view & Document) {
+			return Document.find("spooled 1\"") != std::string_view::npos ? 400 : 201;
+		});
+		Transport->Stall();
+		AsElasticTelemetryWriter(Writer)->SetTransport(Transport);
+		Writer->addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*Directory));
+
+		// the replayed request is answered while the drain counts what it flushed
+		const bool bReplayed = FElasticTelemetryStandInServer::PumpHttpUntil(
+		    [&Transport]() { return Transport->GetHeldRequests() == 1; });
+		if (!TestTrue(TEXT("The spooled request is replayed"), bReplayed))
+			return false;
+		Transport->ReleaseOnPump();
+
+		IElasticTelemetryWriter * const    Telemetry = AsElasticTelemetryWriter(Writer);
+		const FElasticTelemetryDrainReport Report    = Telemetry->Drain(FPlatformTime::Seconds() + 10.0);
+		const FElasticTelemetryWriterStats Stats     = Telemetry->GetStats();
+		Writer.reset();
+
+		TestEqual(TEXT("The mapping failure is dropped"), Stats.DroppedPoisonDocuments, 1ull);
+		TestEqual(TEXT("Only indexed documents count as delivered, never fewer than none"), Report.FlushedDocuments,
+		    static_cast<uint64>(Documents > 0 ? Documents - 1 : 0));
+		TestEqual(TEXT("The poison document counts as lost"), Report.LostDocuments, 1ull);
+	}
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
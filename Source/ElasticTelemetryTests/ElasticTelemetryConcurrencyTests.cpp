@@ -0,0 +1,71 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "ElasticTelemetryConcurrencyController.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryConcurrencyAimdTest, "ElasticTelemetry.InFlight.AdaptiveConcurrency",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryConcurrencyAimdTest::RunTest(const FString & Parameters)
+{
+	using EOutcome = FElasticTelemetryConcurrencyController::EOutcome;
+
+	FElasticTelemetryConcurrencyController Controller;
+	Controller.Configure(true, 4, 2, 16);
+	TestEqual(TEXT("Starts at the initial limit"), Controller.GetLimit(), 4);
+
+	// steady 20ms round trips, the window should open up to the ceiling and stay there
+	double Now = 0.0;
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		Now += 0.005;
+		Controller.OnRequestComplete(0.02, EOutcome::Success, Now);
+	}
+	TestEqual(TEXT("Stable latency grows the limit to the ceiling"), Controller.GetLimit(), 16);
+
+	Now += 1.0;
+	Controller.OnRequestComplete(0.02, EOutcome::Throttled, Now);
+	TestEqual(TEXT("A 429 halves the limit"), Controller.GetLimit(), 8);
+
+	// the rest of the requests that were in flight come back throttled too
+	Controller.OnRequestComplete(0.02, EOutcome::Throttled, Now + 0.001);
+	Controller.OnRequestComplete(0.02, EOutcome::Throttled, Now + 0.002);
+	TestEqual(TEXT("One decrease per round trip"), Controller.GetLimit(), 8);
+
+	for (int32 i = 0; i < 10; ++i)
+	{
+		Now += 1.0;
+		Controller.OnRequestComplete(0.02, EOutcome::Throttled, Now);
+	}
+	TestEqual(TEXT("The floor holds under sustained throttling"), Controller.GetLimit(), 2);
+
+	const int32 BeforeFailures = Controller.GetLimit();
+	Controller.OnRequestComplete(0.0, EOutcome::Failed, Now + 1.0);
+	TestEqual(TEXT("Connection failures are left to the circuit breaker"), Controller.GetLimit(), BeforeFailures);
+
+	// recover, then hit a latency spike
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		Now += 0.005;
+		Controller.OnRequestComplete(0.02, EOutcome::Success, Now);
+	}
+	const int32  BeforeSpike = Controller.GetLimit();
+	const uint64 Decreases   = Controller.GetDecreases();
+	for (int32 i = 0; i < 5; ++i)
+	{
+		Now += 0.005;
+		Controller.OnRequestComplete(0.5, EOutcome::Success, Now);
+	}
+	TestTrue(TEXT("A latency spike shrinks the limit"), Controller.GetLimit() < BeforeSpike);
+	TestTrue(TEXT("The spike is counted"), Controller.GetDecreases() > Decreases);
+	TestTrue(TEXT("The spike does not become the new baseline"), Controller.GetBaselineLatency() < 0.05);
+
+	Controller.Configure(false, 4, 2, 16);
+	for (int32 i = 0; i < 100; ++i)
+	{
+		Controller.OnRequestComplete(0.02, EOutcome::Success, Now += 0.005);
+	}
+	TestEqual(TEXT("Disabled, the limit stays fixed"), Controller.GetLimit(), 4);
+	return true;
+}
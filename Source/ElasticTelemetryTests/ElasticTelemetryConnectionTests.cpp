@@ -0,0 +1,179 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "ElasticTelemetryConnectionProfile.h"
+#include "ElasticTelemetryEndpointPool.h"
+#include "ElasticTelemetryIndexName.h"
+#include "FileNameFriendly.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryConnectionProfileTest, "ElasticTelemetry.Connection.Profile",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryConnectionProfileTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryConnection Connection;
+	Connection.Publish(TEXT("http://localhost:9200"), TEXT("uelog"), TEXT("elastic"), TEXT("changeme"));
+
+	// each worker thread keeps the profile it last used
+	FElasticTelemetryConnection::FProfileRef   Cached = Connection.GetPublished();
+	const FElasticTelemetryConnectionProfile * First  = &Connection.Get(Cached).Get();
+	TestEqual(TEXT("One endpoint"), First->Endpoints->GetEndpoints().Num(), 1);
+	TestEqual(TEXT("A trailing slash is added to the endpoint"), First->Endpoints->GetEndpoints()[0]->DocumentURL,
+	    FString(TEXT("http://localhost:9200/uelog/_doc")));
+	TestEqual(TEXT("Bulk URL"), First->Endpoints->GetEndpoints()[0]->BulkURL,
+	    FString(TEXT("http://localhost:9200/uelog/_bulk")));
+	TestEqual(TEXT("Index name"), First->IndexName, FString(TEXT("uelog")));
+
+	const TPair<FString, FString> * Authorization =
+	    First->Headers.FindByPredicate([](const auto & Header) { return Header.Key == TEXT("Authorization"); });
+	TestTrue(TEXT("Authorization header is prebuilt"),
+	    Authorization && Authorization->Value == TEXT("Basic ZWxhc3RpYzpjaGFuZ2VtZQ=="));
+
+	TestTrue(TEXT("An unchanged profile is reused"), &Connection.Get(Cached).Get() == First);
+
+	const uint64 Version = Connection.GetVersion();
+	Connection.Publish(TEXT("https://search.example.com/"), TEXT("ueevent"), TEXT("elastic"), TEXT("changeme"));
+	TestEqual(TEXT("Publishing bumps the version"), Connection.GetVersion(), Version + 1);
+
+	const FElasticTelemetryConnectionProfile & Second = Connection.Get(Cached).Get();
+	TestEqual(TEXT("The next send picks up the new profile"), Second.Endpoints->GetEndpoints()[0]->BulkURL,
+	    FString(TEXT("https://search.example.com/ueevent/_bulk")));
+	TestEqual(TEXT("The profile carries its version"), Second.Version, Connection.GetVersion());
+
+	// discovered nodes replace the configured ones, until the configuration changes again
+	Connection.PublishDiscovered({FString(TEXT("https://10.0.0.2:9200/")), FString(TEXT("https://10.0.0.1:9200/"))});
+	TestEqual(TEXT("Discovered nodes are used"), Connection.Get(Cached)->Endpoints->GetEndpoints().Num(), 2);
+	const uint64 Discovered = Connection.GetVersion();
+	Connection.PublishDiscovered({FString(TEXT("https://10.0.0.1:9200/")), FString(TEXT("https://10.0.0.2:9200/"))});
+	TestEqual(TEXT("The same nodes in another order are not a change"), Connection.GetVersion(), Discovered);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryEndpointPoolTest, "ElasticTelemetry.Connection.EndpointPool",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryEndpointPoolTest::RunTest(const FString & Parameters)
+{
+	const TArray<FString> URLs = FElasticTelemetryEndpointPool::ParseEndpointList(
+	    TEXT("http://es-1:9200, http://es-2:9200/;http://es-3:9200\nhttp://es-1:9200/"));
+	TestEqual(TEXT("Lists are split, normalised and deduplicated"), URLs.Num(), 3);
+	if (URLs.Num() != 3)
+		return false;
+	TestEqual(TEXT("Trailing slash added"), URLs[0], FString(TEXT("http://es-1:9200/")));
+
+	FElasticTelemetryEndpointPool Pool(URLs, TEXT("uelog"), nullptr, 1.0, 8.0);
+	const double                  Now = 1000.0;
+
+	// round-robin over healthy nodes
+	TMap<FString, int32> Picks;
+	for (int32 i = 0; i < 30; ++i)
+	{
+		++Picks.FindOrAdd(Pool.Pick(Now)->BaseURL);
+	}
+	TestEqual(TEXT("Every node gets an equal share"), Picks.Num(), 3);
+	for (const auto & Pick : Picks)
+	{
+		TestEqual(FString::Printf(TEXT("Share of %s"), *Pick.Key), Pick.Value, 10);
+	}
+
+	// a failed node is skipped until its backoff elapses
+	const FElasticTelemetryEndpointRef Failed = Pool.GetEndpoints()[1];
+	Failed->Health.RecordFailure(Now);
+	TestTrue(TEXT("Other nodes remain available"), Pool.HasAvailable(Now));
+	TestEqual(TEXT("Two of three available"), Pool.GetAvailableCount(Now), 2);
+	bool bPickedFailed = false;
+	for (int32 i = 0; i < 30; ++i)
+	{
+		bPickedFailed |= Pool.Pick(Now) == Failed;
+	}
+	TestFalse(TEXT("A node that is down gets no traffic"), bPickedFailed);
+
+	// once every node is down sending stops, and the node due back first is probed
+	Pool.GetEndpoints()[0]->Health.RecordFailure(Now);
+	Pool.GetEndpoints()[2]->Health.RecordFailure(Now);
+	TestFalse(TEXT("Nothing available once every node is down"), Pool.HasAvailable(Now));
+
+	const double AfterBackoff = Now + 8.0;
+	TestTrue(TEXT("Nodes are available again after their backoff"), Pool.HasAvailable(AfterBackoff));
+	const FElasticTelemetryEndpointRef Probe = Pool.Pick(AfterBackoff);
+	TestTrue(TEXT("A node whose backoff elapsed gets a single probe"),
+	    Probe->Health.GetState() == FElasticTelemetryCircuitBreaker::EState::HalfOpen);
+	Probe->Health.RecordSuccess();
+	TestTrue(TEXT("A successful probe puts the node back in rotation"), Pool.Pick(AfterBackoff) == Probe);
+
+	// health survives a reconfiguration that keeps the node
+	const TArray<FString>         Remaining = {FString(TEXT("http://es-2:9200/")), FString(TEXT("http://es-4:9200/"))};
+	FElasticTelemetryEndpointPool Replaced(Remaining, TEXT("uelog"), &Pool, 1.0, 8.0);
+	TestTrue(TEXT("A node that stays is the same node"), Replaced.GetEndpoints()[0] == Failed);
+	TestTrue(TEXT("A new node starts healthy"), Replaced.GetEndpoints()[1]->Health.IsClosed());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryNodeDiscoveryTest, "ElasticTelemetry.Connection.NodeDiscovery",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryNodeDiscoveryTest::RunTest(const FString & Parameters)
+{
+	const FString Response = TEXT("{\"nodes\":{"
+	                              "\"aB3\":{\"http\":{\"publish_address\":\"10.0.0.1:9200\"}},"
+	                              "\"cD4\":{\"http\":{\"publish_address\":\"es-2.internal/10.0.0.2:9201\"}},"
+	                              "\"eF5\":{}}}");
+
+	TArray<FString> URLs;
+	TestTrue(TEXT("Response parses"), FElasticTelemetryEndpointPool::ParseNodesHttp(Response, TEXT("https"), URLs));
+	TestEqual(TEXT("Nodes without HTTP are skipped"), URLs.Num(), 2);
+	TestTrue(TEXT("Plain address"), URLs.Contains(TEXT("https://10.0.0.1:9200/")));
+	TestTrue(TEXT("Host name preferred over its address"), URLs.Contains(TEXT("https://es-2.internal:9201/")));
+
+	TArray<FString> Unused;
+	TestFalse(TEXT("An error body is not a node list"),
+	    FElasticTelemetryEndpointPool::ParseNodesHttp(TEXT("{\"error\":\"unauthorized\"}"), TEXT("https"), Unused));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryRollingIndexTest, "ElasticTelemetry.Connection.RollingIndex",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryRollingIndexTest::RunTest(const FString & Parameters)
+{
+	const FString   Pattern = FileNameFriendly(TEXT("UELog-{yyyy.MM.dd}"));
+	const FDateTime LastSecond(2024, 3, 7, 23, 59, 59);
+	TestEqual(TEXT("Date fields keep their case"), Pattern, FString(TEXT("uelog-{yyyy.MM.dd}")));
+	TestTrue(TEXT("Pattern has date fields"), FElasticTelemetryIndexName::HasDateFields(Pattern));
+	TestEqual(TEXT("Resolved with the date"), FElasticTelemetryIndexName::Resolve(Pattern, LastSecond),
+	    FString(TEXT("uelog-2024.03.07")));
+	TestEqual(TEXT("Short year"), FElasticTelemetryIndexName::Resolve(TEXT("uelog-{yyMMdd}"), LastSecond),
+	    FString(TEXT("uelog-240307")));
+	TestEqual(TEXT("Rolls over at the next UTC midnight"), FElasticTelemetryIndexName::GetNextRollover(LastSecond),
+	    FDateTime(2024, 3, 8));
+	TestEqual(TEXT("Searches cover every day"), FElasticTelemetryIndexName::ToWildcard(Pattern),
+	    FString(TEXT("uelog-*")));
+	TestFalse(TEXT("A plain name"), FElasticTelemetryIndexName::HasDateFields(TEXT("uelog")));
+	TestEqual(TEXT("An unclosed brace is text"), FElasticTelemetryIndexName::Resolve(TEXT("uelog-{yyyy"), LastSecond),
+	    FString(TEXT("uelog-{yyyy")));
+
+	// the connection resolves on publish, and only looks again once the day is over
+	FElasticTelemetryConnection Connection;
+	Connection.Publish(TEXT("http://localhost:9200"), Pattern, TEXT("elastic"), TEXT("changeme"));
+	FElasticTelemetryConnection::FProfileRef Cached = Connection.GetPublished();
+	TestEqual(TEXT("Today's index"), Connection.Get(Cached)->IndexName,
+	    FElasticTelemetryIndexName::Resolve(Pattern, FDateTime::UtcNow()));
+	TestTrue(TEXT("Today's bulk URL"), Connection.Get(Cached)->Endpoints->GetEndpoints()[0]->BulkURL.EndsWith(
+	                                       Connection.Get(Cached)->IndexName + TEXT("/_bulk")));
+
+	const uint64 Version = Connection.GetVersion();
+	TestFalse(TEXT("Nothing to roll before midnight"), Connection.RollIndex(FPlatformTime::Seconds()));
+	TestEqual(TEXT("Nothing republished"), Connection.GetVersion(), Version);
+
+	// data streams only take create, a node keeps its health across the change of URLs
+	const FElasticTelemetryEndpointRef Before = Connection.Get(Cached)->Endpoints->GetEndpoints()[0];
+	Before->Health.RecordFailure(FPlatformTime::Seconds());
+	Connection.SetDataStream(true);
+	const FElasticTelemetryConnectionProfile & Stream = Connection.Get(Cached).Get();
+	TestTrue(TEXT("Profile is for a data stream"), Stream.bDataStream);
+	TestTrue(TEXT("Single documents are created"),
+	    Stream.Endpoints->GetEndpoints()[0]->DocumentURL.EndsWith(TEXT("/_doc?op_type=create")));
+	TestFalse(TEXT("A node that was down is still down"), Stream.Endpoints->GetEndpoints()[0]->Health.IsClosed());
+	return true;
+}
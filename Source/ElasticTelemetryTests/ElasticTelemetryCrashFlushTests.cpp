@@ -0,0 +1,310 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "ElasticTelemetryCrashBuffer.h"
+#include "ElasticTelemetryCrashHandler.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetrySpool.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	std::string MakeCrashLine(const uint32 Index)
+	{
+		return "{\"log\":{\"message\":\"line " + std::to_string(Index) + "\"}}";
+	}
+
+	std::string ToString(const TArrayView<const uint8> & Body)
+	{
+		return std::string(reinterpret_cast<const char *>(Body.GetData()), Body.Num());
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCrashBufferTest, "ElasticTelemetry.CrashFlush.Buffer",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCrashBufferTest::RunTest(const FString & Parameters)
+{
+	const std::string_view Action = "{\"index\":{}}\n";
+
+	// the newest lines are kept, oldest first, and the ring wraps without losing a byte
+	FElasticTelemetryCrashBuffer Buffer;
+	Buffer.Reserve(3, 64, 32);
+	const SIZE_T Allocated = Buffer.GetAllocatedSize();
+	for (uint32 i = 0; i < 10; ++i)
+	{
+		Buffer.AddLine(MakeCrashLine(i));
+	}
+	TestEqual(TEXT("Only the newest lines are kept"), Buffer.GetLineCount(), 2);
+	const std::string Lines = std::string(Action) + MakeCrashLine(8) + "\n" + std::string(Action) + MakeCrashLine(9) +
+	                          "\n" + std::string(Action) + "{\"fatal\":1}\n";
+	TestTrue(TEXT("The body holds them oldest first, then the last line"),
+	    ToString(Buffer.BuildBulkBody(Action, "{\"fatal\":1}")) == Lines);
+	TestEqual(TEXT("Adding lines and building the body allocates nothing"), Buffer.GetAllocatedSize(), Allocated);
+
+	// Herald pretty prints, each line is compacted onto one line of the body
+	Buffer.Reset();
+	Buffer.AddLine("{\n    \"log\": {\n        \"message\": \"a b\\n\"\n    }\n}");
+	TestTrue(TEXT("Lines are compacted"),
+	    ToString(Buffer.BuildBulkBody(Action, "{\n    \"fatal\": 1\n}")) ==
+	        std::string(Action) + "{\"log\":{\"message\":\"a b\\n\"}}\n" + std::string(Action) + "{\"fatal\":1}\n");
+
+	// a line count bound, with short lines
+	Buffer.Reset();
+	for (const char * Line : {"a", "b", "c", "d"})
+	{
+		Buffer.AddLine(Line);
+	}
+	TestTrue(TEXT("At most MaxLines are kept"),
+	    ToString(Buffer.BuildBulkBody(Action, std::string_view())) ==
+	        std::string(Action) + "b\n" + std::string(Action) + "c\n" + std::string(Action) + "d\n");
+
+	// a line that could never fit is skipped, a last line that is too long is cut short
+	Buffer.Reset();
+	Buffer.AddLine(std::string(65, 'x'));
+	TestEqual(TEXT("An oversized line is skipped"), Buffer.GetLineCount(), 0);
+	TestTrue(TEXT("The last line is cut at MaxLastBytes"),
+	    ToString(Buffer.BuildBulkBody(Action, std::string(40, 'y'))) ==
+	        std::string(Action) + std::string(32, 'y') + "\n");
+	TestEqual(TEXT("Still nothing allocated"), Buffer.GetAllocatedSize(), Allocated);
+
+	// the fatal line, then the crash report, each bound on its own
+	Buffer.Reset();
+	Buffer.AddLine("a");
+	TestTrue(TEXT("The fatal line goes before the crash report"),
+	    ToString(Buffer.BuildBulkBody(Action, "{\"fatal\":1}", std::string(40, 'y'))) ==
+	        std::string(Action) + "a\n" + std::string(Action) + "{\"fatal\":1}\n" + std::string(Action) +
+	            std::string(32, 'y') + "\n");
+	TestEqual(TEXT("Two last lines fit in what was reserved"), Buffer.GetAllocatedSize(), Allocated);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCrashFlushWriterTest, "ElasticTelemetry.CrashFlush.Writer",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCrashFlushWriterTest::RunTest(const FString & Parameters)
+{
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / TEXT("Crash");
+	const std::string Report("{\"log\":{\"message\":\"callstack\"}}");
+
+	// The fatal line is sent as usual, then the crash handler flushes. With the priority lane the fatal line is
+	// already sent by then, without it the line still lingers in the queue. The segment holds it once either way.
+	for (const bool bPriorityLane : {true, false})
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+		// lines linger in the queue, nothing but the priority lane reaches the transport before the crash
+		Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+		                                   ->addConfigPair("IndexName", "uelog")
+		                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+		                                   .addConfigPair("FlushLingerMilliseconds", "60000")
+		                                   .addConfigPair("PriorityLane", bPriorityLane ? "True" : "False")
+		                                   .addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*Directory))
+		                                   .addConfigPair("CrashFlushLines", "50")
+		                                   .build();
+		const TSharedRef<FElasticTelemetryNullTransport, ESPMode::ThreadSafe> Transport =
+		    MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>(200);
+		AsElasticTelemetryWriter(Writer)->SetTransport(Transport);
+
+		const uint32 Count = 300;
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Writer->write(MakeCrashLine(i));
+		}
+		{
+			FElasticTelemetryLogLevelScope Fatal(Herald::LogLevels::Fatal);
+			Writer->write(MakeCrashLine(Count));
+		}
+		if (bPriorityLane)
+		{
+			const auto Sent = [&Transport]() { return Transport->GetDocuments() == 1; };
+			TestTrue(TEXT("The fatal line is sent at once"), FElasticTelemetryStandInServer::PumpHttpUntil(Sent));
+		}
+		TestEqual(TEXT("The fatal line does not flush the queue"),
+		    AsElasticTelemetryWriter(Writer)->GetStats().QueuedMessages, bPriorityLane ? Count : Count + 1);
+
+		// what the crash handler does with the system error's callstack
+		TestTrue(TEXT("The crash handler flushes"), AsElasticTelemetryWriter(Writer)->FlushForCrash(Report));
+		TestEqual(TEXT("The queue is emptied into the spool"),
+		    AsElasticTelemetryWriter(Writer)->GetStats().QueuedMessages, 0u);
+		TestFalse(TEXT("The crash flush only runs once"), AsElasticTelemetryWriter(Writer)->FlushForCrash("{}"));
+		Writer.reset();
+
+		std::string Expected;
+		for (uint32 i = Count - 50; i <= Count; ++i)
+		{
+			Expected += "{\"index\":{}}\n" + MakeCrashLine(i) + "\n";
+		}
+		Expected += "{\"index\":{}}\n" + Report + "\n";
+
+		FElasticTelemetrySpool          Spool;
+		FElasticTelemetrySpool::FRecord Record;
+		TestTrue(TEXT("Spool reopens"), Spool.Open(Directory, 1024 * 1024));
+		if (TestTrue(TEXT("The crash left a record"), Spool.ReadNext(Record)))
+		{
+			TestTrue(TEXT("The record is a _bulk body"), (Record.Flags & FElasticTelemetrySpool::Bulk) != 0);
+			TestTrue(TEXT("The newest 50 lines, the fatal line once and the crash report, in order"),
+			    ToString(Record.Payload) == Expected);
+			TestEqual(TEXT("The record counts its documents"), Record.Documents, 52u);
+		}
+		TestFalse(TEXT("Only one record"), Spool.ReadNext(Record));
+		Spool.Close();
+	}
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCrashFlushRearmTest, "ElasticTelemetry.CrashFlush.Rearm",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCrashFlushRearmTest::RunTest(const FString & Parameters)
+{
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / TEXT("Rearm");
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+	                                   ->addConfigPair("IndexName", "uelog")
+	                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+	                                   .addConfigPair("FlushLingerMilliseconds", "60000")
+	                                   .addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*Directory))
+	                                   .addConfigPair("CrashFlushLines", "50")
+	                                   .build();
+	AsElasticTelemetryWriter(Writer)->SetTransport(MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>());
+	for (uint32 i = 0; i < 100; ++i)
+	{
+		Writer->write(MakeCrashLine(i));
+	}
+
+	// a crash while the config changes: the flush works from whichever state it loaded, never a half built one
+	std::atomic<bool> bFlushed(false);
+	ParallelFor(2, [&Writer, &bFlushed](const int32 Thread) {
+		if (Thread == 0)
+		{
+			bFlushed = AsElasticTelemetryWriter(Writer)->FlushForCrash("{}");
+			return;
+		}
+		for (int32 i = 0; i < 20; ++i)
+		{
+			Writer->addConfigPair("CrashFlushLines", std::to_string(10 + i));
+			Writer->addConfigPair("UseDataStream", i % 2 ? "True" : "False");
+		}
+	});
+	TestTrue(TEXT("The crash flush ran"), bFlushed.load());
+	TestFalse(TEXT("Re-arming does not run it again"), AsElasticTelemetryWriter(Writer)->FlushForCrash("{}"));
+	Writer.reset();
+
+	FElasticTelemetrySpool          Spool;
+	FElasticTelemetrySpool::FRecord Record;
+	TestTrue(TEXT("Spool reopens"), Spool.Open(Directory, 1024 * 1024));
+	if (TestTrue(TEXT("The crash left a record"), Spool.ReadNext(Record)))
+	{
+		const std::string Body = ToString(Record.Payload);
+		TestTrue(TEXT("The record ends with the crash report"),
+		    Body.size() > 3 && Body.compare(Body.size() - 3, 3, "{}\n") == 0);
+	}
+	Spool.Close();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCrashDocumentTest, "ElasticTelemetry.CrashFlush.Document",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCrashDocumentTest::RunTest(const FString & Parameters)
+{
+	const TCHAR *   Message = TEXT("Assertion failed: \"quoted\" \\ path\r\n\ttab \x01 caf\u00e9 \U0001F600");
+	const FDateTime Utc(2024, 3, 9, 7, 5, 2, 45);
+
+	// the crash handler takes the headers of the log transformer as they are at the crash, late ones included
+	const Herald::ILogTransformerPtr Transformer = createElasticTelemetryJsonTransformerBuilder()->build();
+	Transformer->addHeader("SessionID", "abc");
+	const std::shared_ptr<const std::string> Fragment =
+	    AsElasticTelemetryJsonTransformer(Transformer)->GetHeaderFragment();
+	Transformer->addHeader("UserName", "later");
+	const FAnsiStringView Headers(Fragment->data(), static_cast<int32>(Fragment->size()));
+
+	ANSICHAR    Out[1024];
+	const int32 Size = FElasticTelemetryCrashHandler::FormatDocument(
+	    Out, UE_ARRAY_COUNT(Out), Message, TEXT("Crash"), Utc, Headers);
+	if (!TestTrue(TEXT("The document fits"), Size > 0))
+		return false;
+
+	TSharedPtr<FJsonObject>         Json;
+	const FString                   Text   = UTF8_TO_TCHAR(std::string(Out, Size).c_str());
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+	if (!TestTrue(TEXT("The document is valid JSON"), FJsonSerializer::Deserialize(Reader, Json) && Json.IsValid()))
+		return false;
+
+	const TSharedPtr<FJsonObject> Log = Json->GetObjectField(TEXT("log"));
+	TestEqual(TEXT("The message survives escaping"), Log->GetStringField(TEXT("message")), FString(Message));
+	TestEqual(TEXT("Fatal level"), Log->GetStringField(TEXT("level")), FString(TEXT("Fatal")));
+	TestEqual(TEXT("Category"), Log->GetStringField(TEXT("Category")), FString(TEXT("Crash")));
+	TestEqual(TEXT("Headers"), Json->GetObjectField(TEXT("headers"))->GetStringField(TEXT("SessionID")),
+	    FString(TEXT("abc")));
+	TestFalse(TEXT("A snapshot does not follow later changes"),
+	    Json->GetObjectField(TEXT("headers"))->HasField(TEXT("UserName")));
+	TestEqual(TEXT("Timestamp"), Json->GetStringField(TEXT("timestamp")),
+	    FString(TEXT("2024-03-09T07:05:02.045+0000")));
+
+	TestEqual(TEXT("A document that does not fit is not written"),
+	    FElasticTelemetryCrashHandler::FormatDocument(Out, 16, Message, TEXT("Crash"), Utc, Headers),
+	    0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCrashDocumentTruncatedTest,
+    "ElasticTelemetry.CrashFlush.DocumentTruncated",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCrashDocumentTruncatedTest::RunTest(const FString & Parameters)
+{
+	// far past the buffer once escaped and encoded, with quotes, control characters and multibyte text to cut through
+	FString Message;
+	while (Message.Len() < 30000)
+	{
+		Message += TEXT("\"at\" caf\u00e9 \u20ac \U0001F600 \\ \x01\r\n");
+	}
+	const FDateTime Utc(2024, 3, 9, 7, 5, 2, 45);
+	const char      Headers[] = "\"headers\":{\"SessionID\":\"abc\"}";
+
+	TArray<ANSICHAR> Out;
+	Out.SetNumUninitialized(FElasticTelemetryCrashHandler::DocumentMaxBytes);
+
+	// every cut lands on a different byte of a character or escape, none may break the document
+	for (int32 Capacity = Out.Num() - 40; Capacity <= Out.Num(); ++Capacity)
+	{
+		const int32 Size = FElasticTelemetryCrashHandler::FormatDocument(
+		    Out.GetData(), Capacity, *Message, TEXT("Crash"), Utc, FAnsiStringView(Headers, sizeof(Headers) - 1));
+		if (!TestTrue(TEXT("The document is written"), Size > 0 && Size <= Capacity))
+			return false;
+
+		TSharedPtr<FJsonObject>         Json;
+		const FString                   Text   = UTF8_TO_TCHAR(std::string(Out.GetData(), Size).c_str());
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+		if (!TestTrue(TEXT("The document is valid JSON"), FJsonSerializer::Deserialize(Reader, Json) && Json.IsValid()))
+			return false;
+
+		const FString Kept = Json->GetObjectField(TEXT("log"))->GetStringField(TEXT("message"));
+		TestTrue(TEXT("The message is cut"), Kept.Len() > 0 && Kept.Len() < Message.Len());
+		TestTrue(
+		    TEXT("What is kept is the start of the message"), Message.StartsWith(Kept, ESearchCase::CaseSensitive));
+		TestEqual(TEXT("Headers"), Json->GetObjectField(TEXT("headers"))->GetStringField(TEXT("SessionID")),
+		    FString(TEXT("abc")));
+		TestEqual(TEXT("Timestamp"), Json->GetStringField(TEXT("timestamp")),
+		    FString(TEXT("2024-03-09T07:05:02.045+0000")));
+	}
+	return true;
+}
@@ -0,0 +1,43 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/Thread.h"
+#include "ElasticTelemetryInFlightWindow.h"
+#include <atomic>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryInFlightWindowTest, "ElasticTelemetry.InFlight.Window",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryInFlightWindowTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryInFlightWindow Window(2);
+	TestTrue(TEXT("First slot"), Window.Acquire());
+	TestTrue(TEXT("Second slot"), Window.Acquire());
+	TestFalse(TEXT("Window is full"), Window.HasFreeSlot());
+	TestEqual(TEXT("Acquiring free slots never waits"), Window.GetWaits(), 0ull);
+
+	// a completion on another thread frees a slot while the worker is blocked
+	std::atomic<bool> bAcquired(false);
+	FThread           Worker(TEXT("InFlightWorker"), [&Window, &bAcquired]() { bAcquired = Window.Acquire(); });
+	FPlatformProcess::Sleep(0.05f);
+	TestFalse(TEXT("Worker blocks on a full window"), bAcquired.load());
+
+	const double ReleasedAt = FPlatformTime::Seconds();
+	Window.Release();
+	Worker.Join();
+	const double WokenAfter = FPlatformTime::Seconds() - ReleasedAt;
+
+	TestTrue(TEXT("Release wakes the worker"), bAcquired.load());
+	TestTrue(TEXT("Worker wakes promptly rather than on a poll interval"), WokenAfter < 0.05);
+	TestEqual(TEXT("The wait is counted"), Window.GetWaits(), 1ull);
+	TestTrue(TEXT("The wait time is recorded"), Window.GetWaitSeconds() >= 0.04);
+	TestEqual(TEXT("Peak in flight"), Window.GetPeak(), 2);
+
+	Window.SetLimit(3);
+	TestTrue(TEXT("Raising the limit frees a slot"), Window.HasFreeSlot());
+
+	Window.Cancel();
+	TestFalse(TEXT("A cancelled window refuses slots"), Window.Acquire());
+	return true;
+}
@@ -0,0 +1,220 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/Thread.h"
+#include "ElasticTelemetryBulkBuilder.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryTimeStamp.h"
+#include "Herald/GetTimeStamp.hpp"
+#include "Herald/JsonLogTransformerFactory.hpp"
+#include "Herald/LogEntry.hpp"
+#include <atomic>
+#include <string>
+
+namespace
+{
+	/// <summary>
+	/// A document without its timestamp, which differs between two transformers logging one after the other.
+	/// </summary>
+	std::string WithoutTimeStamp(const std::string & Json)
+	{
+		return Json.substr(0, Json.find(",\"timestamp\":\""));
+	}
+
+	thread_local int64 LastGeneration = -1; // the newest header set each logging thread has seen
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryJsonTransformerTest, "ElasticTelemetry.JsonTransformer.MatchesHerald",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryJsonTransformerTest::RunTest(const FString & Parameters)
+{
+	// Herald pretty prints, compacted the way the bulk builder does it the two must be byte for byte the same
+	std::string Expected;
+	std::string Actual;
+	const auto  Compacted = [&Expected](const std::string & Json) {
+		TArray<uint8> Compact;
+		AppendCompactJson(Compact, Json);
+		Expected.assign(reinterpret_cast<const char *>(Compact.GetData()), Compact.Num());
+	};
+	const auto  AsIs      = [&Actual](const std::string & Json) { Actual = Json; };
+
+	Herald::ILogTransformerPtr Reference =
+	    Herald::createJsonLogTransformerBuilder()->attachLogWriterCallback(Compacted).build();
+	Herald::ILogTransformerPtr Transformer =
+	    createElasticTelemetryJsonTransformerBuilder()->attachLogWriterCallback(AsIs).build();
+
+	// straight to log(), Herald::log() would skip levels disabled elsewhere
+	const auto Same = [&](const TCHAR * What, const Herald::LogEntry & Entry) {
+		Reference->log(Entry);
+		Transformer->log(Entry);
+		TestTrue(What, WithoutTimeStamp(Actual) == WithoutTimeStamp(Expected));
+		TestEqual(TEXT("The timestamp has Herald's format"), Actual.size() - WithoutTimeStamp(Actual).size(),
+		    Expected.size() - WithoutTimeStamp(Expected).size());
+	};
+	const auto ForBoth = [&](const auto & Change) {
+		Change(*Reference);
+		Change(*Transformer);
+	};
+
+	Same(TEXT("No headers"), Herald::LogEntry(Herald::LogLevels::Info, "plain"));
+
+	ForBoth([](Herald::ILogTransformer & T) {
+		T.addHeader("SessionID", "9F1C");
+		T.addHeader("ComputerName", "BUILD \"07\"");
+		T.addHeader("UserName", "tab\there");
+	});
+	Same(TEXT("Headers and metadata in key order"),
+	    Herald::LogEntry(Herald::LogLevels::Debug, "Loaded package", "Verbosity", "Log", "Category", "LogStreaming"));
+	Same(TEXT("Escaping"),
+	    Herald::LogEntry(Herald::LogLevels::Warning, "quote \" backslash \\ /\b\f\n\r\t\x01\x1f\x7f caf\xc3\xa9",
+	        "key \"1\"", "C:\\Temp"));
+	Same(TEXT("Events"), Herald::LogEntry(Herald::LogLevels::Event, "PlayerDeath", "Location", "1,2,3"));
+	for (const Herald::LogLevels Level : {Herald::LogLevels::Analysis, Herald::LogLevels::Trace,
+	         Herald::LogLevels::Error, Herald::LogLevels::Fatal})
+	{
+		Same(TEXT("Every level"), Herald::LogEntry(Level, ""));
+	}
+
+	ForBoth([](Herald::ILogTransformer & T) {
+		T.removeHeader("ComputerName");
+		T.addHeader("SessionID", "A0B1");
+	});
+	Same(TEXT("Header changes"), Herald::LogEntry(Herald::LogLevels::Info, "after"));
+
+	ForBoth([](Herald::ILogTransformer & T) {
+		T.removeHeader("SessionID");
+		T.removeHeader("UserName");
+	});
+	Same(TEXT("Every header removed"), Herald::LogEntry(Herald::LogLevels::Info, "none left"));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryJsonTransformerHeadersTest,
+    "ElasticTelemetry.JsonTransformer.ConcurrentHeaders",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryJsonTransformerHeadersTest::RunTest(const FString & Parameters)
+{
+	// 8 threads log while this one keeps changing headers. Every line must carry one whole header set, and no
+	// thread may see an older set after a newer one.
+	constexpr int32   Threads = 8;
+	constexpr int32   Lines   = 20000;
+	const std::string Extra(200, 'x');
+	const std::string ExtraField = "\"Extra\":\"" + Extra + "\"";
+
+	std::atomic<int32> Documents(0);
+	std::atomic<int32> Torn(0);
+	std::atomic<int32> Backwards(0);
+	const auto         Check = [&](const std::string & Json) {
+		const size_t At   = Json.find("\"Generation\":\"");
+		const int64  Seen = At == std::string::npos ? -1 : FCStringAnsi::Atoi64(Json.c_str() + At + 14);
+		if (Seen < LastGeneration)
+			++Backwards;
+		LastGeneration = Seen;
+
+		const size_t ExtraAt = Json.find("\"Extra\":");
+		if (ExtraAt != std::string::npos && Json.compare(ExtraAt, ExtraField.size(), ExtraField) != 0)
+			++Torn;
+		++Documents;
+	};
+	Herald::ILogTransformerPtr Transformer =
+	    createElasticTelemetryJsonTransformerBuilder()->attachLogWriterCallback(Check).build();
+
+	std::atomic<int32>          Finished(0);
+	TArray<TUniquePtr<FThread>> Loggers;
+	for (int32 Thread = 0; Thread < Threads; ++Thread)
+	{
+		Loggers.Add(MakeUnique<FThread>(TEXT("ElasticTelemetryHeaderLogger"), [&]() {
+			LastGeneration = -1;
+			const Herald::LogEntry Entry(Herald::LogLevels::Info, "a line", "Category", "LogTemp");
+			for (int32 i = 0; i < Lines; ++i)
+			{
+				Transformer->log(Entry);
+			}
+			++Finished;
+		}));
+	}
+
+	int64 Generation = 0;
+	while (Finished < Threads)
+	{
+		Transformer->addHeader("Generation", std::to_string(++Generation));
+		if (Generation % 2)
+			Transformer->addHeader("Extra", Extra);
+		else
+			Transformer->removeHeader("Extra");
+	}
+	for (auto & Logger : Loggers)
+	{
+		Logger->Join();
+	}
+
+	AddInfo(FString::Printf(TEXT("%lld header changes while %d threads logged"), Generation * 2, Threads));
+	TestEqual(TEXT("Every line is written"), Documents.load(), Threads * Lines);
+	TestEqual(TEXT("No line mixes two header sets"), Torn.load(), 0);
+	TestEqual(TEXT("No thread goes back to an older header set"), Backwards.load(), 0);
+
+	// the last change is what the next line carries
+	LastGeneration = -1;
+	Transformer->log(Herald::LogEntry(Herald::LogLevels::Info, "after"));
+	TestEqual(TEXT("The newest header set is current"), LastGeneration, Generation);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryTimeStampTest, "ElasticTelemetry.JsonTransformer.TimeStamp",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryTimeStampTest::RunTest(const FString & Parameters)
+{
+	ANSICHAR Buffer[FElasticTelemetryTimeStamp::BufferSize];
+
+	// every millisecond digit, second and minute rollovers, and a spread of dates cached and formatted afresh
+	int32      Mismatches = 0;
+	const auto Now        = std::chrono::system_clock::now();
+	const auto Epoch      = std::chrono::system_clock::from_time_t(0);
+	for (const auto & Start : {Now, Epoch + std::chrono::hours(24 * 365 * 30), Epoch + std::chrono::hours(24 * 20000)})
+	{
+		for (int32 Step = 0; Step < 150000; ++Step)
+		{
+			const auto TimePoint = Start + std::chrono::microseconds(Step * 499);
+			if (FElasticTelemetryTimeStamp::Format(TimePoint, Buffer) != Herald::getTimeStamp(TimePoint))
+				++Mismatches;
+		}
+	}
+	TestEqual(TEXT("Timestamps match Herald::getTimeStamp()"), Mismatches, 0);
+
+	// the monotonic source starts at the wall clock and never goes backwards
+	const auto Wall      = FElasticTelemetryTimeStamp::Now(false);
+	auto       Previous  = FElasticTelemetryTimeStamp::Now(true);
+	int32      Backwards = 0;
+	for (int32 Step = 0; Step < 100000; ++Step)
+	{
+		const auto Current = FElasticTelemetryTimeStamp::Now(true);
+		Backwards += Current < Previous ? 1 : 0;
+		Previous = Current;
+	}
+	TestEqual(TEXT("Monotonic timestamps never go backwards"), Backwards, 0);
+	TestTrue(TEXT("Monotonic timestamps are anchored to the wall clock"),
+	    std::chrono::abs(Previous - Wall) < std::chrono::seconds(60));
+
+	// lines carry it, in either mode
+	std::string Json;
+	auto        Transformer = createElasticTelemetryJsonTransformerBuilder()
+	                       ->attachLogWriterCallback([&Json](const std::string & Line) { Json = Line; })
+	                       .build();
+	for (const bool bMonotonic : {false, true})
+	{
+		AsElasticTelemetryJsonTransformer(Transformer)->SetMonotonicTimeStamps(bMonotonic);
+		Transformer->log(Herald::LogEntry(Herald::LogLevels::Info, "stamped"));
+
+		const size_t      Start     = Json.find(",\"timestamp\":\"") + 14;
+		const std::string TimeStamp = Json.substr(Start, Json.size() - Start - 2);
+		TestEqual(TEXT("The line carries a whole timestamp"), static_cast<int32>(TimeStamp.size()),
+		    static_cast<int32>(Herald::getTimeStamp().size()));
+		TestTrue(TEXT("With milliseconds and a UTC offset"),
+		    TimeStamp.size() > 24 && TimeStamp[19] == '.' && (TimeStamp[23] == '+' || TimeStamp[23] == '-'));
+	}
+	return true;
+}
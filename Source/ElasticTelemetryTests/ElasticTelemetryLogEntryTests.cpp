@@ -0,0 +1,194 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "StringConversions.h"
+#include "Misc/AutomationTest.h"
+#include "Dom/JsonObject.h"
+#include "ETLogger.h"
+#include "ElasticTelemetryAllocationCounter.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryLogEntry.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include "Herald/LogEntry.hpp"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <limits>
+#include <string>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryLogEntryTest, "ElasticTelemetry.LogEntry.TypedMetadata",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryLogEntryTest::RunTest(const FString & Parameters)
+{
+	const FString     Weapon(TEXT("Rocket Launcher"));
+	const std::string Map("Arena_Chunk_12_Streaming");
+	const FName       Team(TEXT("Red"));
+	const uint64      Huge = std::numeric_limits<uint64>::max();
+
+	std::string Json;
+	auto        Transformer = createElasticTelemetryJsonTransformerBuilder()
+	                       ->attachLogWriterCallback([&Json](const std::string & Line) { Json = Line; })
+	                       .build();
+
+	// eight fields of every kind fit inline
+	{
+		FElasticTelemetryAllocationCounter Counter;
+		FElasticTelemetryLogEntry          Entry(Herald::LogLevels::Event, TEXT("PlayerDeath caf\u00e9"), "Health", 0,
+		             "Damage", 37.5f, "Headshot", true, "Weapon", Weapon, "Map", Map, "Frame", Huge, "Killer",
+		             TEXT("Bot_07"), "Team", Team);
+		TestEqual(TEXT("Building eight fields allocates nothing"), Counter.GetAllocations(), 0ull);
+		TestEqual(TEXT("Eight fields"), Entry.GetFields().Num(), 8);
+		TestEqual(TEXT("Nothing on the heap"), Entry.GetAllocatedSize(), static_cast<SIZE_T>(0));
+
+		AsElasticTelemetryJsonTransformer(Transformer)->Log(Entry);
+	}
+
+	TSharedPtr<FJsonObject>         Document;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(UTF8_TO_TCHAR(Json.c_str()));
+	if (!TestTrue(TEXT("The document is valid JSON"), FJsonSerializer::Deserialize(Reader, Document)))
+		return false;
+
+	const TSharedPtr<FJsonObject> LogObject = Document->GetObjectField(TEXT("log"));
+	TestEqual(TEXT("Event name, converted from TCHAR"), LogObject->GetStringField(TEXT("event")),
+	    FString(TEXT("PlayerDeath caf\u00e9")));
+	TestEqual(TEXT("Integers are numbers"), LogObject->GetField<EJson::Number>(TEXT("Health"))->AsNumber(), 0.0);
+	TestEqual(TEXT("Floats are numbers"), LogObject->GetField<EJson::Number>(TEXT("Damage"))->AsNumber(), 37.5);
+	TestTrue(TEXT("Bools are booleans"), LogObject->GetField<EJson::Boolean>(TEXT("Headshot"))->AsBool());
+	TestEqual(TEXT("FString"), LogObject->GetStringField(TEXT("Weapon")), Weapon);
+	TestEqual(TEXT("std::string"), LogObject->GetStringField(TEXT("Map")), FString(UTF8_TO_TCHAR(Map.c_str())));
+	TestEqual(TEXT("TCHAR*"), LogObject->GetStringField(TEXT("Killer")), FString(TEXT("Bot_07")));
+	TestEqual(TEXT("FName"), LogObject->GetStringField(TEXT("Team")), FString(TEXT("Red")));
+	TestTrue(TEXT("uint64 past int64 is still a number"), LogObject->HasTypedField<EJson::Number>(TEXT("Frame")));
+	TestTrue(TEXT("Whole doubles keep a fraction"), Json.find("\"Damage\":37.5") != std::string::npos);
+
+	// past the inline capacity the entry spills to the heap and keeps working, a repeated key takes the new value
+	{
+		FElasticTelemetryLogEntry Entry(Herald::LogLevels::Info, "Spilled");
+		for (int32 i = 0; i < FElasticTelemetryLogEntry::InlineFields + 4; ++i)
+		{
+			Entry.Add(FString::Printf(TEXT("Key%d"), i), i);
+		}
+		Entry.Add("Key0", 2.0);
+		Entry.Add("NotANumber", std::numeric_limits<double>::quiet_NaN(), "Location", FVector(1.0, 2.0, 3.0));
+		TestTrue(TEXT("More fields than fit inline allocate"), Entry.GetAllocatedSize() > 0);
+		TestEqual(TEXT("A repeated key is not added twice"), Entry.GetFields().Num(),
+		    FElasticTelemetryLogEntry::InlineFields + 6);
+
+		AsElasticTelemetryJsonTransformer(Transformer)->Log(Entry);
+		TestTrue(TEXT("The repeated key has the new value"), Json.find("\"Key0\":2.0,") != std::string::npos);
+		TestTrue(TEXT("The last spilled field is written"),
+		    Json.find("\"Key11\":11,") != std::string::npos);
+		TestTrue(TEXT("NaN is null"), Json.find("\"NotANumber\":null") != std::string::npos);
+		TestTrue(TEXT("Other types go through std::to_string"),
+		    Json.find("\"Location\":\"" + std::to_string(FVector(1.0, 2.0, 3.0)) + "\"") != std::string::npos);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryLogEntryAllocationTest, "ElasticTelemetry.LogEntry.EventAllocations",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryLogEntryAllocationTest::RunTest(const FString & Parameters)
+{
+	// Herald::event() from ETLogger.h against the same event as a Herald::LogEntry, end to end into the event writer.
+	// The rest of the path (timestamp, document, queue) is shared, the difference is the metadata.
+	const FElasticTelemetryModule * Module = FModuleManager::GetModulePtr<FElasticTelemetryModule>("ElasticTelemetry");
+	if (!Module || !Module->GetEventTransformer())
+	{
+		AddInfo(TEXT("No event transformer, nothing to measure"));
+		return true;
+	}
+	Herald::ILogTransformer & EventTransformer = *Module->GetEventTransformer();
+	const FString             Weapon(TEXT("Rocket Launcher"));
+
+	const auto Typed = [&Weapon]() {
+		Herald::event(TEXT("AllocationTest"), "Health", 0, "Damage", 37.5f, "Headshot", true, "Weapon", Weapon);
+	};
+	const auto Legacy = [&Weapon, &EventTransformer]() {
+		Herald::event(EventTransformer, "AllocationTest", "Health", 0, "Damage", 37.5f, "Headshot", true, "Weapon",
+		    Weapon);
+	};
+	const auto Fewest = [](const auto & Event) {
+		uint64 Fewest = MAX_uint64;
+		for (int32 Round = 0; Round < 5; ++Round)
+		{
+			FElasticTelemetryAllocationCounter Counter;
+			Event();
+			Fewest = FMath::Min(Fewest, Counter.GetAllocations());
+		}
+		return Fewest;
+	};
+
+	const uint64 TypedAllocations  = Fewest(Typed);
+	const uint64 LegacyAllocations = Fewest(Legacy);
+	AddInfo(FString::Printf(TEXT("Herald::event with 4 fields: %llu allocations typed, %llu through Herald::LogEntry"),
+	    TypedAllocations, LegacyAllocations));
+	TestTrue(TEXT("The typed entry saves at least a map node per field"), TypedAllocations + 4 <= LegacyAllocations);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetrySteadyStateAllocationTest,
+    "ElasticTelemetry.LogEntry.SteadyStateAllocations",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetrySteadyStateAllocationTest::RunTest(const FString & Parameters)
+{
+	// What the output device does for a UE_LOG line, into a writer, once the logging thread's JSON buffer and the
+	// writer's message blocks have warmed up. Only this thread's allocations are counted, not the worker's.
+	Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+	                                   ->addConfigPair("IndexName", "uelog")
+	                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+	                                   .addConfigPair("FlushLingerMilliseconds", "5")
+	                                   .build();
+	AsElasticTelemetryWriter(Writer)->SetTransport(MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>());
+	const Herald::ILogTransformerPtr Transformer =
+	    createElasticTelemetryJsonTransformerBuilder()->attachLogWriter(Writer).build();
+	Transformer->addHeader("SessionID", TCHAR_TO_UTF8(*FGuid::NewGuid().ToString()));
+
+	const std::string Category("LogStreaming");
+	const auto        LogLines = [&Transformer, &Category](const int32 Count) {
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const FElasticTelemetryLogEntry Entry(Herald::LogLevels::Debug,
+			    TEXT("Loaded package /Game/Maps/Arena/Chunk_12 in 42ms"), "Category", Category, "Verbosity", "Log");
+			AsElasticTelemetryJsonTransformer(Transformer)->Log(Entry);
+		}
+	};
+	uint64     Sent = 0;
+	const auto Send = [this, &Writer, &Sent](const int32 Count) {
+		Sent += Count;
+		return TestTrue(TEXT("Every line is sent"), FElasticTelemetryStandInServer::PumpHttpUntil([&Writer, &Sent]() {
+			const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+			return Stats.BatchDocuments.Sum == Sent && Stats.InFlightRequests == 0;
+		}));
+	};
+
+	// the blocks of the first round are back in the pool by the time the second round has been sent
+	constexpr int32 Lines = 100;
+	LogLines(Lines * 4);
+	if (!Send(Lines * 4))
+		return false;
+	LogLines(Lines);
+	if (!Send(Lines))
+		return false;
+
+	const uint64 BlocksAllocated = AsElasticTelemetryWriter(Writer)->GetStats().MessageBlocksAllocated;
+	uint64       Allocations     = 0;
+	{
+		FElasticTelemetryAllocationCounter Counter;
+		LogLines(Lines);
+		Allocations = Counter.GetAllocations();
+	}
+	if (!Send(Lines))
+		return false;
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	AddInfo(FString::Printf(TEXT("%d warm lines: %llu allocations on the logging thread"), Lines, Allocations));
+	TestTrue(TEXT("A warm line allocates next to nothing"), Allocations <= 2);
+	TestEqual(TEXT("Message blocks are reused"), Stats.MessageBlocksAllocated, BlocksAllocated);
+	TestEqual(TEXT("Every block is counted"), Stats.MessageBlocksAllocated + Stats.MessageBlocksReused,
+	    static_cast<uint64>(Lines * 6));
+	return true;
+}
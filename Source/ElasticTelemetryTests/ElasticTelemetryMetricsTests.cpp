@@ -0,0 +1,123 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "ElasticTelemetryAtomicHistogram.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryStatCounters.h"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include <string>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryHistogramTest, "ElasticTelemetry.Metrics.Histogram",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryHistogramTest::RunTest(const FString & Parameters)
+{
+	// small values get a bucket each, larger ones are known to within an eighth
+	for (uint64 Value = 0; Value < FElasticTelemetryHistogram::SubBuckets; ++Value)
+	{
+		TestEqual(TEXT("Exact below SubBuckets"),
+		    FElasticTelemetryHistogram::GetBucketUpperBound(FElasticTelemetryHistogram::GetBucketIndex(Value)), Value);
+	}
+	bool bBounded = true;
+	for (uint64 Value = 1; Value < (1ull << 62); Value = Value * 3 + 1)
+	{
+		const int32  Index = FElasticTelemetryHistogram::GetBucketIndex(Value);
+		const uint64 Upper = FElasticTelemetryHistogram::GetBucketUpperBound(Index);
+		bBounded &= Index < FElasticTelemetryHistogram::BucketCount && Upper >= Value && Upper - Value <= Value / 8;
+	}
+	TestTrue(TEXT("Every value lands in a bucket ending within 12.5% above it"), bBounded);
+	TestEqual(TEXT("The largest value fits"), FElasticTelemetryHistogram::GetBucketIndex(MAX_uint64),
+	    FElasticTelemetryHistogram::BucketCount - 1);
+
+	// relaxed updates from several threads still add up
+	FElasticTelemetryAtomicHistogram Recorder;
+	ParallelFor(4, [&Recorder](const int32 Thread) {
+		for (uint64 Value = 1; Value <= 1000; ++Value)
+		{
+			Recorder.Record(Value);
+		}
+	});
+
+	FElasticTelemetryHistogram Histogram;
+	Recorder.Snapshot(Histogram);
+	TestEqual(TEXT("Every sample is counted"), Histogram.Count, 4000ull);
+	TestEqual(TEXT("Sum"), Histogram.Sum, 4 * 500500ull);
+	TestEqual(TEXT("Max"), Histogram.Max, 1000ull);
+	TestEqual(TEXT("Mean"), Histogram.GetMean(), 500.5);
+
+	const uint64 P50 = Histogram.GetPercentile(0.5);
+	const uint64 P99 = Histogram.GetPercentile(0.99);
+	TestTrue(TEXT("p50 within a bucket of 500"), P50 >= 500 && P50 <= 500 + 500 / 8);
+	TestTrue(TEXT("p99 within a bucket of 990, never above the max"), P99 >= 990 && P99 <= 1000);
+	TestEqual(TEXT("An empty histogram reports 0"), FElasticTelemetryHistogram().GetPercentile(0.99), 0ull);
+
+	FElasticTelemetryHistogram Merged;
+	Merged.Merge(Histogram);
+	Merged.Merge(Histogram);
+	TestEqual(TEXT("Merging adds counts"), Merged.Count, 8000ull);
+	TestEqual(TEXT("Merging keeps percentiles"), Merged.GetPercentile(0.5), P50);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryWriterMetricsTest, "ElasticTelemetry.Metrics.Writer",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryWriterMetricsTest::RunTest(const FString & Parameters)
+{
+	Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+	                                   ->addConfigPair("IndexName", "uelog")
+	                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+	                                   .addConfigPair("FlushLingerMilliseconds", "5")
+	                                   .build();
+	AsElasticTelemetryWriter(Writer)->SetTransport(MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>());
+
+	const auto Idle = [&Writer](const uint64 Documents) {
+		return FElasticTelemetryStandInServer::PumpHttpUntil(
+		    [&Writer, Documents]() {
+			    const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+			    return Stats.BatchDocuments.Sum == Documents && Stats.InFlightRequests == 0 &&
+			           Stats.RequestLatencyMicroseconds.Count == Stats.Requests;
+		    },
+		    5.0);
+	};
+
+	const uint32 Count = 100;
+	uint64       Bytes = 0;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		const std::string Document = "{\"log\":{\"message\":\"metrics line " + std::to_string(i) + "\"}}";
+		Bytes += Document.size();
+		Writer->write(Document);
+	}
+	if (!TestTrue(TEXT("Every line is sent"), Idle(Count)))
+		return false;
+
+	FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Every line is counted on the way in"), Stats.EnqueuedDocuments, static_cast<uint64>(Count));
+	TestEqual(TEXT("With its bytes"), Stats.EnqueuedBytes, Bytes);
+	TestTrue(TEXT("Lines are batched"), Stats.BatchDocuments.Count >= 1 && Stats.BatchDocuments.Count < Count);
+	TestEqual(TEXT("Batch bytes add up to the bodies"), Stats.BatchBytes.Sum, Stats.UncompressedBytes);
+	TestEqual(TEXT("Uncompressed bodies go out as they are"), Stats.CompressedBytes, Stats.UncompressedBytes);
+	TestEqual(TEXT("One request per batch"), Stats.Requests, Stats.BatchDocuments.Count);
+	TestTrue(TEXT("The report names the writer"),
+	    FElasticTelemetryStatCounters::Format(TEXT("Log"), Stats).StartsWith(TEXT("ElasticTelemetry Log writer")));
+
+	// compression shows up as fewer bytes sent than packed
+	Writer->addConfigPair("CompressionLevel", "6");
+	const uint64 Uncompressed = Stats.UncompressedBytes;
+	const uint64 Compressed   = Stats.CompressedBytes;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		Writer->write("{\"log\":{\"message\":\"the same line, over and over\"}}");
+	}
+	if (!TestTrue(TEXT("Every compressed line is sent"), Idle(Count * 2)))
+		return false;
+
+	Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestTrue(TEXT("Fewer bytes are sent than packed"),
+	    Stats.CompressedBytes - Compressed < Stats.UncompressedBytes - Uncompressed);
+	return true;
+}
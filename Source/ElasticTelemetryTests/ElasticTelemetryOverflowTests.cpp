@@ -0,0 +1,266 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "Dom/JsonObject.h"
+#include "ElasticTelemetryJsonTransformer.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetryScriptedTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using FScriptedTransportRef = TSharedRef<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>;
+
+	// Every line is this long, so a budget of 1050 bytes holds exactly ten of them and no watermark falls on a line
+	constexpr int32 LineBytes    = 100;
+	constexpr char  QueueBytes[] = "1050";
+
+	// Lines stay queued: the linger outlasts the test and no flush threshold can be reached. Anything sent anyway
+	// meets a cluster that has stopped answering.
+	Herald::ILogWriterPtr MakeStalledWriter(
+	    const char * Policy, const char * OutboundQueueMaxBytes, const FScriptedTransportRef & Transport)
+	{
+		Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+		                                   ->addConfigPair("IndexName", "uelog")
+		                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+		                                   .addConfigPair("FlushLingerMilliseconds", "600000")
+		                                   .addConfigPair("FlushMaxDocuments", "1000000")
+		                                   .addConfigPair("FlushMaxBytes", "1073741824")
+		                                   .addConfigPair("PriorityLane", "False")
+		                                   .addConfigPair("OverflowPolicy", Policy)
+		                                   .addConfigPair("OutboundQueueMaxBytes", OutboundQueueMaxBytes)
+		                                   .build();
+		Transport->Stall();
+		AsElasticTelemetryWriter(Writer)->SetTransport(Transport);
+		return Writer;
+	}
+
+	std::string MakeLine(const char * Name, const int32 Index)
+	{
+		std::string Line = "{\"log\":{\"message\":\"" + std::string(Name) + " " + std::to_string(Index);
+		Line += "\",\"pad\":\"";
+		Line.append(LineBytes - Line.size() - 3, '.');
+		return Line + "\"}}";
+	}
+
+	void WriteLines(const Herald::ILogWriterPtr & Writer, const Herald::LogLevels Level, const char * Name,
+	    const int32 First, const int32 Count)
+	{
+		FElasticTelemetryLogLevelScope Scope(Level);
+		for (int32 i = First; i < First + Count; ++i)
+		{
+			Writer->write(MakeLine(Name, i));
+		}
+	}
+
+	std::vector<std::string> MakeLines(const char * Name, const int32 First, const int32 Count)
+	{
+		std::vector<std::string> Lines;
+		for (int32 i = First; i < First + Count; ++i)
+		{
+			Lines.push_back(MakeLine(Name, i));
+		}
+		return Lines;
+	}
+
+	bool IsDropReport(const std::string & Document)
+	{
+		return Document.find(" messages dropped\"") != std::string::npos;
+	}
+
+	// The cluster answers again and the writer drains, what reaches the transport is what the queue kept. The
+	// writer's report of the lines it dropped goes to Reports, when given.
+	std::vector<std::string> ReleaseAndDrain(const Herald::ILogWriterPtr & Writer,
+	    const FScriptedTransportRef & Transport, std::vector<std::string> * Reports = nullptr)
+	{
+		Transport->Release();
+		AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 10.0);
+
+		std::vector<std::string> Documents = Transport->GetDocuments();
+		const auto Kept = std::stable_partition(Documents.begin(), Documents.end(), [](const std::string & Document) {
+			return !IsDropReport(Document);
+		});
+		if (Reports)
+			Reports->assign(Kept, Documents.end());
+		Documents.erase(Kept, Documents.end());
+		return Documents;
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryOverflowDropNewestTest, "ElasticTelemetry.Overflow.DropNewest",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryOverflowDropNewestTest::RunTest(const FString & Parameters)
+{
+	const FScriptedTransportRef Transport = MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr       Writer    = MakeStalledWriter("DropNewest", QueueBytes, Transport);
+
+	// ten lines fit, the rest are refused whatever their level
+	WriteLines(Writer, Herald::LogLevels::Info, "info", 0, 15);
+	WriteLines(Writer, Herald::LogLevels::Error, "error", 0, 1);
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Nothing was sent"), Transport->GetRequests(), 0);
+	TestEqual(TEXT("Ten lines are queued"), Stats.QueuedMessages, 10u);
+	TestEqual(TEXT("The newest lines are dropped"), Stats.DroppedNewest, 6ull);
+	TestEqual(TEXT("Nothing old is dropped"), Stats.DroppedOldest, 0ull);
+	TestEqual(TEXT("Nothing is dropped by severity"), Stats.DroppedLowSeverity, 0ull);
+
+	TestTrue(TEXT("The oldest ten lines survive"), ReleaseAndDrain(Writer, Transport) == MakeLines("info", 0, 10));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryOverflowDropOldestTest, "ElasticTelemetry.Overflow.DropOldest",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryOverflowDropOldestTest::RunTest(const FString & Parameters)
+{
+	const FScriptedTransportRef Transport = MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr       Writer    = MakeStalledWriter("DropOldest", QueueBytes, Transport);
+
+	// each line past the tenth pushes out the oldest one
+	WriteLines(Writer, Herald::LogLevels::Info, "info", 0, 15);
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Ten lines are queued"), Stats.QueuedMessages, 10u);
+	TestEqual(TEXT("Queued bytes stay within the budget"), Stats.QueuedBytes, static_cast<uint64>(10 * LineBytes));
+	TestEqual(TEXT("Nothing new is dropped"), Stats.DroppedNewest, 0ull);
+	TestEqual(TEXT("The oldest lines are dropped"), Stats.DroppedOldest, 5ull);
+	TestEqual(TEXT("Nothing is dropped by severity"), Stats.DroppedLowSeverity, 0ull);
+
+	TestTrue(TEXT("The newest ten lines survive"), ReleaseAndDrain(Writer, Transport) == MakeLines("info", 5, 10));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryOverflowDropLowestSeverityTest,
+    "ElasticTelemetry.Overflow.DropLowestSeverity",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryOverflowDropLowestSeverityTest::RunTest(const FString & Parameters)
+{
+	const FScriptedTransportRef Transport = MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr       Writer    = MakeStalledWriter("DropLowestSeverity", QueueBytes, Transport);
+
+	// Each level is admitted up to its watermark of the 1050 byte budget: Trace to 525 bytes, Debug to 735, Info to
+	// 892, Warning to 997. Each stops one line short of it, the lines after are refused.
+	WriteLines(Writer, Herald::LogLevels::Trace, "trace", 0, 7);
+	WriteLines(Writer, Herald::LogLevels::Debug, "debug", 0, 3);
+	WriteLines(Writer, Herald::LogLevels::Info, "info", 0, 2);
+	WriteLines(Writer, Herald::LogLevels::Warning, "warning", 0, 2);
+	TestEqual(TEXT("Lines past their watermark are refused"),
+	    AsElasticTelemetryWriter(Writer)->GetStats().DroppedLowSeverity, 5ull);
+
+	// errors are always admitted, up to the whole budget and then by pushing out the oldest lines
+	WriteLines(Writer, Herald::LogLevels::Error, "error", 0, 3);
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Ten lines are queued"), Stats.QueuedMessages, 10u);
+	TestEqual(TEXT("Nothing new is dropped"), Stats.DroppedNewest, 0ull);
+	TestEqual(TEXT("Nothing is dropped as merely old"), Stats.DroppedOldest, 0ull);
+	TestEqual(TEXT("Refused and pushed out lines count as low severity"), Stats.DroppedLowSeverity, 7ull);
+
+	std::vector<std::string> Expected = MakeLines("trace", 2, 3);
+	for (const std::vector<std::string> & Lines : {MakeLines("debug", 0, 2), MakeLines("info", 0, 1),
+	         MakeLines("warning", 0, 1), MakeLines("error", 0, 3)})
+	{
+		Expected.insert(Expected.end(), Lines.begin(), Lines.end());
+	}
+	TestTrue(TEXT("Every error survives, the oldest trace lines made room"),
+	    ReleaseAndDrain(Writer, Transport) == Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryOverflowSlotsTest, "ElasticTelemetry.Overflow.QueueSlots",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryOverflowSlotsTest::RunTest(const FString & Parameters)
+{
+	// a budget no test line reaches, the ring runs out of its 65536 slots first and the same policies apply
+	constexpr int32 Slots = 64 * 1024;
+	for (const char * Policy : {"DropNewest", "DropOldest", "DropLowestSeverity"})
+	{
+		const FScriptedTransportRef Transport = MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+		Herald::ILogWriterPtr       Writer    = MakeStalledWriter(Policy, "1073741824", Transport);
+		WriteLines(Writer, Herald::LogLevels::Info, "info", 0, Slots + 10);
+		WriteLines(Writer, Herald::LogLevels::Error, "error", 0, 5);
+
+		const FElasticTelemetryWriterStats Stats     = AsElasticTelemetryWriter(Writer)->GetStats();
+		const std::vector<std::string>     Survivors = ReleaseAndDrain(Writer, Transport);
+		TestEqual(TEXT("The ring is full"), Stats.QueuedMessages, static_cast<uint32>(Slots));
+		if (!TestEqual(TEXT("A full ring is sent"), static_cast<uint64>(Survivors.size()), static_cast<uint64>(Slots)))
+			continue;
+
+		if (FCStringAnsi::Strcmp(Policy, "DropNewest") == 0)
+		{
+			TestEqual(TEXT("DropNewest refuses every line past the ring"), Stats.DroppedNewest, 15ull);
+			TestTrue(TEXT("DropNewest keeps the first lines"),
+			    Survivors.front() == MakeLine("info", 0) && Survivors.back() == MakeLine("info", Slots - 1));
+		}
+		else if (FCStringAnsi::Strcmp(Policy, "DropOldest") == 0)
+		{
+			TestEqual(TEXT("DropOldest pushes out a line for each one past the ring"), Stats.DroppedOldest, 15ull);
+			TestTrue(TEXT("DropOldest keeps the last lines"),
+			    Survivors.front() == MakeLine("info", 15) && Survivors.back() == MakeLine("error", 4));
+		}
+		else
+		{
+			// info lines past the ring are refused, errors push out the oldest lines
+			TestEqual(TEXT("DropLowestSeverity refuses the info lines and makes room for errors"),
+			    Stats.DroppedLowSeverity, 15ull);
+			TestTrue(TEXT("DropLowestSeverity keeps every error"),
+			    Survivors.front() == MakeLine("info", 5) && Survivors.back() == MakeLine("error", 4));
+		}
+		TestEqual(TEXT("One policy's counter only"), Stats.GetTotalDropped(), 15ull);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryOverflowDropReportTest, "ElasticTelemetry.Overflow.DropReport",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryOverflowDropReportTest::RunTest(const FString & Parameters)
+{
+	const FScriptedTransportRef Transport = MakeShared<FElasticTelemetryScriptedTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr       Writer    = MakeStalledWriter("DropNewest", QueueBytes, Transport);
+
+	// the report is formatted by the writer's transformer, with its headers
+	const Herald::ILogTransformerPtr Transformer =
+	    createElasticTelemetryJsonTransformerBuilder()->attachLogWriter(Writer).build();
+	Transformer->addHeader("SessionID", "drop-report");
+	AsElasticTelemetryWriter(Writer)->SetJsonTransformer(Transformer);
+
+	// dropped under pressure, nothing is reported while the queue is still full
+	WriteLines(Writer, Herald::LogLevels::Info, "info", 0, 15);
+	TestEqual(TEXT("Nothing was sent"), Transport->GetRequests(), 0);
+
+	// the drain empties the queue, then the report follows the lines that made it
+	std::vector<std::string>       Reports;
+	const std::vector<std::string> Sent = ReleaseAndDrain(Writer, Transport, &Reports);
+	TestTrue(TEXT("The queued lines are sent"), Sent == MakeLines("info", 0, 10));
+	if (!TestEqual(TEXT("One report"), static_cast<int32>(Reports.size()), 1))
+		return false;
+	TestTrue(TEXT("The report comes once the queue has drained"), Transport->GetDocuments().back() == Reports[0]);
+
+	TSharedPtr<FJsonObject>         Document;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(UTF8_TO_TCHAR(Reports[0].c_str()));
+	if (!TestTrue(TEXT("The report is valid JSON"), FJsonSerializer::Deserialize(Reader, Document)))
+		return false;
+
+	const TSharedPtr<FJsonObject> Log = Document->GetObjectField(TEXT("log"));
+	TestEqual(TEXT("A warning"), Log->GetStringField(TEXT("level")), FString(TEXT("Warning")));
+	TestEqual(TEXT("How many were dropped"), Log->GetStringField(TEXT("message")), FString(TEXT("5 messages dropped")));
+	TestEqual(TEXT("By which policy"), Log->GetNumberField(TEXT("DroppedNewest")), 5.0);
+	TestEqual(TEXT("Nothing old"), Log->GetNumberField(TEXT("DroppedOldest")), 0.0);
+	TestEqual(TEXT("Nothing by severity"), Log->GetNumberField(TEXT("DroppedLowSeverity")), 0.0);
+	const TSharedPtr<FJsonObject> Headers = Document->GetObjectField(TEXT("headers"));
+	TestEqual(
+	    TEXT("The transformer's headers"), Headers->GetStringField(TEXT("SessionID")), FString(TEXT("drop-report")));
+	TestTrue(TEXT("A timestamp"), Document->HasTypedField<EJson::String>(TEXT("timestamp")));
+	return true;
+}
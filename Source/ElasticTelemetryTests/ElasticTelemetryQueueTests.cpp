@@ -0,0 +1,120 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/Thread.h"
+#include "ElasticTelemetryMpscQueue.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include <string>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryMpscQueueTest, "ElasticTelemetry.Queue.MpscBasics",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryMpscQueueTest::RunTest(const FString & Parameters)
+{
+	TElasticTelemetryMpscQueue<std::string> Queue(5);
+	TestEqual(TEXT("Capacity rounds up to a power of two"), Queue.Capacity(), 8u);
+	TestTrue(TEXT("New queue is empty"), Queue.IsEmpty());
+
+	uint32 Enqueued = 0;
+	while (Queue.TryEnqueue(std::to_string(Enqueued)))
+	{
+		++Enqueued;
+	}
+	TestEqual(TEXT("Queue accepts exactly Capacity elements"), Enqueued, Queue.Capacity());
+
+	std::string Rejected("rejected");
+	TestFalse(TEXT("Full queue refuses elements"), Queue.TryEnqueue(MoveTemp(Rejected)));
+
+	std::string Item;
+	for (uint32 i = 0; i < Enqueued; ++i)
+	{
+		TestTrue(TEXT("Dequeue succeeds"), Queue.TryDequeue(Item));
+		TestEqual(TEXT("Elements come out in FIFO order"), FString(Item.c_str()), FString::FromInt(i));
+	}
+	TestFalse(TEXT("Drained queue has nothing to dequeue"), Queue.TryDequeue(Item));
+
+	// wraps around the ring
+	TestTrue(TEXT("Queue accepts elements after wrapping"), Queue.TryEnqueue(std::string("again")));
+	TestTrue(TEXT("Wrapped element dequeues"), Queue.TryDequeue(Item) && Item == "again");
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryMpscQueueConcurrencyTest, "ElasticTelemetry.Queue.MpscConcurrency",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryMpscQueueConcurrencyTest::RunTest(const FString & Parameters)
+{
+	// Every producer's elements must arrive exactly once and in the order that producer enqueued them
+	constexpr int32 ProducerCount       = 8;
+	constexpr int32 ElementsPerProducer = 50000;
+
+	TElasticTelemetryMpscQueue<uint64> Queue(1024);
+	TArray<TUniquePtr<FThread>>        Producers;
+	for (int32 Producer = 0; Producer < ProducerCount; ++Producer)
+	{
+		Producers.Add(MakeUnique<FThread>(TEXT("ElasticTelemetryQueueProducer"), [&Queue, Producer]() {
+			for (uint64 i = 0; i < ElementsPerProducer;)
+			{
+				uint64 Element = (static_cast<uint64>(Producer) << 32) | i;
+				if (Queue.TryEnqueue(MoveTemp(Element)))
+					++i;
+			}
+		}));
+	}
+
+	TArray<uint64> NextExpected;
+	NextExpected.SetNumZeroed(ProducerCount);
+	bool  bInOrder = true;
+	int64 Received = 0;
+	while (Received < static_cast<int64>(ProducerCount) * ElementsPerProducer)
+	{
+		uint64 Element;
+		if (!Queue.TryDequeue(Element))
+			continue;
+
+		const int32  Producer = static_cast<int32>(Element >> 32);
+		const uint64 Index    = Element & 0xFFFFFFFF;
+		bInOrder &= (Index == NextExpected[Producer]);
+		NextExpected[Producer] = Index + 1;
+		++Received;
+	}
+
+	for (auto & Producer : Producers)
+	{
+		Producer->Join();
+	}
+
+	TestTrue(TEXT("Each producer's elements arrive in order, exactly once"), bInOrder);
+	TestTrue(TEXT("Queue is empty after draining"), Queue.IsEmpty());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryLogLevelScopeTest, "ElasticTelemetry.Queue.LogLevelScope",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryLogLevelScopeTest::RunTest(const FString & Parameters)
+{
+	const Herald::LogLevels Outside = FElasticTelemetryLogLevelScope::GetCurrent();
+	{
+		const FElasticTelemetryLogLevelScope Outer(Herald::LogLevels::Trace);
+		TestTrue(TEXT("Scope sets the current level"),
+		    FElasticTelemetryLogLevelScope::GetCurrent() == Herald::LogLevels::Trace);
+		{
+			const FElasticTelemetryLogLevelScope Inner(Herald::LogLevels::Error);
+			TestTrue(TEXT("Nested scope overrides the level"),
+			    FElasticTelemetryLogLevelScope::GetCurrent() == Herald::LogLevels::Error);
+
+			// the level is per thread, another thread logging at the same time must not see it
+			Herald::LogLevels OtherThreadLevel = Herald::LogLevels::Error;
+			FThread Other(TEXT("LogLevelScopeTest"),
+			    [&OtherThreadLevel]() { OtherThreadLevel = FElasticTelemetryLogLevelScope::GetCurrent(); });
+			Other.Join();
+			TestTrue(TEXT("Level does not leak to other threads"), OtherThreadLevel != Herald::LogLevels::Error);
+		}
+		TestTrue(TEXT("Nested scope restores the outer level"),
+		    FElasticTelemetryLogLevelScope::GetCurrent() == Herald::LogLevels::Trace);
+	}
+	TestTrue(TEXT("Scope restores the previous level"), FElasticTelemetryLogLevelScope::GetCurrent() == Outside);
+	return true;
+}
@@ -0,0 +1,55 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "ElasticTelemetryCircuitBreaker.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryCircuitBreakerTest, "ElasticTelemetry.Retry.CircuitBreaker",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryCircuitBreakerTest::RunTest(const FString & Parameters)
+{
+	using EState = FElasticTelemetryCircuitBreaker::EState;
+
+	FElasticTelemetryCircuitBreaker Circuit;
+	Circuit.SetBackoff(1.0, 8.0);
+	TestTrue(TEXT("A new circuit is closed"), Circuit.IsClosed());
+
+	const double Now = 1000.0;
+	Circuit.RecordFailure(Now);
+	TestTrue(TEXT("A retryable failure opens the circuit"), Circuit.GetState() == EState::Open);
+	TestTrue(TEXT("The first probe waits between half and all of the initial backoff"),
+	    Circuit.GetProbeTime() >= Now + 0.5 && Circuit.GetProbeTime() <= Now + 1.0);
+
+	// the other requests that were in flight when the server went away
+	Circuit.RecordFailure(Now);
+	Circuit.RecordFailure(Now);
+	TestEqual(TEXT("Failures while open do not compound the backoff"), Circuit.GetConsecutiveFailures(), 1u);
+
+	TestFalse(TEXT("No probe before the backoff elapses"), Circuit.TryBeginProbe(Now));
+	TestTrue(TEXT("Probe once the backoff elapses"), Circuit.TryBeginProbe(Now + 1.0));
+	TestTrue(TEXT("Probing moves the circuit to half open"), Circuit.GetState() == EState::HalfOpen);
+	TestFalse(TEXT("Only one probe at a time"), Circuit.TryBeginProbe(Now + 1.0));
+
+	Circuit.RecordFailure(Now + 1.0);
+	TestEqual(TEXT("A failed probe counts as another failure"), Circuit.GetConsecutiveFailures(), 2u);
+	TestTrue(TEXT("The second backoff is doubled"),
+	    Circuit.GetProbeTime() >= Now + 2.0 && Circuit.GetProbeTime() <= Now + 3.0);
+
+	Circuit.RecordSuccess();
+	TestTrue(TEXT("A successful probe closes the circuit"), Circuit.IsClosed());
+	TestEqual(TEXT("Success resets the backoff"), Circuit.GetConsecutiveFailures(), 0u);
+
+	Circuit.RecordFailure(Now, 30.0);
+	TestTrue(TEXT("Retry-After overrides a shorter backoff"), Circuit.GetProbeTime() >= Now + 30.0);
+
+	for (uint32 Failures = 1; Failures < 64; ++Failures)
+	{
+		const double Backoff = Circuit.GetBackoffSeconds(Failures);
+		if (Backoff < 0.5 || Backoff > 8.0)
+		{
+			AddError(FString::Printf(TEXT("Backoff %f after %u failures is outside [0.5, 8]"), Backoff, Failures));
+		}
+	}
+	return true;
+}
@@ -0,0 +1,169 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ElasticTelemetryTransport.h"
+#include "Misc/ScopeLock.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// A transport for writer tests that answers as it is told to. Keeps the documents of uncompressed _bulk bodies in
+/// the order they arrive.
+///
+/// Requests are answered with a 200 and one _bulk item per document, whose status SetItemStatus() decides, 201 by
+/// default. While stalled, requests are kept unanswered, as if the cluster had stopped responding, and Release()
+/// answers them, or the next Pump() after ReleaseOnPump().
+/// </summary>
+class FElasticTelemetryScriptedTransport : public IElasticTelemetryTransport
+{
+  public:
+	virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) override
+	{
+		FHeld Answer{MoveTemp(Request.Body), MoveTemp(OnComplete), std::string()};
+		{
+			FScopeLock Lock(&Mutex);
+			const std::string_view Body(reinterpret_cast<const char *>(Answer.Body.GetData()), Answer.Body.Num());
+
+			// an action line, then the document
+			bool        bAction = true;
+			bool        bErrors = false;
+			std::string Items;
+			for (size_t LineStart = 0; LineStart < Body.size();)
+			{
+				const size_t LineEnd = FMath::Min(Body.find('\n', LineStart), Body.size());
+				if (!bAction)
+				{
+					const std::string_view Document = Body.substr(LineStart, LineEnd - LineStart);
+					const int32            Status   = ItemStatus ? ItemStatus(Document) : 201;
+					Items += (Items.empty() ? "{\"index\":{\"status\":" : ",{\"index\":{\"status\":") +
+					         std::to_string(Status) + GetItemError(Status) + "}}";
+					bErrors |= Status < 200 || Status > 299;
+					Documents.emplace_back(Document);
+				}
+				bAction   = !bAction;
+				LineStart = LineEnd + 1;
+			}
+			Answer.Content = std::string("{\"took\":0,\"errors\":") + (bErrors ? "true" : "false") +
+			                 ",\"items\":[" + Items + "]}";
+			++Requests;
+
+			if (bStalled)
+			{
+				Held.Add(MoveTemp(Answer));
+				return;
+			}
+		}
+		Complete(Answer);
+	}
+
+	/// <summary>
+	/// Decides the _bulk item status of each document from now on. Called under the transport's lock.
+	/// </summary>
+	void SetItemStatus(TFunction<int32(const std::string_view & Document)> InItemStatus)
+	{
+		FScopeLock Lock(&Mutex);
+		ItemStatus = MoveTemp(InItemStatus);
+	}
+
+	void Stall()
+	{
+		FScopeLock Lock(&Mutex);
+		bStalled = true;
+	}
+
+	/// <summary>
+	/// Releases the stall from the next Pump(), which is how Drain() waits for completions, so requests held before
+	/// a drain complete during it.
+	/// </summary>
+	void ReleaseOnPump()
+	{
+		FScopeLock Lock(&Mutex);
+		bReleaseOnPump = true;
+	}
+
+	virtual void Pump() override
+	{
+		bool bRelease = false;
+		{
+			FScopeLock Lock(&Mutex);
+			bRelease = bReleaseOnPump && bStalled;
+		}
+		if (bRelease)
+			Release();
+	}
+
+	/// <summary>
+	/// Answers the requests held so far, and every later one as it arrives.
+	/// </summary>
+	void Release()
+	{
+		TArray<FHeld> Released;
+		{
+			FScopeLock Lock(&Mutex);
+			bStalled = false;
+			Released = MoveTemp(Held);
+		}
+		for (const FHeld & Answer : Released)
+		{
+			Complete(Answer);
+		}
+	}
+
+	std::vector<std::string> GetDocuments() const
+	{
+		FScopeLock Lock(&Mutex);
+		return Documents;
+	}
+
+	int32 GetRequests() const
+	{
+		FScopeLock Lock(&Mutex);
+		return Requests;
+	}
+
+	int32 GetHeldRequests() const
+	{
+		FScopeLock Lock(&Mutex);
+		return Held.Num();
+	}
+
+  private:
+	struct FHeld
+	{
+		TArray<uint8> Body;
+		FOnComplete   OnComplete;
+		std::string   Content;
+	};
+
+	static std::string GetItemError(const int32 Status)
+	{
+		if (Status == 429)
+			return ",\"error\":{\"type\":\"es_rejected_execution_exception\"}";
+		if (Status < 200 || Status > 299)
+			return ",\"error\":{\"type\":\"mapper_parsing_exception\"}";
+		return std::string();
+	}
+
+	static void Complete(const FHeld & Answer)
+	{
+		const uint8 * const                Content = reinterpret_cast<const uint8 *>(Answer.Content.data());
+		FElasticTelemetryTransportResponse Response;
+		Response.bWasSuccessful = true;
+		Response.Code           = 200;
+		Response.Content        = MakeArrayView(Content, static_cast<int32>(Answer.Content.size()));
+		Response.RequestBody    = Answer.Body;
+		Answer.OnComplete(Response);
+	}
+
+	mutable FCriticalSection                            Mutex;
+	std::vector<std::string>                            Documents; // under Mutex, and the rest
+	TFunction<int32(const std::string_view & Document)> ItemStatus;
+	TArray<FHeld>                                       Held;
+	int32                                               Requests = 0;
+	bool                                                bStalled       = false;
+	bool                                                bReleaseOnPump = false;
+};
@@ -18,6 +18,7 @@ bool FElasticTelemetrySettingsTest::RunTest(const FString& Parameters)
 	TestEqual(TEXT("Default Username should be 'DefaultUser'"), Settings.Username, TEXT("DefaultUser"));
 	TestEqual(TEXT("Default Password should be 'ChangeMe'"), Settings.Password, TEXT("ChangeMe"));
 	TestEqual(TEXT("Default IndexName should be 'UELog'"), Settings.IndexName, TEXT("UELog"));
+	TestFalse(TEXT("Indices should not be data streams by default"), Settings.UseDataStream);
 	TestFalse(TEXT("Elastic Telemetry should be disabled by default"), Settings.Enabled);
 	TestTrue(TEXT("LogLevel Fatal should be enabled by default"), Settings.IsLogLevelEnabled(ELogVerbosity::Fatal));
 	TestTrue(TEXT("LogLevel Error should be enabled by default"), Settings.IsLogLevelEnabled(ELogVerbosity::Error));
@@ -27,6 +28,33 @@ bool FElasticTelemetrySettingsTest::RunTest(const FString& Parameters)
 	TestFalse(TEXT("LogLevel Verbose should be disabled by default"), Settings.IsLogLevelEnabled(ELogVerbosity::Verbose));
 	TestFalse(TEXT("LogLevel VeryVerbose should be disabled by defaults"), Settings.IsLogLevelEnabled(ELogVerbosity::VeryVerbose));
 	TestFalse(TEXT("Invalid LogLevel should be disabled by default"), Settings.IsLogLevelEnabled(static_cast<ELogVerbosity::Type>(-1)));
+	TestTrue(TEXT("Bulk API should be enabled by default"), Settings.UseBulkAPI);
+	TestEqual(TEXT("Default BulkMaxDocuments should be 500"), Settings.BulkMaxDocuments, 500);
+	TestEqual(TEXT("Default BulkMaxBytes should be 5MB"), Settings.BulkMaxBytes, 5 * 1024 * 1024);
+	TestEqual(TEXT("Default FlushMaxDocuments should be 500"), Settings.FlushMaxDocuments, 500);
+	TestEqual(TEXT("Default FlushMaxBytes should be 1MB"), Settings.FlushMaxBytes, 1024 * 1024);
+	TestEqual(TEXT("Default FlushLingerMilliseconds should be 100"), Settings.FlushLingerMilliseconds, 100);
+	TestEqual(TEXT("Compression should be disabled by default"), Settings.CompressionLevel, 0);
+	TestEqual(TEXT("A single writer thread by default"), Settings.WriterShards, 1);
+	TestTrue(TEXT("Errors should skip the batches by default"), Settings.PriorityLane);
+	TestEqual(TEXT("Outbound queue should hold 32MB by default"), Settings.OutboundQueueMaxBytes, 32 * 1024 * 1024);
+	TestTrue(TEXT("Overflow should shed low severity lines first by default"),
+	    Settings.OverflowPolicy == EElasticTelemetryOverflowPolicy::DropLowestSeverity);
+	TestTrue(TEXT("Spooling should be enabled by default"), Settings.EnableSpool);
+	TestEqual(TEXT("Spool should hold 256MB by default"), Settings.SpoolMaxBytes, 256 * 1024 * 1024);
+	TestEqual(TEXT("Shutdown should wait up to 5 seconds"), Settings.ShutdownDrainMilliseconds, 5000);
+	TestEqual(TEXT("A crash should keep the last 100 queued lines"), Settings.CrashFlushLines, 100);
+	TestFalse(TEXT("Stat counters should be opt-in"), Settings.PublishStatCounters);
+	TestFalse(TEXT("Timestamps should follow the wall clock by default"), Settings.MonotonicTimeStamps);
+	TestEqual(TEXT("Four requests should be in flight at first"), Settings.MaximumPendingRequests, 4);
+	TestTrue(TEXT("Concurrency should adapt by default"), Settings.AdaptiveConcurrency);
+	TestEqual(TEXT("Adaptive concurrency floor"), Settings.AdaptiveConcurrencyFloor, 1);
+	TestEqual(TEXT("Adaptive concurrency ceiling"), Settings.AdaptiveConcurrencyCeiling, 32);
+	TestEqual(TEXT("Retries should start after a second"), Settings.RetryInitialBackoffMilliseconds, 1000);
+	TestEqual(TEXT("Retries should back off to a minute"), Settings.RetryMaxBackoffMilliseconds, 60 * 1000);
+	TestEqual(TEXT("No additional endpoints by default"), Settings.AdditionalEndpointURLs.Num(), 0);
+	TestFalse(TEXT("Node discovery should be opt-in"), Settings.DiscoverEndpoints);
+	TestEqual(TEXT("Endpoint list is just the endpoint"), Settings.GetEndpointList(), Settings.EndpointURL);
 	return true;
 }
 
@@ -0,0 +1,159 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "ElasticTelemetrySpool.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	FString MakeSpoolTestDirectory(const TCHAR * Name)
+	{
+		const FString Directory = FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / Name;
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		return Directory;
+	}
+
+	TArray<uint8> MakePayload(const int32 Index, const int32 Size)
+	{
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(Size);
+		for (int32 i = 0; i < Size; ++i)
+		{
+			Payload[i] = static_cast<uint8>(Index + i);
+		}
+		return Payload;
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetrySpoolReplayTest, "ElasticTelemetry.Spool.AppendAndReplay",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetrySpoolReplayTest::RunTest(const FString & Parameters)
+{
+	const FString Directory = MakeSpoolTestDirectory(TEXT("Replay"));
+	{
+		FElasticTelemetrySpool Spool;
+		TestTrue(TEXT("Spool opens"), Spool.Open(Directory, 1024 * 1024, 1024));
+		TestTrue(TEXT("New spool is empty"), Spool.IsEmpty());
+
+		for (int32 i = 0; i < 10; ++i)
+		{
+			const TArray<uint8> Payload = MakePayload(i, 300);
+			TestTrue(TEXT("Append succeeds"),
+			    Spool.Append(FElasticTelemetrySpool::Bulk, Payload.GetData(), Payload.Num(), i + 1));
+		}
+		TestTrue(TEXT("Small segments roll over"), Spool.GetSegmentCount() > 1);
+		TestFalse(TEXT("Spool has records"), Spool.IsEmpty());
+	}
+
+	// records survive a restart, the way they do across launches
+	FElasticTelemetrySpool Spool;
+	TestTrue(TEXT("Spool reopens"), Spool.Open(Directory, 1024 * 1024, 1024));
+
+	FElasticTelemetrySpool::FRecord Record;
+	int32                           Replayed = 0;
+	while (Spool.ReadNext(Record))
+	{
+		TestEqual(TEXT("Flags survive"), Record.Flags, static_cast<uint32>(FElasticTelemetrySpool::Bulk));
+		TestEqual(TEXT("Document counts survive"), Record.Documents, static_cast<uint32>(Replayed + 1));
+		TestTrue(TEXT("Records replay oldest first, intact"), Record.Payload == MakePayload(Replayed, 300));
+		++Replayed;
+	}
+	TestEqual(TEXT("Every record is replayed"), Replayed, 10);
+	TestTrue(TEXT("Replayed spool is empty"), Spool.IsEmpty());
+	TestEqual(TEXT("Replayed segments are deleted"), Spool.GetTotalBytes(), 0ll);
+
+	Spool.Close();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetrySpoolBoundTest, "ElasticTelemetry.Spool.EvictsOldestFirst",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetrySpoolBoundTest::RunTest(const FString & Parameters)
+{
+	const FString Directory = MakeSpoolTestDirectory(TEXT("Bound"));
+
+	FElasticTelemetrySpool Spool;
+	Spool.Open(Directory, 8 * 1024, 1024);
+	for (int32 i = 0; i < 100; ++i)
+	{
+		const TArray<uint8> Payload = MakePayload(i, 500);
+		Spool.Append(FElasticTelemetrySpool::None, Payload.GetData(), Payload.Num());
+	}
+	TestTrue(TEXT("Spool stays within MaxBytes"), Spool.GetTotalBytes() <= 8 * 1024);
+	TestTrue(TEXT("Evicted bytes are counted"), Spool.GetEvictedBytes() > 0);
+
+	FElasticTelemetrySpool::FRecord Record;
+	TestTrue(TEXT("Something is left to replay"), Spool.ReadNext(Record));
+	TestTrue(TEXT("The oldest records were the ones evicted"), Record.Payload != MakePayload(0, 500));
+
+	while (Spool.ReadNext(Record))
+	{
+	}
+	TestTrue(TEXT("The newest record survives"), Record.Payload == MakePayload(99, 500));
+
+	const TArray<uint8> Oversized = MakePayload(0, 16 * 1024);
+	TestFalse(TEXT("A record larger than the whole spool is refused"),
+	    Spool.Append(FElasticTelemetrySpool::None, Oversized.GetData(), Oversized.Num()));
+
+	Spool.Close();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetrySpoolTornTest, "ElasticTelemetry.Spool.RecoversFromTornSegment",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetrySpoolTornTest::RunTest(const FString & Parameters)
+{
+	const FString Directory = MakeSpoolTestDirectory(TEXT("Torn"));
+	{
+		FElasticTelemetrySpool Spool;
+		Spool.Open(Directory, 1024 * 1024);
+		for (int32 i = 0; i < 3; ++i)
+		{
+			const TArray<uint8> Payload = MakePayload(i, 100);
+			Spool.Append(FElasticTelemetrySpool::None, Payload.GetData(), Payload.Num());
+		}
+	}
+
+	// simulate a crash halfway through writing a fourth record
+	TArray<FString> Segments;
+	IFileManager::Get().FindFiles(Segments, *(Directory / TEXT("*.spool")), true, false);
+	TestEqual(TEXT("One segment was written"), Segments.Num(), 1);
+	if (Segments.Num() != 1)
+		return false;
+
+	IFileHandle * Handle =
+	    FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*(Directory / Segments[0]), true, false);
+	const uint8 TornHeader[] = {'S', 'P', 'O', 'L', 0, 0, 0};
+	Handle->Write(TornHeader, sizeof(TornHeader));
+	delete Handle;
+
+	FElasticTelemetrySpool Spool;
+	TestTrue(TEXT("Spool with a torn segment opens"), Spool.Open(Directory, 1024 * 1024));
+
+	FElasticTelemetrySpool::FRecord Record;
+	int32                           Replayed = 0;
+	while (Spool.ReadNext(Record))
+	{
+		TestTrue(TEXT("Intact records replay"), Record.Payload == MakePayload(Replayed, 100));
+		++Replayed;
+	}
+	TestEqual(TEXT("Every complete record is recovered"), Replayed, 3);
+	TestEqual(TEXT("The torn tail is discarded and counted"), Spool.GetDiscardedBytes(),
+	    static_cast<uint64>(sizeof(TornHeader)));
+
+	const TArray<uint8> Payload = MakePayload(7, 100);
+	TestTrue(TEXT("Spool keeps working after recovery"),
+	    Spool.Append(FElasticTelemetrySpool::None, Payload.GetData(), Payload.Num()));
+
+	Spool.Close();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
@@ -0,0 +1,332 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryCompression.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "Misc/ScopeLock.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+
+namespace
+{
+	bool HasHeader(const std::string_view & Line, const char * Name, const size_t NameLength)
+	{
+		return Line.size() > NameLength && Line[NameLength] == ':' &&
+		       FCStringAnsi::Strnicmp(Line.data(), Name, NameLength) == 0;
+	}
+
+	std::string_view HeaderValue(const std::string_view & Line, const size_t NameLength)
+	{
+		std::string_view Value = Line.substr(NameLength + 1);
+		while (!Value.empty() && Value.front() == ' ')
+			Value.remove_prefix(1);
+		return Value;
+	}
+
+	const char * ReasonPhrase(const int32 Code)
+	{
+		switch (Code)
+		{
+		case 100:
+			return "Continue";
+		case 200:
+			return "OK";
+		case 201:
+			return "Created";
+		case 404:
+			return "Not Found";
+		case 429:
+			return "Too Many Requests";
+		case 503:
+			return "Service Unavailable";
+		default:
+			return "Status";
+		}
+	}
+} // namespace
+
+FElasticTelemetryStandInServer::FElasticTelemetryStandInServer()
+    : Listener(nullptr)
+    , Port(0)
+    , Thread()
+    , bStopping(false)
+    , FailureCode(0)
+    , Requests(0)
+    , BulkRequests(0)
+    , DocumentCount(0)
+    , DocumentsMutex()
+    , Documents()
+{
+}
+
+FElasticTelemetryStandInServer::~FElasticTelemetryStandInServer()
+{
+	Stop();
+}
+
+bool FElasticTelemetryStandInServer::Start()
+{
+	ISocketSubsystem *        Sockets = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> Address = Sockets->CreateInternetAddr();
+	Address->SetLoopbackAddress();
+	Address->SetPort(0);
+
+	Listener = Sockets->CreateSocket(NAME_Stream, TEXT("ElasticTelemetryStandIn"), Address->GetProtocolType());
+	if (!Listener || !Listener->SetNonBlocking(true) || !Listener->Bind(*Address) || !Listener->Listen(16))
+	{
+		Stop();
+		return false;
+	}
+	Port = Listener->GetPortNo();
+
+	bStopping = false;
+	Thread    = MakeUnique<FThread>(TEXT("ElasticTelemetryStandInServer"), [this]() { Serve(); });
+	return true;
+}
+
+void FElasticTelemetryStandInServer::Stop()
+{
+	bStopping = true;
+	if (Thread)
+	{
+		Thread->Join();
+		Thread.Reset();
+	}
+	if (Listener)
+	{
+		Listener->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener);
+		Listener = nullptr;
+	}
+}
+
+FString FElasticTelemetryStandInServer::GetURL() const
+{
+	return FString::Printf(TEXT("http://127.0.0.1:%d/"), Port);
+}
+
+std::vector<std::string> FElasticTelemetryStandInServer::GetDocuments() const
+{
+	FScopeLock Lock(&DocumentsMutex);
+	return Documents;
+}
+
+bool FElasticTelemetryStandInServer::PumpHttpUntil(TFunctionRef<bool()> Done, const double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (!Done())
+	{
+		if (FPlatformTime::Seconds() > Deadline)
+			return false;
+		FHttpModule::Get().GetHttpManager().Tick(0.0f);
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+void FElasticTelemetryStandInServer::Serve()
+{
+	ISocketSubsystem *  Sockets = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TArray<FConnection> Connections;
+	uint8               Chunk[16 * 1024];
+
+	while (!bStopping)
+	{
+		bool bPending = false;
+		while (Listener->HasPendingConnection(bPending) && bPending)
+		{
+			FSocket * Accepted = Listener->Accept(TEXT("ElasticTelemetryStandInConnection"));
+			if (!Accepted)
+				break;
+			Accepted->SetNonBlocking(true);
+			Connections.Add({Accepted});
+		}
+
+		bool bIdle = true;
+		for (int32 i = Connections.Num() - 1; i >= 0; --i)
+		{
+			FConnection & Connection = Connections[i];
+			bool          bOpen      = true;
+			int32         Read       = 0;
+			while ((bOpen = Connection.Socket->Recv(Chunk, sizeof(Chunk), Read)) && Read > 0)
+			{
+				Connection.Buffer.Append(Chunk, Read);
+				bIdle = false;
+			}
+
+			if (!bOpen || !HandleRequests(Connection))
+			{
+				Connection.Socket->Close();
+				Sockets->DestroySocket(Connection.Socket);
+				Connections.RemoveAtSwap(i);
+			}
+		}
+
+		if (bIdle)
+			FPlatformProcess::Sleep(0.001f);
+	}
+
+	for (FConnection & Connection : Connections)
+	{
+		Connection.Socket->Close();
+		Sockets->DestroySocket(Connection.Socket);
+	}
+}
+
+bool FElasticTelemetryStandInServer::HandleRequests(FConnection & Connection)
+{
+	static constexpr char ContentLength[]   = "content-length";
+	static constexpr char ContentEncoding[] = "content-encoding";
+	static constexpr char Expect[]          = "expect";
+	static constexpr char ConnectionName[]  = "connection";
+
+	for (;;)
+	{
+		const char *           Data = reinterpret_cast<const char *>(Connection.Buffer.GetData());
+		const std::string_view Buffered(Data, Connection.Buffer.Num());
+		const size_t           HeaderEnd = Buffered.find("\r\n\r\n");
+		if (HeaderEnd == std::string_view::npos)
+			return true;
+
+		// request line, then one header per line
+		const std::string_view Head        = Buffered.substr(0, HeaderEnd);
+		const size_t           RequestLine = FMath::Min(Head.find("\r\n"), Head.size());
+		const std::string_view Request     = Head.substr(0, RequestLine);
+		const size_t           MethodEnd   = Request.find(' ');
+		const size_t           TargetEnd   = Request.find(' ', MethodEnd + 1);
+		if (MethodEnd == std::string_view::npos || TargetEnd == std::string_view::npos)
+			return false;
+
+		size_t Length          = 0;
+		bool   bGzip           = false;
+		bool   bExpectContinue = false;
+		bool   bClose          = false;
+		for (size_t LineStart = RequestLine + 2; LineStart < Head.size();)
+		{
+			const size_t           LineEnd = FMath::Min(Head.find("\r\n", LineStart), Head.size());
+			const std::string_view Line    = Head.substr(LineStart, LineEnd - LineStart);
+			if (HasHeader(Line, ContentLength, sizeof(ContentLength) - 1))
+				Length = FCStringAnsi::Atoi64(std::string(HeaderValue(Line, sizeof(ContentLength) - 1)).c_str());
+			else if (HasHeader(Line, ContentEncoding, sizeof(ContentEncoding) - 1))
+				bGzip = HeaderValue(Line, sizeof(ContentEncoding) - 1) == "gzip";
+			else if (HasHeader(Line, Expect, sizeof(Expect) - 1))
+				bExpectContinue = true;
+			else if (HasHeader(Line, ConnectionName, sizeof(ConnectionName) - 1))
+				bClose = HeaderValue(Line, sizeof(ConnectionName) - 1) == "close";
+			LineStart = LineEnd + 2;
+		}
+
+		const size_t BodyStart = HeaderEnd + 4;
+		if (Buffered.size() < BodyStart + Length)
+		{
+			// libcurl waits a little for the go-ahead before sending a large body
+			if (bExpectContinue && !Connection.bContinueSent)
+			{
+				Connection.bContinueSent = true;
+				return SendAll(Connection.Socket, "HTTP/1.1 100 Continue\r\n\r\n");
+			}
+			return true;
+		}
+
+		TArray<uint8> Body(Connection.Buffer.GetData() + BodyStart, static_cast<int32>(Length));
+		if (bGzip)
+		{
+			TArray<uint8> Decompressed;
+			FElasticTelemetryGzip::Decompress(Body.GetData(), Body.Num(), Decompressed);
+			Body = MoveTemp(Decompressed);
+		}
+
+		int32                  Code     = 0;
+		const std::string_view Method   = Request.substr(0, MethodEnd);
+		const std::string_view Target   = Request.substr(MethodEnd + 1, TargetEnd - MethodEnd - 1);
+		const std::string      Content  = Answer(Method, Target, MoveTemp(Body), Code);
+		const std::string      Response = "HTTP/1.1 " + std::to_string(Code) + " " + ReasonPhrase(Code) +
+		                                  "\r\nContent-Type: application/json\r\nContent-Length: " +
+		                                  std::to_string(Content.size()) + "\r\n\r\n" + Content;
+
+		Connection.Buffer.RemoveAt(0, static_cast<int32>(BodyStart + Length));
+		Connection.bContinueSent = false;
+		if (!SendAll(Connection.Socket, Response) || bClose)
+			return false;
+	}
+}
+
+std::string FElasticTelemetryStandInServer::Answer(
+    const std::string_view & Method, const std::string_view & Target, TArray<uint8> && Body, int32 & OutCode)
+{
+	Requests.fetch_add(1);
+
+	const int32 Failure = FailureCode;
+	if (Failure != 0)
+	{
+		OutCode = Failure;
+		return "{\"error\":\"stand-in failure\",\"status\":" + std::to_string(Failure) + "}";
+	}
+
+	const std::string_view Path = Target.substr(0, Target.find('?'));
+	const std::string_view Text(reinterpret_cast<const char *>(Body.GetData()), Body.Num());
+	auto                   EndsWith = [&Path](const std::string_view & Suffix) {
+		return Path.size() >= Suffix.size() && Path.substr(Path.size() - Suffix.size()) == Suffix;
+	};
+
+	if (Method == "GET" && Path == "/_nodes/http")
+	{
+		OutCode = 200;
+		return "{\"nodes\":{\"standin\":{\"http\":{\"publish_address\":\"127.0.0.1:" + std::to_string(Port) +
+		       "\"}}}}";
+	}
+
+	if (Method == "POST" && EndsWith("/_doc"))
+	{
+		FScopeLock Lock(&DocumentsMutex);
+		Documents.emplace_back(Text);
+		DocumentCount.fetch_add(1);
+		OutCode = 201;
+		return "{\"result\":\"created\"}";
+	}
+
+	if (Method == "POST" && EndsWith("/_bulk"))
+	{
+		BulkRequests.fetch_add(1);
+
+		// an action line, then the document
+		std::string Items;
+		size_t      LineStart = 0;
+		bool        bAction   = true;
+		FScopeLock  Lock(&DocumentsMutex);
+		while (LineStart < Text.size())
+		{
+			const size_t LineEnd = FMath::Min(Text.find('\n', LineStart), Text.size());
+			if (!bAction)
+			{
+				Documents.emplace_back(Text.substr(LineStart, LineEnd - LineStart));
+				DocumentCount.fetch_add(1);
+				Items += Items.empty() ? "{\"index\":{\"status\":201}}" : ",{\"index\":{\"status\":201}}";
+			}
+			bAction   = !bAction;
+			LineStart = LineEnd + 1;
+		}
+		OutCode = 200;
+		return "{\"took\":1,\"errors\":false,\"items\":[" + Items + "]}";
+	}
+
+	OutCode = 404;
+	return "{\"error\":\"no handler\",\"status\":404}";
+}
+
+bool FElasticTelemetryStandInServer::SendAll(FSocket * Socket, const std::string & Data)
+{
+	const uint8 * Bytes = reinterpret_cast<const uint8 *>(Data.data());
+	const int32   Size  = static_cast<int32>(Data.size());
+	int32         Sent  = 0;
+	while (Sent < Size)
+	{
+		int32 Written = 0;
+		if (!Socket->Send(Bytes + Sent, Size - Sent, Written))
+			return false;
+		Sent += Written;
+	}
+	return true;
+}
@@ -0,0 +1,92 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Thread.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FSocket;
+
+/// <summary>
+/// Just enough of an ElasticSearch node for automation tests and benchmarks to run a writer over real HTTP without
+/// a cluster.
+///
+/// Listens on an ephemeral port on the loopback interface and speaks HTTP/1.1 with keep-alive. It accepts
+/// POST <index>/_doc and POST <index>/_bulk, gzip encoded or not, and answers GET _nodes/http with its own address.
+/// Every document it indexes is kept so tests can check what arrived. SetFailureCode() makes it answer everything
+/// with an error instead, and Stop() makes it refuse connections, to stand in for a node that is in trouble.
+///
+/// Requests are served one at a time by a single thread, which is plenty on loopback.
+/// </summary>
+class FElasticTelemetryStandInServer
+{
+  public:
+	FElasticTelemetryStandInServer();
+	~FElasticTelemetryStandInServer();
+
+	FElasticTelemetryStandInServer(const FElasticTelemetryStandInServer &)             = delete;
+	FElasticTelemetryStandInServer & operator=(const FElasticTelemetryStandInServer &) = delete;
+
+	/// <returns>false if no port could be bound.</returns>
+	bool Start();
+	void Stop();
+
+	/// <summary>
+	/// http://127.0.0.1:port/, ready to be used as an EndpointURL.
+	/// </summary>
+	FString GetURL() const;
+
+	/// <summary>
+	/// Answer every request with Code, 0 to behave again.
+	/// </summary>
+	inline void SetFailureCode(const int32 Code) { FailureCode = Code; }
+
+	inline uint64 GetRequests() const { return Requests.load(); }
+	inline uint64 GetBulkRequests() const { return BulkRequests.load(); }
+	inline uint64 GetDocumentCount() const { return DocumentCount.load(); }
+	std::vector<std::string> GetDocuments() const;
+
+	/// <summary>
+	/// Ticks the HTTP module until Done returns true. Completions are delivered on the game thread, which is blocked
+	/// running the test.
+	/// </summary>
+	/// <returns>false on timeout.</returns>
+	static bool PumpHttpUntil(TFunctionRef<bool()> Done, double TimeoutSeconds = 10.0);
+
+  private:
+	struct FConnection
+	{
+		FSocket *     Socket = nullptr;
+		TArray<uint8> Buffer;
+		bool          bContinueSent = false;
+	};
+
+	void Serve();
+
+	/// <summary>
+	/// Answers every complete request in the connection's buffer.
+	/// </summary>
+	/// <returns>false once the connection should be closed.</returns>
+	bool HandleRequests(FConnection & Connection);
+
+	std::string Answer(const std::string_view & Method, const std::string_view & Target, TArray<uint8> && Body,
+	    int32 & OutCode);
+
+	static bool SendAll(FSocket * Socket, const std::string & Data);
+
+	FSocket *                Listener;
+	int32                    Port;
+	TUniquePtr<FThread>      Thread;
+	std::atomic<bool>        bStopping;
+	std::atomic<int32>       FailureCode;
+	std::atomic<uint64>      Requests;
+	std::atomic<uint64>      BulkRequests;
+	std::atomic<uint64>      DocumentCount;
+	mutable FCriticalSection DocumentsMutex;
+	std::vector<std::string> Documents; // under DocumentsMutex
+};
@@ -44,6 +44,8 @@ public class ElasticTelemetryTests : ModuleRules
 				"Engine",
 				"Json",
 				"Herald",
+				"HTTP",
+				"Sockets",
 				"AutomationController",
 				"AutomationTest",
 				"ElasticTelemetry",
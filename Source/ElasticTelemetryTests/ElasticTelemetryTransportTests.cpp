@@ -0,0 +1,503 @@
+// Copyright 2016-2024 Playscale Ptd Ltd and Justin Randall
+// MIT License, see LICENSE file for full details.
+
+#include "Misc/AutomationTest.h"
+#include "Algo/Count.h"
+#include "ElasticTelemetryLogLevelScope.h"
+#include "ElasticTelemetrySpool.h"
+#include "ElasticTelemetryStandInServer.h"
+#include "ElasticTelemetryTransport.h"
+#include "ElasticTelemetryWriter.h"
+#include "HAL/FileManager.h"
+#include "HAL/Thread.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	Herald::ILogWriterPtr MakeWriter(const FString & EndpointURL, const bool bUseBulkAPI)
+	{
+		return createElasticTelemetryWriterBuilder()
+		    ->addConfigPair("IndexName", "uelog")
+		    .addConfigPair("EndpointURL", TCHAR_TO_UTF8(*EndpointURL))
+		    .addConfigPair("UseBulkAPI", bUseBulkAPI ? "true" : "false")
+		    .addConfigPair("FlushLingerMilliseconds", "5")
+		    .build();
+	}
+
+	std::string MakeDocument(const uint32 Index)
+	{
+		return "{\"log\":{\"message\":\"line " + std::to_string(Index) + "\"}}";
+	}
+
+	// The writer's completions reference it, so nothing may be in flight when it goes away
+	bool WaitUntilIdle(const Herald::ILogWriterPtr & Writer)
+	{
+		return FElasticTelemetryStandInServer::PumpHttpUntil([&Writer]() {
+			const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+			return Stats.QueuedMessages == 0 && Stats.InFlightRequests == 0;
+		});
+	}
+
+	// Keeps the documents of uncompressed _bulk requests in the order the writer sent them
+	class FRecordingTransport : public IElasticTelemetryTransport
+	{
+	  public:
+		virtual void Send(FElasticTelemetryTransportRequest && Request, FOnComplete && OnComplete) override
+		{
+			const std::string_view Body(reinterpret_cast<const char *>(Request.Body.GetData()), Request.Body.Num());
+			{
+				// an action line, then the document
+				FScopeLock Lock(&Mutex);
+				bool       bAction = true;
+				for (size_t LineStart = 0; LineStart < Body.size();)
+				{
+					const size_t LineEnd = FMath::Min(Body.find('\n', LineStart), Body.size());
+					if (!bAction)
+						Documents.emplace_back(Body.substr(LineStart, LineEnd - LineStart));
+					bAction   = !bAction;
+					LineStart = LineEnd + 1;
+				}
+			}
+
+			static constexpr std::string_view Content     = "{\"took\":0,\"errors\":false,\"items\":[]}";
+			const uint8 *                     ContentData = reinterpret_cast<const uint8 *>(Content.data());
+
+			FElasticTelemetryTransportResponse Response;
+			Response.bWasSuccessful = true;
+			Response.Code           = 200;
+			Response.Content        = MakeArrayView(ContentData, static_cast<int32>(Content.size()));
+			Response.RequestBody    = Request.Body;
+			OnComplete(Response);
+		}
+
+		std::vector<std::string> GetDocuments() const
+		{
+			FScopeLock Lock(&Mutex);
+			return Documents;
+		}
+
+	  private:
+		mutable FCriticalSection Mutex;
+		std::vector<std::string> Documents; // under Mutex
+	};
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryNullTransportTest, "ElasticTelemetry.Transport.NullSink",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryNullTransportTest::RunTest(const FString & Parameters)
+{
+	const TSharedRef<FElasticTelemetryNullTransport, ESPMode::ThreadSafe> Sink =
+	    MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>();
+
+	Herald::ILogWriterPtr Writer = MakeWriter(TEXT("http://unused.invalid:9200"), true);
+	AsElasticTelemetryWriter(Writer)->SetTransport(Sink);
+
+	const uint32 Count = 1000;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		Writer->write(MakeDocument(i));
+	}
+	TestTrue(TEXT("Every document reaches the transport"),
+	    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Sink->GetDocuments() == Count; }));
+	TestTrue(TEXT("Documents are batched into _bulk requests"), Sink->GetRequests() < Count);
+	TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Nothing is held for retry"), Stats.RetryableFailures, 0ull);
+	TestFalse(TEXT("The circuit stays closed"), Stats.bCircuitOpen);
+
+	// the config pair selects the same sink for running without a cluster
+	Herald::ILogWriterPtr Configured =
+	    createElasticTelemetryWriterBuilder()->addConfigPair("Transport", "Null").build();
+	Configured->write(MakeDocument(0));
+	TestTrue(TEXT("A Null transport writer sends without a cluster"), WaitUntilIdle(Configured));
+	TestEqual(TEXT("Nothing failed"), AsElasticTelemetryWriter(Configured)->GetStats().RetryableFailures, 0ull);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryFlushPolicyTest, "ElasticTelemetry.Transport.FlushPolicy",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryFlushPolicyTest::RunTest(const FString & Parameters)
+{
+	// the linger is long enough that a threshold flush cannot be mistaken for it
+	const double LingerSeconds = 2.0;
+
+	const TSharedRef<FElasticTelemetryNullTransport, ESPMode::ThreadSafe> Sink =
+	    MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr Writer = createElasticTelemetryWriterBuilder()
+	                                   ->addConfigPair("IndexName", "uelog")
+	                                   .addConfigPair("EndpointURL", "http://unused.invalid:9200")
+	                                   .addConfigPair("FlushLingerMilliseconds", "2000")
+	                                   .addConfigPair("FlushMaxDocuments", "10")
+	                                   .addConfigPair("FlushMaxBytes", "4096")
+	                                   .build();
+	AsElasticTelemetryWriter(Writer)->SetTransport(Sink);
+	const auto Sent = [&Sink](const uint64 Requests, const uint64 Documents, const double TimeoutSeconds) {
+		const auto Done = [&Sink, Requests, Documents]() {
+			return Sink->GetRequests() == Requests && Sink->GetDocuments() == Documents;
+		};
+		return FElasticTelemetryStandInServer::PumpHttpUntil(Done, TimeoutSeconds);
+	};
+
+	// the tenth document sends the batch, well before the linger is up
+	for (uint32 i = 0; i < 9; ++i)
+	{
+		Writer->write(MakeDocument(i));
+	}
+	FPlatformProcess::Sleep(0.2f);
+	TestEqual(TEXT("Nine documents wait"), Sink->GetRequests(), 0ull);
+	Writer->write(MakeDocument(9));
+	TestTrue(TEXT("FlushMaxDocuments sends ten documents in one request"), Sent(1, 10, LingerSeconds / 2));
+
+	// two large documents reach FlushMaxBytes first
+	const std::string Large = "{\"log\":{\"message\":\"" + std::string(3000, 'x') + "\"}}";
+	Writer->write(Large);
+	FPlatformProcess::Sleep(0.2f);
+	TestEqual(TEXT("One large document waits"), Sink->GetRequests(), 1ull);
+	Writer->write(Large);
+	TestTrue(TEXT("FlushMaxBytes sends both in one request"), Sent(2, 12, LingerSeconds / 2));
+
+	// below both thresholds only the linger sends
+	const double Written = FPlatformTime::Seconds();
+	Writer->write(MakeDocument(10));
+	FPlatformProcess::Sleep(static_cast<float>(LingerSeconds / 2));
+	TestEqual(TEXT("A single document waits for the linger"), Sink->GetRequests(), 2ull);
+	TestTrue(TEXT("The linger sends it"), Sent(3, 13, LingerSeconds * 2));
+	TestTrue(TEXT("Not before FlushLingerMilliseconds"), FPlatformTime::Seconds() - Written >= LingerSeconds - 0.05);
+	TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryStandInServerTest, "ElasticTelemetry.Transport.StandInServer",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryStandInServerTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryStandInServer Server;
+	if (!TestTrue(TEXT("Stand-in server starts"), Server.Start()))
+		return false;
+
+	// _bulk, gzip encoded
+	{
+		Herald::ILogWriterPtr Writer = MakeWriter(Server.GetURL(), true);
+		Writer->addConfigPair("CompressionLevel", "1");
+
+		const uint32 Count = 200;
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Writer->write(MakeDocument(i));
+		}
+		TestTrue(TEXT("Every _bulk document is indexed"),
+		    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Server.GetDocumentCount() == Count; }));
+		TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+		TestTrue(TEXT("Documents went through _bulk"), Server.GetBulkRequests() > 0);
+
+		// the writer's worker sends in queue order, requests may complete in any order
+		std::vector<std::string> Documents = Server.GetDocuments();
+		std::vector<std::string> Expected;
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Expected.push_back(MakeDocument(i));
+		}
+		std::sort(Documents.begin(), Documents.end());
+		std::sort(Expected.begin(), Expected.end());
+		TestTrue(TEXT("Documents arrive intact"), Documents == Expected);
+	}
+
+	// _doc, one request per document
+	{
+		const uint64          Before = Server.GetDocumentCount();
+		Herald::ILogWriterPtr Writer = MakeWriter(Server.GetURL(), false);
+		for (uint32 i = 0; i < 5; ++i)
+		{
+			Writer->write(MakeDocument(i));
+		}
+		TestTrue(TEXT("Every _doc document is indexed"),
+		    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Server.GetDocumentCount() == Before + 5; }));
+		TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryFailoverTest, "ElasticTelemetry.Transport.Failover",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryFailoverTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryStandInServer Failing;
+	FElasticTelemetryStandInServer Healthy;
+	if (!TestTrue(TEXT("Stand-in servers start"), Failing.Start() && Healthy.Start()))
+		return false;
+	Failing.SetFailureCode(503);
+
+	// a long backoff keeps the failing node out of rotation for the rest of the test
+	Herald::ILogWriterPtr Writer = MakeWriter(Failing.GetURL() + TEXT(",") + Healthy.GetURL(), true);
+	Writer->addConfigPair("RetryInitialBackoffMilliseconds", "60000");
+	Writer->addConfigPair("BulkMaxDocuments", "10");
+
+	const uint32 Count = 300;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		Writer->write(MakeDocument(i));
+	}
+	TestTrue(TEXT("Every document ends up on the healthy node"),
+	    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Healthy.GetDocumentCount() == Count; }));
+	TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestTrue(TEXT("The failing node was tried"), Failing.GetRequests() > 0);
+	TestEqual(TEXT("The failing node indexed nothing"), Failing.GetDocumentCount(), 0ull);
+	TestTrue(TEXT("Its requests failed over"), Stats.FailedOverRequests > 0);
+	TestFalse(TEXT("One node down does not open the circuit"), Stats.bCircuitOpen);
+	TestEqual(TEXT("One of two nodes available"), Stats.AvailableEndpoints, 1);
+
+	// a node that stops listening fails over the same way
+	Healthy.Stop();
+	FElasticTelemetryStandInServer Replacement;
+	if (!TestTrue(TEXT("Replacement server starts"), Replacement.Start()))
+		return false;
+
+	Herald::ILogWriterPtr Refused = MakeWriter(Healthy.GetURL() + TEXT(",") + Replacement.GetURL(), true);
+	Refused->addConfigPair("RetryInitialBackoffMilliseconds", "60000");
+	for (uint32 i = 0; i < 50; ++i)
+	{
+		Refused->write(MakeDocument(i));
+	}
+	TestTrue(TEXT("Refused connections fail over"),
+	    FElasticTelemetryStandInServer::PumpHttpUntil([&]() { return Replacement.GetDocumentCount() == 50u; }));
+	TestTrue(TEXT("Writer drains"), WaitUntilIdle(Refused));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryShardedWriterTest, "ElasticTelemetry.Transport.ShardedWriter",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryShardedWriterTest::RunTest(const FString & Parameters)
+{
+	const TSharedRef<FRecordingTransport, ESPMode::ThreadSafe> Sink =
+	    MakeShared<FRecordingTransport, ESPMode::ThreadSafe>();
+
+	Herald::ILogWriterPtr Writer = MakeWriter(TEXT("http://unused.invalid:9200"), true);
+	Writer->addConfigPair("WriterShards", "4");
+	Writer->addConfigPair("BulkMaxDocuments", "50");
+	AsElasticTelemetryWriter(Writer)->SetTransport(Sink);
+	TestEqual(TEXT("Four shards"), AsElasticTelemetryWriter(Writer)->GetStats().WriterShards, 4u);
+
+	static constexpr uint32     Producers = 8;
+	static constexpr uint32     Count     = 2000;
+	TArray<TUniquePtr<FThread>> Threads;
+	for (uint32 Producer = 0; Producer < Producers; ++Producer)
+	{
+		Threads.Add(MakeUnique<FThread>(TEXT("ElasticTelemetryShardedProducer"), [&Writer, Producer]() {
+			for (uint32 i = 0; i < Count; ++i)
+			{
+				Writer->write("{\"producer\":" + std::to_string(Producer) + ",\"line\":" + std::to_string(i) + "}");
+			}
+		}));
+	}
+	for (TUniquePtr<FThread> & Thread : Threads)
+	{
+		Thread->Join();
+	}
+	TestTrue(TEXT("Writer drains"), WaitUntilIdle(Writer));
+
+	// lines of different threads interleave freely, each thread's own lines keep their order
+	const std::vector<std::string> Documents = Sink->GetDocuments();
+	TestEqual(TEXT("Every document is sent"), static_cast<uint32>(Documents.size()), Producers * Count);
+
+	TArray<uint32> NextLine;
+	NextLine.SetNumZeroed(Producers);
+	bool bInOrder = true;
+	for (const std::string & Document : Documents)
+	{
+		static constexpr char ProducerKey[] = "{\"producer\":";
+		static constexpr char LineKey[]     = "\"line\":";
+
+		const size_t LineAt   = Document.find(LineKey);
+		const int32  Producer = FCStringAnsi::Atoi(Document.c_str() + sizeof(ProducerKey) - 1);
+		if (LineAt == std::string::npos || Producer < 0 || Producer >= static_cast<int32>(Producers))
+		{
+			bInOrder = false;
+			break;
+		}
+		const uint32 Line = static_cast<uint32>(FCStringAnsi::Atoi(Document.c_str() + LineAt + sizeof(LineKey) - 1));
+		bInOrder &= Line == NextLine[Producer]++;
+	}
+	TestTrue(TEXT("Lines from each thread are sent in the order they were written"), bInOrder);
+
+	const FElasticTelemetryWriterStats Stats = AsElasticTelemetryWriter(Writer)->GetStats();
+	TestEqual(TEXT("Nothing dropped"), Stats.GetTotalDropped(), 0ull);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryShutdownDrainTest, "ElasticTelemetry.Transport.ShutdownDrain",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryShutdownDrainTest::RunTest(const FString & Parameters)
+{
+	FElasticTelemetryStandInServer Server;
+	if (!TestTrue(TEXT("Stand-in server starts"), Server.Start()))
+		return false;
+
+	const uint32 Count = 100;
+
+	// a long linger would hold the lines back, the drain sends them at once
+	{
+		Herald::ILogWriterPtr Writer = MakeWriter(Server.GetURL(), true);
+		Writer->addConfigPair("FlushLingerMilliseconds", "60000");
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Writer->write(MakeDocument(i));
+		}
+
+		const FElasticTelemetryDrainReport Report =
+		    AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 10.0);
+		TestFalse(TEXT("The drain finishes before the deadline"), Report.bTimedOut);
+		TestEqual(TEXT("Every line is flushed"), Report.FlushedDocuments, static_cast<uint64>(Count));
+		TestEqual(TEXT("Nothing is spilled or lost"), Report.SpilledDocuments + Report.LostDocuments, 0ull);
+		TestEqual(TEXT("Every line is indexed"), Server.GetDocumentCount(), static_cast<uint64>(Count));
+
+		Writer->write(MakeDocument(Count));
+		TestEqual(TEXT("A drained writer sends nothing more"),
+		    AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 1.0).GetTotal(), 0ull);
+	}
+
+	// a cluster that answers 503 leaves everything in the spool, for the next launch to send
+	{
+		const FString Directory =
+		    FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / TEXT("Drain");
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+		Server.SetFailureCode(503);
+		Herald::ILogWriterPtr Writer = MakeWriter(Server.GetURL(), true);
+		Writer->addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*Directory));
+		Writer->addConfigPair("RetryInitialBackoffMilliseconds", "60000");
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Writer->write(MakeDocument(i));
+		}
+
+		const FElasticTelemetryDrainReport Report =
+		    AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 10.0);
+		TestEqual(TEXT("Nothing is flushed"), Report.FlushedDocuments, 0ull);
+		TestEqual(TEXT("Every line is spilled"), Report.SpilledDocuments, static_cast<uint64>(Count));
+		TestEqual(TEXT("Nothing is lost"), Report.LostDocuments, 0ull);
+		Writer.reset();
+
+		// an action line, then the document
+		FElasticTelemetrySpool          Spool;
+		FElasticTelemetrySpool::FRecord Record;
+		uint32                          Lines = 0;
+		TestTrue(TEXT("Spool reopens"), Spool.Open(Directory, 1024 * 1024));
+		while (Spool.ReadNext(Record))
+		{
+			Lines += static_cast<uint32>(Algo::Count(Record.Payload, static_cast<uint8>('\n')));
+		}
+		TestEqual(TEXT("The spool holds every line"), Lines, Count * 2);
+		Spool.Close();
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	}
+
+	// without a spool, what could not be sent by the deadline is lost
+	{
+		Herald::ILogWriterPtr Writer = MakeWriter(TEXT("http://unused.invalid:9200"), true);
+		AsElasticTelemetryWriter(Writer)->SetTransport(
+		    MakeShared<FElasticTelemetryNullTransport, ESPMode::ThreadSafe>(503));
+		Writer->addConfigPair("RetryInitialBackoffMilliseconds", "60000");
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			Writer->write(MakeDocument(i));
+		}
+
+		const FElasticTelemetryDrainReport Report =
+		    AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 0.5);
+		TestTrue(TEXT("The deadline passes with lines held for retry"), Report.bTimedOut);
+		TestEqual(TEXT("Every line is lost"), Report.LostDocuments, static_cast<uint64>(Count));
+		TestEqual(TEXT("Every line is accounted for"), Report.GetTotal(), static_cast<uint64>(Count));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetrySpoolReplayAtStartupTest,
+    "ElasticTelemetry.Transport.SpoolReplayAtStartup",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetrySpoolReplayAtStartupTest::RunTest(const FString & Parameters)
+{
+	const FString Directory =
+	    FPaths::ProjectSavedDir() / TEXT("ElasticTelemetryTests") / TEXT("Spool") / TEXT("ReplayAtStartup");
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	// what a crash, or a drain against a cluster that was down, leaves for the next launch
+	const std::string Body = "{\"index\":{}}\n" + MakeDocument(0) + "\n{\"index\":{}}\n" + MakeDocument(1) + "\n";
+	TestTrue(TEXT("A segment is left behind"),
+	    FElasticTelemetrySpool::WriteSegment(*FElasticTelemetrySpool::GetCrashSegmentPath(Directory),
+	        FElasticTelemetrySpool::Bulk, reinterpret_cast<const uint8 *>(Body.data()), Body.size(), 2));
+
+	// nothing is ever logged to this writer, it replays the spool as soon as it has one
+	const TSharedRef<FRecordingTransport, ESPMode::ThreadSafe> Transport =
+	    MakeShared<FRecordingTransport, ESPMode::ThreadSafe>();
+	Herald::ILogWriterPtr Writer = MakeWriter(TEXT("http://unused.invalid:9200"), true);
+	AsElasticTelemetryWriter(Writer)->SetTransport(Transport);
+	Writer->addConfigPair("SpoolDirectory", TCHAR_TO_UTF8(*Directory));
+
+	const auto Replayed = [&Transport]() { return Transport->GetDocuments().size() == 2; };
+	TestTrue(TEXT("The spooled documents are sent without a line being logged"),
+	    FElasticTelemetryStandInServer::PumpHttpUntil(Replayed));
+	TestTrue(TEXT("They are sent as they were spooled"),
+	    Transport->GetDocuments() == std::vector<std::string>{MakeDocument(0), MakeDocument(1)});
+	TestTrue(TEXT("The spool is emptied"), FElasticTelemetryStandInServer::PumpHttpUntil([&Writer]() {
+		return AsElasticTelemetryWriter(Writer)->GetStats().SpoolBytes == 0;
+	}));
+	WaitUntilIdle(Writer);
+	Writer.reset();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElasticTelemetryPriorityLaneTest, "ElasticTelemetry.Transport.PriorityLane",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FElasticTelemetryPriorityLaneTest::RunTest(const FString & Parameters)
+{
+	const TSharedRef<FRecordingTransport, ESPMode::ThreadSafe> Sink =
+	    MakeShared<FRecordingTransport, ESPMode::ThreadSafe>();
+
+	// batched lines wait out the linger, errors do not
+	Herald::ILogWriterPtr Writer = MakeWriter(TEXT("http://unused.invalid:9200"), true);
+	Writer->addConfigPair("FlushLingerMilliseconds", "60000");
+	AsElasticTelemetryWriter(Writer)->SetTransport(Sink);
+	{
+		FElasticTelemetryLogLevelScope Verbose(Herald::LogLevels::Trace);
+		Writer->write(MakeDocument(0));
+	}
+	{
+		FElasticTelemetryLogLevelScope Error(Herald::LogLevels::Error);
+		Writer->write(MakeDocument(1));
+	}
+	TestTrue(TEXT("The error is sent straight away"),
+	    FElasticTelemetryStandInServer::PumpHttpUntil([&Sink]() { return Sink->GetDocuments().size() == 1; }, 5.0));
+	TestTrue(TEXT("Only the error is sent"), Sink->GetDocuments() == std::vector<std::string>{MakeDocument(1)});
+	TestEqual(TEXT("The verbose line still lingers"), AsElasticTelemetryWriter(Writer)->GetStats().QueuedMessages, 1u);
+
+	// without the lane, errors are batched like everything else
+	Writer->addConfigPair("PriorityLane", "false");
+	{
+		FElasticTelemetryLogLevelScope Fatal(Herald::LogLevels::Fatal);
+		Writer->write(MakeDocument(2));
+	}
+	FPlatformProcess::Sleep(0.1f);
+	TestEqual(TEXT("The error lingers with the verbose line"), Sink->GetDocuments().size(), static_cast<size_t>(1));
+
+	const FElasticTelemetryDrainReport Report = AsElasticTelemetryWriter(Writer)->Drain(FPlatformTime::Seconds() + 5.0);
+	TestEqual(TEXT("The drain sends both"), Report.FlushedDocuments, 2ull);
+	return true;
+}